@@ -0,0 +1,1185 @@
+#include "Archive.h"
+#include <algorithm>
+#include <cstring>
+#include "Crc32c.h"
+#include "Name.h"
+#include "Object.h"
+#include "PropertySerialization.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        // Archive implementation - primitives are written in native byte order
+        Archive& Archive::operator<<(bool& value)
+        {
+            uint8_t byte = value ? 1 : 0;
+            Serialize(&byte, sizeof(byte));
+            value = byte != 0;
+            return *this;
+        }
+
+        Archive& Archive::operator<<(int8_t& value)
+        {
+            Serialize(&value, sizeof(value));
+            return *this;
+        }
+
+        Archive& Archive::operator<<(uint8_t& value)
+        {
+            Serialize(&value, sizeof(value));
+            return *this;
+        }
+
+        Archive& Archive::operator<<(int16_t& value)
+        {
+            Serialize(&value, sizeof(value));
+            return *this;
+        }
+
+        Archive& Archive::operator<<(uint16_t& value)
+        {
+            Serialize(&value, sizeof(value));
+            return *this;
+        }
+
+        Archive& Archive::operator<<(int32_t& value)
+        {
+            if (IsCompact())
+            {
+                uint64_t encoded = Varint::ToUnsigned(value);
+                SerializeVarint(encoded, Varint::MaxBytes32);
+                value = Varint::FromUnsigned<int32_t>(encoded);
+                return *this;
+            }
+            Serialize(&value, sizeof(value));
+            return *this;
+        }
+
+        Archive& Archive::operator<<(uint32_t& value)
+        {
+            if (IsCompact())
+            {
+                uint64_t encoded = Varint::ToUnsigned(value);
+                SerializeVarint(encoded, Varint::MaxBytes32);
+                value = Varint::FromUnsigned<uint32_t>(encoded);
+                return *this;
+            }
+            Serialize(&value, sizeof(value));
+            return *this;
+        }
+
+        Archive& Archive::operator<<(int64_t& value)
+        {
+            if (IsCompact())
+            {
+                uint64_t encoded = Varint::ToUnsigned(value);
+                SerializeVarint(encoded, Varint::MaxBytes64);
+                value = Varint::FromUnsigned<int64_t>(encoded);
+                return *this;
+            }
+            Serialize(&value, sizeof(value));
+            return *this;
+        }
+
+        Archive& Archive::operator<<(uint64_t& value)
+        {
+            if (IsCompact())
+            {
+                uint64_t encoded = Varint::ToUnsigned(value);
+                SerializeVarint(encoded, Varint::MaxBytes64);
+                value = Varint::FromUnsigned<uint64_t>(encoded);
+                return *this;
+            }
+            Serialize(&value, sizeof(value));
+            return *this;
+        }
+
+        Archive& Archive::operator<<(float& value)
+        {
+            Serialize(&value, sizeof(value));
+            return *this;
+        }
+
+        Archive& Archive::operator<<(double& value)
+        {
+            Serialize(&value, sizeof(value));
+            return *this;
+        }
+
+        Archive& Archive::operator<<(std::string& value)
+        {
+            if (IsStringTable())
+            {
+                const std::string* entry = SerializeTableString(value);
+                if (IsLoading())
+                {
+                    if (entry)
+                        value = *entry;
+                    else
+                        value.clear();
+                }
+                return *this;
+            }
+
+            SerializeInlineString(value);
+            return *this;
+        }
+
+        Archive& Archive::operator<<(Name& value)
+        {
+            if (IsText())
+            {
+                std::string text = value.ToString();
+                *this << text;
+                if (IsLoading())
+                    value = Name(text);
+                return *this;
+            }
+
+            if (IsStringTable())
+            {
+                // Entries are interned already, loading allocates nothing
+                const std::string* entry = SerializeTableString(value.ToString());
+                if (IsLoading())
+                    value = Name::FromInterned(entry);
+                return *this;
+            }
+
+            std::string text = value.ToString();
+            SerializeInlineString(text);
+            if (IsLoading())
+                value = Name(text);
+            return *this;
+        }
+
+        void Archive::SerializeInlineString(std::string& value)
+        {
+            uint32_t length = static_cast<uint32_t>(value.size());
+            *this << length;
+
+            if (IsLoading())
+            {
+                if (length > static_cast<uint64_t>(TotalSize() - Tell()))
+                {
+                    SetError();
+                    value.clear();
+                    return;
+                }
+                value.resize(length);
+            }
+
+            if (length)
+            {
+                Serialize(&value[0], length);
+            }
+        }
+
+        const std::string* Archive::SerializeTableString(std::string_view value)
+        {
+            if (!SharedStrings && !OwnStrings)
+                OwnStrings = std::make_shared<ArchiveStringTable>();
+            ArchiveStringTable& table = SharedStrings ? *SharedStrings : *OwnStrings;
+
+            if (IsSaving())
+            {
+                size_t numBefore = table.GetNum();
+                uint64_t index = table.Add(value);
+                uint64_t encoded = SharedStrings || index < numBefore ? index + 1 : 0;
+                SerializeVarint(encoded, Varint::MaxBytes32);
+                if (encoded == 0)
+                {
+                    std::string text(value);
+                    SerializeInlineString(text);
+                }
+                return nullptr;
+            }
+
+            uint64_t encoded = 0;
+            SerializeVarint(encoded, Varint::MaxBytes32);
+            if (HasError())
+                return nullptr;
+
+            if (encoded == 0)
+            {
+                std::string text;
+                SerializeInlineString(text);
+                if (SharedStrings || HasError())
+                {
+                    SetError();
+                    return nullptr;
+                }
+                return table.Get(table.AddInterned(text));
+            }
+
+            const std::string* entry = table.Get(static_cast<uint32_t>(encoded - 1));
+            if (!entry)
+                SetError();
+            return entry;
+        }
+
+        void Archive::SerializeVarint(uint64_t& value, size_t maxBytes)
+        {
+            if (IsSaving())
+            {
+                uint8_t bytes[Varint::MaxBytes64];
+                Serialize(bytes, Varint::Encode(value, bytes));
+                return;
+            }
+
+            uint64_t result = 0;
+            for (size_t i = 0; i < maxBytes; ++i)
+            {
+                uint8_t byte = 0;
+                Serialize(&byte, 1);
+                result |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+                if (byte < 0x80)
+                {
+                    // Reject values that do not fit the destination type
+                    if (maxBytes == Varint::MaxBytes32 && result > 0xffffffffu)
+                        break;
+                    value = result;
+                    return;
+                }
+            }
+            SetError();
+            value = 0;
+        }
+
+        template<typename T>
+        void Archive::SerializeCompactArrayImpl(std::vector<T>& array)
+        {
+            uint64_t count = array.size();
+            SerializeCount(count);
+
+            if (IsLoading())
+            {
+                // Every value takes at least one byte
+                if (count > static_cast<uint64_t>(TotalSize() - Tell()))
+                {
+                    SetError();
+                    array.clear();
+                    return;
+                }
+                array.resize(static_cast<size_t>(count));
+            }
+
+            SerializeCompactBlockImpl(array.data(), array.size());
+            if (IsLoading() && HasError())
+                array.clear();
+        }
+
+        template<typename T>
+        void Archive::SerializeCompactBlockImpl(T* values, size_t count)
+        {
+            std::vector<uint8_t> encoded;
+            uint64_t encodedSize = 0;
+            if (IsSaving())
+            {
+                encoded.resize(count * Varint::MaxBytes64);
+                encodedSize = Varint::EncodeArray(values, count, encoded.data());
+            }
+            *this << encodedSize;
+
+            if (IsSaving())
+            {
+                if (encodedSize)
+                    Serialize(encoded.data(), static_cast<size_t>(encodedSize));
+                return;
+            }
+
+            if (encodedSize > static_cast<uint64_t>(TotalSize() - Tell()) || count > encodedSize)
+            {
+                SetError();
+                return;
+            }
+
+            const uint8_t* input = encodedSize ? ReadInPlace(static_cast<size_t>(encodedSize)) : nullptr;
+            if (!input && encodedSize)
+            {
+                encoded.resize(static_cast<size_t>(encodedSize));
+                Serialize(encoded.data(), encoded.size());
+                input = encoded.data();
+            }
+
+            if (count && Varint::DecodeArray(input, static_cast<size_t>(encodedSize), values, count) != encodedSize)
+                SetError();
+        }
+
+        void Archive::SerializeCompactArray(std::vector<int32_t>& array) { SerializeCompactArrayImpl(array); }
+        void Archive::SerializeCompactArray(std::vector<uint32_t>& array) { SerializeCompactArrayImpl(array); }
+        void Archive::SerializeCompactArray(std::vector<int64_t>& array) { SerializeCompactArrayImpl(array); }
+        void Archive::SerializeCompactArray(std::vector<uint64_t>& array) { SerializeCompactArrayImpl(array); }
+
+        void Archive::SerializeCompactBlock(int32_t* values, size_t count) { SerializeCompactBlockImpl(values, count); }
+        void Archive::SerializeCompactBlock(uint32_t* values, size_t count) { SerializeCompactBlockImpl(values, count); }
+        void Archive::SerializeCompactBlock(int64_t* values, size_t count) { SerializeCompactBlockImpl(values, count); }
+        void Archive::SerializeCompactBlock(uint64_t* values, size_t count) { SerializeCompactBlockImpl(values, count); }
+
+        void Archive::SerializeView(std::string_view& value, std::string& storage)
+        {
+            if (IsText())
+            {
+                if (IsSaving())
+                    storage.assign(value);
+                *this << storage;
+                value = storage;
+                return;
+            }
+
+            // Table entries outlive the archive, views point straight at them
+            if (IsStringTable())
+            {
+                const std::string* entry = SerializeTableString(value);
+                if (IsLoading())
+                    value = entry ? std::string_view(*entry) : std::string_view();
+                return;
+            }
+
+            uint32_t length = static_cast<uint32_t>(value.size());
+            *this << length;
+
+            if (IsLoading())
+            {
+                if (length > static_cast<uint64_t>(TotalSize() - Tell()))
+                {
+                    SetError();
+                    value = std::string_view();
+                    return;
+                }
+
+                if (const uint8_t* inPlace = length ? ReadInPlace(length) : nullptr)
+                {
+                    value = std::string_view(reinterpret_cast<const char*>(inPlace), length);
+                }
+                else
+                {
+                    storage.resize(length);
+                    if (length)
+                        Serialize(&storage[0], length);
+                    value = storage;
+                }
+            }
+            else if (length)
+            {
+                Serialize(const_cast<char*>(value.data()), length);
+            }
+        }
+
+        void Archive::SerializeObject(Object*& object)
+        {
+            std::string name = object ? object->GetFullName() : std::string();
+            *this << name;
+
+            if (IsLoading())
+            {
+                object = name.empty() ? nullptr : ObjectRegistry::Get().FindObject(name);
+            }
+        }
+
+        void Archive::SerializeObjectPtr(ObjectPtr<Object>& objectPtr)
+        {
+            Object* object = objectPtr.Get();
+            SerializeObject(object);
+            if (IsLoading())
+            {
+                objectPtr = object;
+            }
+        }
+
+        void Archive::WriteObjectReference(Archive& target, Object* object)
+        {
+            std::string name = object ? object->GetFullName() : std::string();
+            target << name;
+        }
+
+        // ArchiveStringTable implementation
+
+        uint32_t ArchiveStringTable::Add(std::string_view value)
+        {
+            auto found = Indices.find(value);
+            if (found != Indices.end())
+                return found->second;
+
+            const std::string& entry = Owned.emplace_back(value);
+            uint32_t index = static_cast<uint32_t>(Entries.size());
+            Entries.push_back(&entry);
+            Indices.emplace(entry, index);
+            return index;
+        }
+
+        uint32_t ArchiveStringTable::AddInterned(std::string_view value)
+        {
+            const std::string& entry = NameTable::Get().Intern(value);
+            uint32_t index = static_cast<uint32_t>(Entries.size());
+            Entries.push_back(&entry);
+            Indices.emplace(entry, index);
+            return index;
+        }
+
+        void ArchiveStringTable::Serialize(Archive& archive)
+        {
+            bool wasStringTable = archive.IsStringTable();
+            archive.RemoveFlags(ArchiveFlags::StringTable);
+
+            uint64_t count = Entries.size();
+            archive.SerializeCount(count);
+            if (archive.IsLoading())
+            {
+                // Every string takes at least its length prefix, a single varint byte in compact archives
+                uint64_t minimumEntrySize = archive.IsCompact() ? 1 : sizeof(uint32_t);
+                if (count > static_cast<uint64_t>(archive.TotalSize() - archive.Tell()) / minimumEntrySize)
+                {
+                    archive.SetError();
+                    count = 0;
+                }
+
+                std::string value;
+                for (uint64_t i = 0; i < count && !archive.HasError(); ++i)
+                {
+                    archive << value;
+                    if (!archive.HasError())
+                        AddInterned(value);
+                }
+            }
+            else
+            {
+                for (const std::string* entry : Entries)
+                {
+                    std::string value = *entry;
+                    archive << value;
+                }
+            }
+
+            if (wasStringTable)
+                archive.AddFlags(ArchiveFlags::StringTable);
+        }
+
+        const PropertySnapshot* Archive::FindDeltaBaseline(const Object* object) const
+        {
+            if (!DeltaBaselines)
+                return nullptr;
+
+            auto found = DeltaBaselines->find(object);
+            return found != DeltaBaselines->end() ? &found->second : nullptr;
+        }
+
+        // ArchiveChecksums implementation
+        void ArchiveChecksums::Append(const uint8_t* data, size_t size)
+        {
+            while (size)
+            {
+                size_t inBlock = static_cast<size_t>(Size % BlockSize);
+                size_t chunk = std::min(size, BlockSize - inBlock);
+                Partial = Crc32c::Update(inBlock ? Partial : 0, data, chunk);
+                Size += chunk;
+                data += chunk;
+                size -= chunk;
+
+                if (Size % BlockSize == 0)
+                {
+                    Checksums.push_back(Partial);
+                    Partial = 0;
+                }
+            }
+        }
+
+        uint64_t ArchiveChecksums::Rewind(uint64_t offset)
+        {
+            if (offset >= Size)
+                return Size;
+
+            Checksums.resize(static_cast<size_t>(offset / BlockSize));
+            Size = Checksums.size() * static_cast<uint64_t>(BlockSize);
+            Partial = 0;
+            return Size;
+        }
+
+        std::vector<uint8_t> ArchiveChecksums::BuildTrailer() const
+        {
+            std::vector<uint32_t> table = Checksums;
+            if (Size % BlockSize)
+                table.push_back(Partial);
+
+            std::vector<uint8_t> trailer(table.size() * sizeof(uint32_t) + FooterSize);
+            uint8_t* out = trailer.data();
+            if (!table.empty())
+                std::memcpy(out, table.data(), table.size() * sizeof(uint32_t));
+            out += table.size() * sizeof(uint32_t);
+
+            uint32_t blockSize = BlockSize;
+            uint32_t magic = Magic;
+            std::memcpy(out, &Size, sizeof(Size));
+            std::memcpy(out + sizeof(Size), &blockSize, sizeof(blockSize));
+            std::memcpy(out + sizeof(Size) + sizeof(blockSize), &magic, sizeof(magic));
+            return trailer;
+        }
+
+        bool ArchiveChecksums::ReadFooter(const uint8_t* footer, uint64_t fileSize, uint64_t& dataSize)
+        {
+            uint32_t blockSize = 0;
+            uint32_t magic = 0;
+            std::memcpy(&dataSize, footer, sizeof(dataSize));
+            std::memcpy(&blockSize, footer + sizeof(dataSize), sizeof(blockSize));
+            std::memcpy(&magic, footer + sizeof(dataSize) + sizeof(blockSize), sizeof(magic));
+
+            return magic == Magic && blockSize == BlockSize && fileSize >= FooterSize && dataSize <= fileSize - FooterSize
+                && GetTableSize(dataSize) == fileSize - FooterSize - dataSize;
+        }
+
+        uint64_t ArchiveChecksums::GetTableSize(uint64_t dataSize)
+        {
+            return (dataSize + BlockSize - 1) / BlockSize * sizeof(uint32_t);
+        }
+
+        void ArchiveChecksums::SetTable(const uint8_t* table, uint64_t dataSize)
+        {
+            Size = dataSize;
+            Checksums.resize(static_cast<size_t>(GetTableSize(dataSize) / sizeof(uint32_t)));
+            if (!Checksums.empty())
+                std::memcpy(Checksums.data(), table, Checksums.size() * sizeof(uint32_t));
+            Verified.assign(Checksums.size(), false);
+        }
+
+        bool ArchiveChecksums::VerifyRange(const uint8_t* data, uint64_t offset, uint64_t size)
+        {
+            if (size == 0)
+                return true;
+
+            for (size_t block = static_cast<size_t>(offset / BlockSize); block <= (offset + size - 1) / BlockSize; ++block)
+            {
+                if (Verified[block])
+                    continue;
+
+                uint64_t begin = block * static_cast<uint64_t>(BlockSize);
+                size_t length = static_cast<size_t>(std::min<uint64_t>(BlockSize, Size - begin));
+                if (Crc32c::Compute(data + begin, length) != Checksums[block])
+                    return false;
+                Verified[block] = true;
+            }
+            return true;
+        }
+
+        bool ArchiveChecksums::VerifyBlocks(const uint8_t* buffer, uint64_t offset, size_t size) const
+        {
+            for (size_t checked = 0; checked < size;)
+            {
+                size_t block = static_cast<size_t>((offset + checked) / BlockSize);
+                uint64_t begin = block * static_cast<uint64_t>(BlockSize);
+                size_t length = block < Checksums.size() ? static_cast<size_t>(std::min<uint64_t>(BlockSize, Size - begin)) : 0;
+                if (length == 0 || length > size - checked || Crc32c::Compute(buffer + checked, length) != Checksums[block])
+                    return false;
+                checked += length;
+            }
+            return true;
+        }
+
+        // CountingArchive implementation
+        CountingArchive::CountingArchive(ArchiveFlags flags)
+            : Archive(flags | ArchiveFlags::Saving | ArchiveFlags::Binary)
+        {
+        }
+
+        void CountingArchive::Seek(int64_t position)
+        {
+            Position = position < 0 ? 0 : position;
+        }
+
+        void CountingArchive::Serialize(void*, size_t length)
+        {
+            Position += static_cast<int64_t>(length);
+            Size = std::max(Size, Position);
+        }
+
+        size_t CountingArchive::Measure(Object* object, ArchiveFlags flags)
+        {
+            if (!object)
+                return 0;
+
+            CountingArchive counter(flags);
+            object->Serialize(counter);
+            size_t size = static_cast<size_t>(counter.TotalSize());
+            if (Class* objectClass = object->GetClass())
+                objectClass->RecordSerialSize(size);
+            return size;
+        }
+
+        size_t CountingArchive::Estimate(Object* object, ArchiveFlags flags)
+        {
+            size_t estimate = object && object->GetClass() ? object->GetClass()->GetEstimatedSerialSize() : 0;
+            return estimate ? estimate : Measure(object, flags);
+        }
+
+        // ArchiveBuffer implementation
+        ArchiveBuffer::ArchiveBuffer(Archive& target)
+            : MemoryArchive(false)
+            , Target(target)
+        {
+            Flags = target.GetFlags();
+            if (target.IsStringTable() && !target.SharedStrings && !target.OwnStrings)
+                target.OwnStrings = std::make_shared<ArchiveStringTable>();
+            SharedStrings = target.SharedStrings;
+            OwnStrings = target.OwnStrings;
+        }
+
+        void ArchiveBuffer::SerializeObject(Object*& object)
+        {
+            Target.WriteObjectReference(*this, object);
+        }
+
+        void ArchiveBuffer::WriteObjectReference(Archive& target, Object* object)
+        {
+            Target.WriteObjectReference(target, object);
+        }
+
+        // MemoryArchive implementation
+        MemoryArchive::MemoryArchive(bool loading)
+            : Archive((loading ? ArchiveFlags::Loading : ArchiveFlags::Saving) | ArchiveFlags::Binary | ArchiveFlags::Volatile)
+        {
+        }
+
+        MemoryArchive::MemoryArchive(const std::vector<uint8_t>& data, bool loading)
+            : Archive((loading ? ArchiveFlags::Loading : ArchiveFlags::Saving) | ArchiveFlags::Binary | ArchiveFlags::Volatile)
+            , Data(data)
+        {
+        }
+
+        MemoryArchive::MemoryArchive(std::vector<uint8_t>&& data, bool loading)
+            : Archive((loading ? ArchiveFlags::Loading : ArchiveFlags::Saving) | ArchiveFlags::Binary | ArchiveFlags::Volatile)
+            , Data(std::move(data))
+        {
+        }
+
+        MemoryArchive::MemoryArchive(const void* data, size_t size)
+            : Archive(ArchiveFlags::Loading | ArchiveFlags::Binary | ArchiveFlags::Volatile)
+            , BorrowedData(static_cast<const uint8_t*>(data))
+            , BorrowedSize(size)
+        {
+        }
+
+        MemoryArchive::MemoryArchive(const CountingArchive& sizing)
+            : Archive(sizing.GetFlags() | ArchiveFlags::Volatile)
+        {
+            Data.reserve(static_cast<size_t>(sizing.TotalSize()));
+        }
+
+        void MemoryArchive::Seek(int64_t position)
+        {
+            Position = static_cast<size_t>(position < 0 ? 0 : position);
+        }
+
+        int64_t MemoryArchive::Tell() const
+        {
+            return static_cast<int64_t>(Position);
+        }
+
+        int64_t MemoryArchive::TotalSize() const
+        {
+            return static_cast<int64_t>(GetBufferSize());
+        }
+
+        void MemoryArchive::Serialize(void* data, size_t length)
+        {
+            if (IsLoading())
+            {
+                size_t size = GetBufferSize();
+                if (length > size || Position > size - length || (Checksums && !Checksums->VerifyRange(GetBuffer(), Position, length)))
+                {
+                    std::memset(data, 0, length);
+                    SetError();
+                    return;
+                }
+                std::memcpy(data, GetBuffer() + Position, length);
+            }
+            else
+            {
+                if (Checksums)
+                {
+                    // Drop a trailer from an earlier Flush; overwritten blocks are checksummed again
+                    Data.resize(ChecksummedSize);
+                    Checksums->Rewind(Position);
+                    ChecksummedSize = std::max(ChecksummedSize, Position + length);
+                }
+
+                const uint8_t* bytes = static_cast<const uint8_t*>(data);
+                if (Position == Data.size())
+                {
+                    Data.insert(Data.end(), bytes, bytes + length);
+                }
+                else
+                {
+                    if (Position + length > Data.size())
+                        Data.resize(Position + length);
+                    std::memcpy(Data.data() + Position, bytes, length);
+                }
+            }
+            Position += length;
+        }
+
+        const uint8_t* MemoryArchive::ReadInPlace(size_t length)
+        {
+            size_t size = GetBufferSize();
+            if (!IsLoading() || length > size || Position > size - length)
+                return nullptr;
+
+            if (Checksums && !Checksums->VerifyRange(GetBuffer(), Position, length))
+            {
+                SetError();
+                return nullptr;
+            }
+
+            const uint8_t* result = GetBuffer() + Position;
+            Position += length;
+            return result;
+        }
+
+        bool MemoryArchive::EnableChecksums()
+        {
+            if (Checksums)
+                return true;
+
+            if (IsSaving())
+            {
+                ChecksummedSize = Data.size();
+                Checksums = std::make_unique<ArchiveChecksums>();
+                Checksums->Append(Data.data(), Data.size());
+                return true;
+            }
+
+            const uint8_t* buffer = GetBuffer();
+            size_t size = GetBufferSize();
+            uint64_t dataSize = 0;
+            if (size < ArchiveChecksums::FooterSize || !ArchiveChecksums::ReadFooter(buffer + size - ArchiveChecksums::FooterSize, size, dataSize))
+            {
+                SetError();
+                return false;
+            }
+
+            Checksums = std::make_unique<ArchiveChecksums>();
+            Checksums->SetTable(buffer + dataSize, dataSize);
+            ChecksummedSize = static_cast<size_t>(dataSize);
+            return true;
+        }
+
+        void MemoryArchive::Flush()
+        {
+            if (!IsSaving() || !Checksums)
+                return;
+
+            Data.resize(ChecksummedSize);
+            Checksums->Append(Data.data() + Checksums->GetSize(), ChecksummedSize - static_cast<size_t>(Checksums->GetSize()));
+            std::vector<uint8_t> trailer = Checksums->BuildTrailer();
+            Data.insert(Data.end(), trailer.begin(), trailer.end());
+        }
+
+        // FileArchive implementation
+        FileArchive::FileArchive(const std::string& filename, bool loading, size_t bufferSize)
+            : Archive((loading ? ArchiveFlags::Loading : ArchiveFlags::Saving) | ArchiveFlags::Binary | ArchiveFlags::Persistent)
+            , BufferSize(std::max<size_t>(bufferSize, 4096))
+        {
+            if (loading)
+            {
+                OpenForLoad(filename, LoadMode::Buffered);
+                return;
+            }
+
+            FileHandle = PlatformFile::Open(filename, true);
+            if (FileHandle == PlatformFile::InvalidHandle)
+            {
+                SetError();
+                return;
+            }
+            Buffer.resize(BufferSize);
+        }
+
+        FileArchive::FileArchive(const std::string& filename, LoadMode mode, size_t bufferSize)
+            : Archive(ArchiveFlags::Loading | ArchiveFlags::Binary | ArchiveFlags::Persistent)
+            , BufferSize(std::max<size_t>(bufferSize, 4096))
+        {
+            OpenForLoad(filename, mode);
+        }
+
+        void FileArchive::OpenForLoad(const std::string& filename, LoadMode mode)
+        {
+            FileHandle = PlatformFile::Open(filename, false);
+            if (FileHandle == PlatformFile::InvalidHandle)
+            {
+                SetError();
+                return;
+            }
+
+            Size = PlatformFile::GetSize(FileHandle);
+            if (Size < 0)
+            {
+                Size = 0;
+                SetError();
+            }
+
+            if (mode == LoadMode::MemoryMapped && Size > 0)
+            {
+                Mapping = PlatformFile::Map(FileHandle, static_cast<size_t>(Size));
+                if (Mapping.Data)
+                {
+                    PlatformFile::Advise(Mapping, 0, Mapping.Size, PlatformFile::AccessHint::Sequential);
+                    PlatformFile::Advise(Mapping, 0, BufferSize, PlatformFile::AccessHint::WillNeed);
+                    return;
+                }
+            }
+
+            Buffer.resize(BufferSize);
+            ReadAheadBuffer.resize(BufferSize);
+        }
+
+        FileArchive::~FileArchive()
+        {
+            if (IsSaving())
+            {
+                Flush();
+            }
+            else
+            {
+                WaitForReadAhead();
+            }
+
+            PlatformFile::Unmap(Mapping);
+            PlatformFile::Close(FileHandle);
+        }
+
+        void FileArchive::Seek(int64_t position)
+        {
+            if (position < 0)
+            {
+                SetError();
+                return;
+            }
+
+            if (IsSaving() && position != BufferOffset + static_cast<int64_t>(BufferUsed))
+            {
+                // Writes carry their own file offset, so the current block can go out as is. In-flight
+                // writes may complete in any order, so let them land before overlapping ones follow.
+                SubmitWriteBlock();
+                WaitForPendingWrites();
+                BufferOffset = position;
+            }
+            else if (IsMemoryMapped() && position != Position)
+            {
+                PlatformFile::Advise(Mapping, static_cast<size_t>(position), BufferSize, PlatformFile::AccessHint::WillNeed);
+            }
+            Position = position;
+        }
+
+        int64_t FileArchive::Tell() const
+        {
+            return Position;
+        }
+
+        int64_t FileArchive::TotalSize() const
+        {
+            return Size;
+        }
+
+        void FileArchive::Serialize(void* data, size_t length)
+        {
+            if (!IsOpen())
+            {
+                if (IsLoading())
+                    std::memset(data, 0, length);
+                SetError();
+                return;
+            }
+
+            if (IsMemoryMapped())
+            {
+                if (const uint8_t* source = ReadInPlace(length))
+                {
+                    std::memcpy(data, source, length);
+                }
+                else
+                {
+                    std::memset(data, 0, length);
+                    SetError();
+                }
+                return;
+            }
+
+            uint8_t* bytes = static_cast<uint8_t*>(data);
+            if (IsSaving())
+            {
+                Position += static_cast<int64_t>(length);
+                Size = std::max(Size, Position);
+                while (length)
+                {
+                    if (BufferUsed == Buffer.size())
+                        SubmitWriteBlock();
+
+                    size_t chunk = std::min(length, Buffer.size() - BufferUsed);
+                    std::memcpy(Buffer.data() + BufferUsed, bytes, chunk);
+                    BufferUsed += chunk;
+                    bytes += chunk;
+                    length -= chunk;
+                }
+                return;
+            }
+
+            while (length)
+            {
+                int64_t inBuffer = Position - BufferOffset;
+                if (inBuffer >= 0 && inBuffer < static_cast<int64_t>(BufferUsed))
+                {
+                    size_t chunk = std::min(length, BufferUsed - static_cast<size_t>(inBuffer));
+                    std::memcpy(bytes, Buffer.data() + inBuffer, chunk);
+                    Position += static_cast<int64_t>(chunk);
+                    bytes += chunk;
+                    length -= chunk;
+                    continue;
+                }
+
+                if (length >= BufferSize && !Checksums)
+                {
+                    // Large reads go straight into the destination
+                    WaitForReadAhead();
+                    int64_t read = PlatformFile::ReadAt(FileHandle, bytes, length, Position);
+                    read = std::max<int64_t>(read, 0);
+                    Position += read;
+                    if (static_cast<size_t>(read) != length)
+                    {
+                        std::memset(bytes + read, 0, length - static_cast<size_t>(read));
+                        SetError();
+                    }
+                    return;
+                }
+
+                FillBuffer(Position);
+                if (BufferUsed == 0)
+                {
+                    std::memset(bytes, 0, length);
+                    SetError();
+                    return;
+                }
+            }
+        }
+
+        const uint8_t* FileArchive::ReadInPlace(size_t length)
+        {
+            // Only mapped archives have stable bytes to hand out
+            uint64_t size = static_cast<uint64_t>(Size);
+            if (!IsMemoryMapped() || Position < 0 || length > size || static_cast<uint64_t>(Position) > size - length)
+                return nullptr;
+
+            if (Checksums && !Checksums->VerifyRange(Mapping.Data, static_cast<uint64_t>(Position), length))
+            {
+                SetError();
+                return nullptr;
+            }
+
+            const uint8_t* result = Mapping.Data + Position;
+            Position += static_cast<int64_t>(length);
+            return result;
+        }
+
+        void FileArchive::Flush()
+        {
+            if (!IsSaving() || !IsOpen())
+                return;
+
+            SubmitWriteBlock();
+            WaitForPendingWrites();
+            if (Checksums)
+                WriteChecksums();
+        }
+
+        void FileArchive::Sync()
+        {
+            if (!IsSaving() || !IsOpen())
+                return;
+
+            Flush();
+            if (!PlatformFile::Sync(FileHandle))
+                SetError();
+        }
+
+        bool FileArchive::EnableChecksums()
+        {
+            if (Checksums)
+                return true;
+
+            if (!IsOpen())
+                return false;
+
+            if (IsSaving())
+            {
+                Checksums = std::make_unique<ArchiveChecksums>();
+                return true;
+            }
+
+            // The trailer is small, so read it even when the file is mapped
+            uint8_t footer[ArchiveChecksums::FooterSize];
+            uint64_t fileSize = static_cast<uint64_t>(Size);
+            uint64_t dataSize = 0;
+            if (fileSize < sizeof(footer)
+                || PlatformFile::ReadAt(FileHandle, footer, sizeof(footer), Size - static_cast<int64_t>(sizeof(footer))) != static_cast<int64_t>(sizeof(footer))
+                || !ArchiveChecksums::ReadFooter(footer, fileSize, dataSize))
+            {
+                SetError();
+                return false;
+            }
+
+            std::vector<uint8_t> table(static_cast<size_t>(ArchiveChecksums::GetTableSize(dataSize)));
+            if (PlatformFile::ReadAt(FileHandle, table.data(), table.size(), static_cast<int64_t>(dataSize)) != static_cast<int64_t>(table.size()))
+            {
+                SetError();
+                return false;
+            }
+
+            Checksums = std::make_unique<ArchiveChecksums>();
+            Checksums->SetTable(table.data(), dataSize);
+            Size = static_cast<int64_t>(dataSize);
+
+            // Every buffer then holds whole blocks and is verified as it arrives
+            if (!IsMemoryMapped())
+            {
+                WaitForReadAhead();
+                BufferSize = (BufferSize + ArchiveChecksums::BlockSize - 1) / ArchiveChecksums::BlockSize * ArchiveChecksums::BlockSize;
+                Buffer.resize(BufferSize);
+                ReadAheadBuffer.resize(BufferSize);
+                BufferUsed = 0;
+            }
+            return true;
+        }
+
+        void FileArchive::WriteChecksums()
+        {
+            // Blocks written out of order are read back from the file
+            if (ChecksumRescanFrom >= 0)
+            {
+                int64_t offset = static_cast<int64_t>(Checksums->Rewind(static_cast<uint64_t>(ChecksumRescanFrom)));
+                ChecksumRescanFrom = -1;
+
+                std::vector<uint8_t> scratch(BufferSize);
+                while (offset < Size)
+                {
+                    size_t length = static_cast<size_t>(std::min<int64_t>(static_cast<int64_t>(scratch.size()), Size - offset));
+                    if (PlatformFile::ReadAt(FileHandle, scratch.data(), length, offset) != static_cast<int64_t>(length))
+                    {
+                        SetError();
+                        return;
+                    }
+                    Checksums->Append(scratch.data(), length);
+                    offset += static_cast<int64_t>(length);
+                }
+            }
+
+            std::vector<uint8_t> trailer = Checksums->BuildTrailer();
+            if (PlatformFile::WriteAt(FileHandle, trailer.data(), trailer.size(), Size) != static_cast<int64_t>(trailer.size()))
+                SetError();
+        }
+
+        void FileArchive::SubmitWriteBlock()
+        {
+            if (BufferUsed == 0)
+                return;
+
+            std::vector<uint8_t> block;
+            {
+                // Keep at most two blocks in flight so memory stays bounded
+                std::unique_lock<std::mutex> lock(IoMutex);
+                IoCondition.wait(lock, [this]() { return PendingWrites < 2; });
+                ++PendingWrites;
+                if (!FreeBuffers.empty())
+                {
+                    block = std::move(FreeBuffers.back());
+                    FreeBuffers.pop_back();
+                }
+            }
+            if (block.size() != BufferSize)
+                block.resize(BufferSize);
+
+            if (Checksums && ChecksumRescanFrom < 0 && static_cast<uint64_t>(BufferOffset) == Checksums->GetSize())
+            {
+                Checksums->Append(Buffer.data(), BufferUsed);
+            }
+            else if (Checksums)
+            {
+                int64_t from = std::min(BufferOffset, static_cast<int64_t>(Checksums->GetSize()));
+                ChecksumRescanFrom = ChecksumRescanFrom < 0 ? from : std::min(ChecksumRescanFrom, from);
+            }
+
+            std::swap(block, Buffer);
+            size_t used = BufferUsed;
+            int64_t offset = BufferOffset;
+            BufferOffset += static_cast<int64_t>(used);
+            BufferUsed = 0;
+
+            auto pending = std::make_shared<std::vector<uint8_t>>(std::move(block));
+            AsyncIO::Get().Write(FileHandle, pending->data(), used, offset, IoPriority::Normal, [this, pending, used](const IoResult& result)
+            {
+                std::lock_guard<std::mutex> lock(IoMutex);
+                IoFailed |= result.Status != IoStatus::Completed || result.BytesTransferred != static_cast<int64_t>(used);
+                FreeBuffers.push_back(std::move(*pending));
+                --PendingWrites;
+                IoCondition.notify_all();
+            });
+        }
+
+        void FileArchive::WaitForPendingWrites()
+        {
+            std::unique_lock<std::mutex> lock(IoMutex);
+            IoCondition.wait(lock, [this]() { return PendingWrites == 0; });
+            if (IoFailed)
+                SetError();
+        }
+
+        void FileArchive::FillBuffer(int64_t offset)
+        {
+            if (Checksums)
+                offset -= offset % ArchiveChecksums::BlockSize;
+
+            // A read-ahead for some other offset is useless after a seek
+            if (ReadAheadOffset != offset)
+                ReadAhead.Cancel();
+            IoResult readAhead = ReadAhead.Wait();
+            ReadAhead = IoHandle();
+
+            if (ReadAheadOffset == offset && readAhead.Status == IoStatus::Completed && readAhead.BytesTransferred > 0)
+            {
+                std::swap(Buffer, ReadAheadBuffer);
+                BufferUsed = static_cast<size_t>(readAhead.BytesTransferred);
+            }
+            else
+            {
+                int64_t read = PlatformFile::ReadAt(FileHandle, Buffer.data(), Buffer.size(), offset);
+                BufferUsed = static_cast<size_t>(std::max<int64_t>(read, 0));
+            }
+            // Checksummed files carry the trailer behind the data
+            BufferUsed = std::min(BufferUsed, static_cast<size_t>(std::max<int64_t>(Size - offset, 0)));
+            BufferOffset = offset;
+            ReadAheadOffset = -1;
+
+            if (Checksums && !Checksums->VerifyBlocks(Buffer.data(), static_cast<uint64_t>(offset), BufferUsed))
+            {
+                BufferUsed = 0;
+                SetError();
+                return;
+            }
+
+            int64_t next = offset + static_cast<int64_t>(BufferUsed);
+            if (BufferUsed == Buffer.size() && next < Size)
+            {
+                RequestReadAhead(next);
+            }
+        }
+
+        void FileArchive::RequestReadAhead(int64_t offset)
+        {
+            ReadAheadOffset = offset;
+            ReadAhead = AsyncIO::Get().Read(FileHandle, ReadAheadBuffer.data(), ReadAheadBuffer.size(), offset);
+        }
+
+        void FileArchive::WaitForReadAhead()
+        {
+            ReadAhead.Wait();
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
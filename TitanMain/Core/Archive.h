@@ -1,161 +1,635 @@
-#pragma once
-
-// Titan::Core::Archive - Serialization system
-// Simplified version inspired by UE FArchive
-
-#include <cstdint>
-#include <string>
-#include <vector>
-#include <memory>
-
-namespace Titan
-{
-    namespace Core
-    {
-        // Archive flags
-        enum class ArchiveFlags : uint32_t
-        {
-            None        = 0,
-            Loading     = 1 << 0,  // Archive is loading data
-            Saving      = 1 << 1,  // Archive is saving data
-            Binary      = 1 << 2,  // Binary serialization
-            Text        = 1 << 3,  // Text serialization
-            Persistent  = 1 << 4,  // Archive is persistent (file-based)
-            Volatile    = 1 << 5,  // Archive is volatile (memory-based)
-        };
-
-        inline ArchiveFlags operator|(ArchiveFlags a, ArchiveFlags b)
-        {
-            return static_cast<ArchiveFlags>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
-        }
-
-        inline ArchiveFlags operator&(ArchiveFlags a, ArchiveFlags b)
-        {
-            return static_cast<ArchiveFlags>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
-        }
-
-        // Base archive class
-        class Archive
-        {
-        public:
-            Archive(ArchiveFlags flags = ArchiveFlags::None)
-                : Flags(flags) {}
-            virtual ~Archive() = default;
-
-            // State queries
-            bool IsLoading() const { return (Flags & ArchiveFlags::Loading) != ArchiveFlags::None; }
-            bool IsSaving() const { return (Flags & ArchiveFlags::Saving) != ArchiveFlags::None; }
-            bool IsBinary() const { return (Flags & ArchiveFlags::Binary) != ArchiveFlags::None; }
-            bool IsText() const { return (Flags & ArchiveFlags::Text) != ArchiveFlags::None; }
-            bool IsPersistent() const { return (Flags & ArchiveFlags::Persistent) != ArchiveFlags::None; }
-
-            // Position control
-            virtual void Seek(int64_t position) = 0;
-            virtual int64_t Tell() const = 0;
-            virtual int64_t TotalSize() const = 0;
-
-            // Basic serialization operators
-            virtual Archive& operator<<(bool& value) = 0;
-            virtual Archive& operator<<(int8_t& value) = 0;
-            virtual Archive& operator<<(uint8_t& value) = 0;
-            virtual Archive& operator<<(int16_t& value) = 0;
-            virtual Archive& operator<<(uint16_t& value) = 0;
-            virtual Archive& operator<<(int32_t& value) = 0;
-            virtual Archive& operator<<(uint32_t& value) = 0;
-            virtual Archive& operator<<(int64_t& value) = 0;
-            virtual Archive& operator<<(uint64_t& value) = 0;
-            virtual Archive& operator<<(float& value) = 0;
-            virtual Archive& operator<<(double& value) = 0;
-            virtual Archive& operator<<(std::string& value) = 0;
-
-            // Array serialization helpers
-            template<typename T>
-            void SerializeArray(std::vector<T>& array)
-            {
-                uint32_t size = static_cast<uint32_t>(array.size());
-                *this << size;
-
-                if (IsLoading())
-                {
-                    array.resize(size);
-                }
-
-                for (auto& element : array)
-                {
-                    *this << element;
-                }
-            }
-
-            // Object serialization
-            void SerializeObject(Object*& object);
-            void SerializeObjectPtr(ObjectPtr<Object>& objectPtr);
-
-        protected:
-            ArchiveFlags Flags;
-        };
-
-        // Memory archive - for in-memory serialization
-        class MemoryArchive : public Archive
-        {
-        public:
-            MemoryArchive(bool loading = false);
-            MemoryArchive(const std::vector<uint8_t>& data, bool loading = true);
-
-            virtual void Seek(int64_t position) override;
-            virtual int64_t Tell() const override;
-            virtual int64_t TotalSize() const override;
-
-            virtual Archive& operator<<(bool& value) override;
-            virtual Archive& operator<<(int8_t& value) override;
-            virtual Archive& operator<<(uint8_t& value) override;
-            virtual Archive& operator<<(int16_t& value) override;
-            virtual Archive& operator<<(uint16_t& value) override;
-            virtual Archive& operator<<(int32_t& value) override;
-            virtual Archive& operator<<(uint32_t& value) override;
-            virtual Archive& operator<<(int64_t& value) override;
-            virtual Archive& operator<<(uint64_t& value) override;
-            virtual Archive& operator<<(float& value) override;
-            virtual Archive& operator<<(double& value) override;
-            virtual Archive& operator<<(std::string& value) override;
-
-            const std::vector<uint8_t>& GetData() const { return Data; }
-            std::vector<uint8_t>& GetData() { return Data; }
-
-        private:
-            std::vector<uint8_t> Data;
-            size_t Position = 0;
-        };
-
-        // File archive - for file-based serialization
-        class FileArchive : public Archive
-        {
-        public:
-            FileArchive(const std::string& filename, bool loading);
-            ~FileArchive();
-
-            virtual void Seek(int64_t position) override;
-            virtual int64_t Tell() const override;
-            virtual int64_t TotalSize() const override;
-
-            virtual Archive& operator<<(bool& value) override;
-            virtual Archive& operator<<(int8_t& value) override;
-            virtual Archive& operator<<(uint8_t& value) override;
-            virtual Archive& operator<<(int16_t& value) override;
-            virtual Archive& operator<<(uint16_t& value) override;
-            virtual Archive& operator<<(int32_t& value) override;
-            virtual Archive& operator<<(uint32_t& value) override;
-            virtual Archive& operator<<(int64_t& value) override;
-            virtual Archive& operator<<(uint64_t& value) override;
-            virtual Archive& operator<<(float& value) override;
-            virtual Archive& operator<<(double& value) override;
-            virtual Archive& operator<<(std::string& value) override;
-
-            bool IsOpen() const { return FileHandle != nullptr; }
-
-        private:
-            void* FileHandle = nullptr; // Platform-specific file handle
-        };
-
-    } // namespace Core
-
+#pragma once
+
+// Titan::Core::Archive - Serialization system
+// Simplified version inspired by UE FArchive
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include "AsyncIO.h"
+#include "PlatformFile.h"
+#include "Varint.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        class Object;
+        template<typename T> class ObjectPtr;
+        class PropertySnapshot;
+        class Name;
+        class Archive;
+        class TextArchive;
+
+        // Per-object delta baselines, see PropertySerialization.h
+        using PropertySnapshotMap = std::unordered_map<const Object*, PropertySnapshot>;
+
+        // Archive flags
+        enum class ArchiveFlags : uint32_t
+        {
+            None        = 0,
+            Loading     = 1 << 0,  // Archive is loading data
+            Saving      = 1 << 1,  // Archive is saving data
+            Binary      = 1 << 2,  // Binary serialization
+            Text        = 1 << 3,  // Text serialization
+            Persistent  = 1 << 4,  // Archive is persistent (file-based)
+            Volatile    = 1 << 5,  // Archive is volatile (memory-based)
+            Compact     = 1 << 6,  // 32/64-bit integers as LEB128 varints, zigzag for signed ones.
+                                   // Not understood by StaticArchive readers.
+            Delta       = 1 << 7,  // Objects write only properties that differ from a baseline
+            StringTable = 1 << 8,  // Strings as varint indices into a deduplicated string table
+            Versioned   = 1 << 9,  // Objects write a schema hash and property tags, see PropertySerialization.h
+        };
+
+        constexpr ArchiveFlags operator|(ArchiveFlags a, ArchiveFlags b)
+        {
+            return static_cast<ArchiveFlags>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+        }
+
+        constexpr ArchiveFlags operator&(ArchiveFlags a, ArchiveFlags b)
+        {
+            return static_cast<ArchiveFlags>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
+        }
+
+        // Element types SerializeArray moves as one block of raw bytes
+        template<typename T>
+        struct IsBulkSerializable
+        {
+            static constexpr bool Value = std::is_trivially_copyable<T>::value && !std::is_same<T, bool>::value;
+        };
+
+        // Read-only view of array elements, e.g. straight into a loading archive's buffer
+        template<typename T>
+        struct ArrayView
+        {
+            const T* Data = nullptr;
+            size_t Num = 0;
+
+            const T* begin() const { return Data; }
+            const T* end() const { return Data + Num; }
+            const T& operator[](size_t index) const { return Data[index]; }
+            size_t size() const { return Num; }
+            bool empty() const { return Num == 0; }
+        };
+
+        // Deduplicated strings of ArchiveFlags::StringTable mode. Saving collects each distinct
+        // string once; loading resolves entries to NameTable, so no string is allocated per use.
+        class ArchiveStringTable
+        {
+        public:
+            // Saving: index of value, added on first use
+            uint32_t Add(std::string_view value);
+
+            // Loading: appends value interned in NameTable
+            uint32_t AddInterned(std::string_view value);
+
+            const std::string* Get(uint32_t index) const { return index < Entries.size() ? Entries[index] : nullptr; }
+            size_t GetNum() const { return Entries.size(); }
+
+            // Count and strings, written without StringTable mode
+            void Serialize(Archive& archive);
+
+        private:
+            std::vector<const std::string*> Entries;
+            std::deque<std::string> Owned;              // Saved strings, loaded ones live in NameTable
+            std::unordered_map<std::string_view, uint32_t> Indices;
+        };
+
+        // Base archive class
+        class Archive
+        {
+        public:
+            Archive(ArchiveFlags flags = ArchiveFlags::None)
+                : Flags(flags) {}
+            virtual ~Archive() = default;
+
+            // State queries
+            bool IsLoading() const { return (Flags & ArchiveFlags::Loading) != ArchiveFlags::None; }
+            bool IsSaving() const { return (Flags & ArchiveFlags::Saving) != ArchiveFlags::None; }
+            bool IsBinary() const { return (Flags & ArchiveFlags::Binary) != ArchiveFlags::None; }
+            bool IsText() const { return (Flags & ArchiveFlags::Text) != ArchiveFlags::None; }
+            bool IsPersistent() const { return (Flags & ArchiveFlags::Persistent) != ArchiveFlags::None; }
+            bool IsCompact() const { return (Flags & ArchiveFlags::Compact) != ArchiveFlags::None; }
+            bool IsDelta() const { return (Flags & ArchiveFlags::Delta) != ArchiveFlags::None; }
+            bool IsStringTable() const { return (Flags & ArchiveFlags::StringTable) != ArchiveFlags::None; }
+            bool IsVersioned() const { return (Flags & ArchiveFlags::Versioned) != ArchiveFlags::None; }
+
+            // For encoding modes such as Compact; both sides must agree before the first value
+            ArchiveFlags GetFlags() const { return Flags; }
+            void AddFlags(ArchiveFlags flags) { Flags = Flags | flags; }
+            void RemoveFlags(ArchiveFlags flags) { Flags = static_cast<ArchiveFlags>(static_cast<uint32_t>(Flags) & ~static_cast<uint32_t>(flags)); }
+
+            // Set when a read runs past the end of the data or the underlying I/O fails
+            bool HasError() const { return ErrorFlag; }
+            void SetError() { ErrorFlag = true; }
+
+            // Position control
+            virtual void Seek(int64_t position) = 0;
+            virtual int64_t Tell() const = 0;
+            virtual int64_t TotalSize() const = 0;
+
+            // Raw bytes, the primitive every other operator is built on
+            virtual void Serialize(void* data, size_t length) = 0;
+
+            // Loading archives over memory return the next length bytes in place and skip past them.
+            // nullptr if the data is not directly addressable; nothing is consumed in that case.
+            virtual const uint8_t* ReadInPlace([[maybe_unused]] size_t length) { return nullptr; }
+
+            // Structured JSON access for serializers that write names, see TextArchive.h
+            virtual TextArchive* AsTextArchive() { return nullptr; }
+
+            // Basic serialization operators
+            virtual Archive& operator<<(bool& value);
+            virtual Archive& operator<<(int8_t& value);
+            virtual Archive& operator<<(uint8_t& value);
+            virtual Archive& operator<<(int16_t& value);
+            virtual Archive& operator<<(uint16_t& value);
+            virtual Archive& operator<<(int32_t& value);
+            virtual Archive& operator<<(uint32_t& value);
+            virtual Archive& operator<<(int64_t& value);
+            virtual Archive& operator<<(uint64_t& value);
+            virtual Archive& operator<<(float& value);
+            virtual Archive& operator<<(double& value);
+            virtual Archive& operator<<(std::string& value);
+            Archive& operator<<(Name& value);
+
+            // Element counts of arrays, 64-bit on disk
+            void SerializeCount(uint64_t& count) { *this << count; }
+
+            // Array serialization helpers
+            // Trivially copyable elements are moved with a single Serialize call
+            template<typename T>
+            void SerializeArray(std::vector<T>& array)
+            {
+                if constexpr (Varint::IsCompactInteger<T>::Value)
+                {
+                    if (IsCompact())
+                    {
+                        SerializeCompactArray(array);
+                        return;
+                    }
+                }
+
+                uint64_t count = array.size();
+                SerializeCount(count);
+
+                if constexpr (IsBulkSerializable<T>::Value)
+                {
+                    if (IsLoading())
+                    {
+                        // Reject counts the remaining data cannot hold before allocating
+                        if (count > static_cast<uint64_t>(TotalSize() - Tell()) / sizeof(T))
+                        {
+                            SetError();
+                            array.clear();
+                            return;
+                        }
+                        array.resize(static_cast<size_t>(count));
+                    }
+
+                    if (count)
+                    {
+                        Serialize(array.data(), static_cast<size_t>(count) * sizeof(T));
+                    }
+                }
+                else
+                {
+                    if (IsLoading())
+                    {
+                        // Every element takes at least one byte
+                        if (count > static_cast<uint64_t>(TotalSize() - Tell()))
+                        {
+                            SetError();
+                            array.clear();
+                            return;
+                        }
+                        array.resize(static_cast<size_t>(count));
+                    }
+
+                    for (auto& element : array)
+                    {
+                        *this << element;
+                    }
+                }
+            }
+
+            // Streamed arrays for data too large to materialize, such as terrain samples or
+            // navigation data. Elements pass through one buffer of at most chunkBytes: saving calls
+            // visit to fill each chunk before writing it, loading calls it with each chunk read.
+            //     bool visit(T* elements, size_t num, uint64_t firstIndex)
+            // Returning false stops and sets the error flag. count is written on save and read on
+            // load. FileArchive overlaps the chunks with its block reads and writes. Without Compact
+            // the encoding is the same as SerializeArray; with it every chunk is its own varint run.
+            static constexpr size_t DefaultStreamChunkBytes = 64 * 1024;
+
+            template<typename T, typename Visitor>
+            void SerializeArrayStream(uint64_t& count, Visitor&& visit, size_t chunkBytes = DefaultStreamChunkBytes)
+            {
+                static_assert(!std::is_same<T, bool>::value, "Stream bool arrays as uint8_t");
+
+                SerializeCount(count);
+                if (IsLoading())
+                {
+                    bool isCompact = false;
+                    if constexpr (Varint::IsCompactInteger<T>::Value)
+                        isCompact = IsCompact();
+
+                    // Every element takes at least one byte, bulk ones exactly sizeof(T)
+                    uint64_t remaining = static_cast<uint64_t>(TotalSize() - Tell());
+                    if (HasError() || count > (IsBulkSerializable<T>::Value && !isCompact ? remaining / sizeof(T) : remaining))
+                    {
+                        SetError();
+                        count = 0;
+                        return;
+                    }
+                }
+
+                size_t chunkCount = chunkBytes / sizeof(T) ? chunkBytes / sizeof(T) : 1;
+                std::vector<T> chunk(static_cast<size_t>(count < chunkCount ? count : chunkCount));
+                for (uint64_t first = 0; first < count; first += chunk.size())
+                {
+                    size_t num = static_cast<size_t>(count - first < chunk.size() ? count - first : chunk.size());
+                    if (IsSaving() && !visit(chunk.data(), num, first))
+                    {
+                        SetError();
+                        return;
+                    }
+
+                    SerializeChunk(chunk.data(), num);
+
+                    if (IsLoading() && (HasError() || !visit(chunk.data(), num, first)))
+                    {
+                        SetError();
+                        return;
+                    }
+                }
+            }
+
+            // Zero-copy variants for callers that can work with views. On load the view points into
+            // the archive buffer when possible, otherwise the data is copied into storage and the
+            // view points there. Views stay valid as long as that buffer or storage does.
+            void SerializeView(std::string_view& value, std::string& storage);
+
+            template<typename T>
+            void SerializeArrayView(ArrayView<T>& view, std::vector<T>& storage)
+            {
+                static_assert(IsBulkSerializable<T>::Value, "Array views need trivially copyable elements");
+
+                if constexpr (Varint::IsCompactInteger<T>::Value)
+                {
+                    // Varints never match the in-memory layout, so views always decode into storage
+                    if (IsCompact())
+                    {
+                        if (IsSaving())
+                            storage.assign(view.begin(), view.end());
+                        SerializeCompactArray(storage);
+                        view.Data = storage.data();
+                        view.Num = storage.size();
+                        return;
+                    }
+                }
+
+                uint64_t count = view.Num;
+                SerializeCount(count);
+
+                if (IsLoading())
+                {
+                    if (count > static_cast<uint64_t>(TotalSize() - Tell()) / sizeof(T))
+                    {
+                        SetError();
+                        view = ArrayView<T>();
+                        return;
+                    }
+
+                    size_t length = static_cast<size_t>(count) * sizeof(T);
+                    const uint8_t* inPlace = length ? ReadInPlace(length) : nullptr;
+                    if (inPlace && reinterpret_cast<uintptr_t>(inPlace) % alignof(T) == 0)
+                    {
+                        view.Data = reinterpret_cast<const T*>(inPlace);
+                    }
+                    else
+                    {
+                        storage.resize(static_cast<size_t>(count));
+                        if (inPlace)
+                            std::memcpy(storage.data(), inPlace, length);
+                        else if (length)
+                            Serialize(storage.data(), length);
+                        view.Data = storage.data();
+                    }
+                    view.Num = static_cast<size_t>(count);
+                }
+                else if (count)
+                {
+                    Serialize(const_cast<T*>(view.Data), view.Num * sizeof(T));
+                }
+            }
+
+            // Compact mode arrays: count, encoded byte length, then the varints back to back so
+            // loading can decode the whole run at once
+            void SerializeCompactArray(std::vector<int32_t>& array);
+            void SerializeCompactArray(std::vector<uint32_t>& array);
+            void SerializeCompactArray(std::vector<int64_t>& array);
+            void SerializeCompactArray(std::vector<uint64_t>& array);
+
+            // The encoded byte length and varints of count values, without the count
+            void SerializeCompactBlock(int32_t* values, size_t count);
+            void SerializeCompactBlock(uint32_t* values, size_t count);
+            void SerializeCompactBlock(int64_t* values, size_t count);
+            void SerializeCompactBlock(uint64_t* values, size_t count);
+
+            // Object references. The base encoding is the referenced object's full name, resolved
+            // through ObjectRegistry on load; archives with their own reference tables override these.
+            virtual void SerializeObject(Object*& object);
+            virtual void SerializeObjectPtr(ObjectPtr<Object>& objectPtr);
+
+            // Saving: writes a reference in this archive's encoding into target, an ArchiveBuffer
+            // of this archive. Archives that override SerializeObject override this to match.
+            virtual void WriteObjectReference(Archive& target, Object* object);
+
+            // Delta mode: per-object baselines, objects without one are compared against their
+            // class default object. The map must outlive the serialization.
+            void SetDeltaBaselines(const PropertySnapshotMap* baselines) { DeltaBaselines = baselines; }
+            const PropertySnapshot* FindDeltaBaseline(const Object* object) const;
+
+            // StringTable mode. Each string is a varint: 0 is a new string written in full and
+            // appended to the table, N is table entry N - 1. By default the archive keeps its own
+            // table, which needs sequential access. A table set here is shared with other
+            // archives and serialized by its owner (e.g. a package's name table): saving then
+            // always writes indices and loading rejects new strings, so it is only read.
+            void SetStringTable(ArchiveStringTable* table) { SharedStrings = table; }
+
+        protected:
+            ArchiveFlags Flags;
+            bool ErrorFlag = false;
+            const PropertySnapshotMap* DeltaBaselines = nullptr;
+            ArchiveStringTable* SharedStrings = nullptr;
+            std::shared_ptr<ArchiveStringTable> OwnStrings;     // Shared with ArchiveBuffers of this archive
+
+        private:
+            friend class ArchiveBuffer;
+
+            void SerializeVarint(uint64_t& value, size_t maxBytes);
+            void SerializeInlineString(std::string& value);
+
+            // The table entry for value; nullptr on save or on a bad index
+            const std::string* SerializeTableString(std::string_view value);
+
+            template<typename T>
+            void SerializeChunk(T* elements, size_t num)
+            {
+                if constexpr (Varint::IsCompactInteger<T>::Value)
+                {
+                    if (IsCompact())
+                    {
+                        SerializeCompactBlock(elements, num);
+                        return;
+                    }
+                }
+
+                if constexpr (IsBulkSerializable<T>::Value)
+                {
+                    Serialize(elements, num * sizeof(T));
+                }
+                else
+                {
+                    for (size_t i = 0; i < num && !HasError(); ++i)
+                    {
+                        *this << elements[i];
+                    }
+                }
+            }
+
+            template<typename T>
+            void SerializeCompactArrayImpl(std::vector<T>& array);
+
+            template<typename T>
+            void SerializeCompactBlockImpl(T* values, size_t count);
+        };
+
+        // CRC32C of every BlockSize block of an archive's data, see EnableChecksums on
+        // MemoryArchive and FileArchive. Stored behind the data as one uint32_t per block,
+        // then a footer { uint64_t DataSize, uint32_t BlockSize, uint32_t Magic }.
+        class ArchiveChecksums
+        {
+        public:
+            static constexpr uint32_t BlockSize = 64 * 1024;
+            static constexpr uint32_t Magic = 0x43524354;   // "TCRC"
+            static constexpr size_t FooterSize = sizeof(uint64_t) + sizeof(uint32_t) * 2;
+
+            // Saving: folds in bytes that continue the data at GetSize()
+            void Append(const uint8_t* data, size_t size);
+            uint64_t GetSize() const { return Size; }
+
+            // Saving: forgets the block holding offset and everything after it; returns where
+            // appending has to resume
+            uint64_t Rewind(uint64_t offset);
+
+            std::vector<uint8_t> BuildTrailer() const;
+
+            // Loading: data size from the footer at the end of fileSize bytes; false if the
+            // footer is missing or does not match the file
+            static bool ReadFooter(const uint8_t* footer, uint64_t fileSize, uint64_t& dataSize);
+            static uint64_t GetTableSize(uint64_t dataSize);
+            void SetTable(const uint8_t* table, uint64_t dataSize);
+
+            // Loading: checks each block overlapping [offset, offset + size) once. data is the
+            // start of the archive data, every block must be addressable.
+            bool VerifyRange(const uint8_t* data, uint64_t offset, uint64_t size);
+
+            // Loading: checks the whole blocks in a buffer that starts at a block boundary
+            bool VerifyBlocks(const uint8_t* buffer, uint64_t offset, size_t size) const;
+
+        private:
+            std::vector<uint32_t> Checksums;
+            std::vector<bool> Verified;
+            uint64_t Size = 0;
+            uint32_t Partial = 0;       // Checksum of the incomplete last block
+        };
+
+        // Saving archive that only counts bytes, to size a buffer before the real save. Exact
+        // for an archive with the same flags and the default object reference encoding.
+        class CountingArchive : public Archive
+        {
+        public:
+            explicit CountingArchive(ArchiveFlags flags = ArchiveFlags::None);
+
+            virtual void Seek(int64_t position) override;
+            virtual int64_t Tell() const override { return Position; }
+            virtual int64_t TotalSize() const override { return Size; }
+
+            virtual void Serialize(void* data, size_t length) override;
+
+            // Bytes object->Serialize writes with flags; also updates the class's size estimate
+            static size_t Measure(Object* object, ArchiveFlags flags = ArchiveFlags::None);
+
+            // The class's estimate once one instance was measured or saved, Measure before that
+            static size_t Estimate(Object* object, ArchiveFlags flags = ArchiveFlags::None);
+
+        private:
+            int64_t Position = 0;
+            int64_t Size = 0;
+        };
+
+        // Memory archive - for in-memory serialization
+        // Loads either from its own Data or from a borrowed buffer that is never copied
+        class MemoryArchive : public Archive
+        {
+        public:
+            MemoryArchive(bool loading = false);
+            MemoryArchive(const std::vector<uint8_t>& data, bool loading = true);
+            MemoryArchive(std::vector<uint8_t>&& data, bool loading = true);
+
+            // Read-only archive over memory owned by the caller (mapped file, network buffer, arena).
+            // The memory must outlive the archive and any views handed out by it.
+            MemoryArchive(const void* data, size_t size);
+
+            // Saving with the flags of a counting pass and capacity for everything it counted
+            explicit MemoryArchive(const CountingArchive& sizing);
+
+            virtual void Seek(int64_t position) override;
+            virtual int64_t Tell() const override;
+            virtual int64_t TotalSize() const override;
+
+            virtual void Serialize(void* data, size_t length) override;
+            virtual const uint8_t* ReadInPlace(size_t length) override;
+
+            bool IsBorrowed() const { return BorrowedData != nullptr; }
+
+            // Saving: room for size bytes in total without reallocating
+            void Reserve(size_t size) { Data.reserve(size); }
+
+            // Block checksums, enabled before the first byte. Loading reads the trailer and
+            // verifies every block the first time it is read; false if there is no valid
+            // trailer. Saving appends the trailer on Flush.
+            bool EnableChecksums();
+            bool HasChecksums() const { return Checksums != nullptr; }
+
+            // Saving with checksums: appends the trailer to Data; a later write drops it again
+            void Flush();
+
+            const std::vector<uint8_t>& GetData() const { return Data; }
+            std::vector<uint8_t>& GetData() { return Data; }
+
+        private:
+            const uint8_t* GetBuffer() const { return BorrowedData ? BorrowedData : Data.data(); }
+            size_t GetBufferSize() const { return Checksums ? ChecksummedSize : BorrowedData ? BorrowedSize : Data.size(); }
+
+            std::vector<uint8_t> Data;
+            const uint8_t* BorrowedData = nullptr;
+            size_t BorrowedSize = 0;
+            size_t Position = 0;
+
+            std::unique_ptr<ArchiveChecksums> Checksums;
+            size_t ChecksummedSize = 0;         // Data size without the trailer
+        };
+
+        // Saving archive that buffers data bound for another archive, for records whose header is
+        // only known once the body is written. Uses the target's flags and string table and encodes
+        // object references through the target, so the bytes are exactly what the target would
+        // have written; they have to be copied into it before anything else is written there.
+        class ArchiveBuffer : public MemoryArchive
+        {
+        public:
+            explicit ArchiveBuffer(Archive& target);
+
+            virtual void SerializeObject(Object*& object) override;
+            virtual void WriteObjectReference(Archive& target, Object* object) override;
+
+        private:
+            Archive& Target;
+        };
+
+        // File archive - for file-based serialization
+        // Data moves through BufferSize blocks. Saving hands full blocks to AsyncIO while
+        // serialization continues; loading keeps the next block read ahead.
+        // LoadMode::MemoryMapped serves loads straight from a read-only mapping instead.
+        class FileArchive : public Archive
+        {
+        public:
+            static constexpr size_t DefaultBufferSize = 1024 * 1024;
+
+            enum class LoadMode : uint8_t
+            {
+                Buffered,
+                MemoryMapped,   // Falls back to Buffered if the file cannot be mapped
+            };
+
+            FileArchive(const std::string& filename, bool loading, size_t bufferSize = DefaultBufferSize);
+            FileArchive(const std::string& filename, LoadMode mode, size_t bufferSize = DefaultBufferSize);
+            ~FileArchive();
+
+            virtual void Seek(int64_t position) override;
+            virtual int64_t Tell() const override;
+            virtual int64_t TotalSize() const override;
+
+            virtual void Serialize(void* data, size_t length) override;
+            virtual const uint8_t* ReadInPlace(size_t length) override;
+
+            // Saving: waits until every written byte reached the file; with checksums the
+            // trailer is written behind the data
+            void Flush();
+
+            // Saving: Flush, then waits until the file is on the storage device
+            void Sync();
+
+            // Block checksums, enabled before the first byte. Loading verifies each buffered
+            // block as it is read from disk, or each mapped block on first access; false if the
+            // file has no valid trailer. Buffered loads align their buffers to checksum blocks.
+            bool EnableChecksums();
+            bool HasChecksums() const { return Checksums != nullptr; }
+
+            bool IsOpen() const { return FileHandle != PlatformFile::InvalidHandle; }
+            bool IsMemoryMapped() const { return Mapping.Data != nullptr; }
+
+        private:
+            void OpenForLoad(const std::string& filename, LoadMode mode);
+
+            // Save path
+            void SubmitWriteBlock();
+            void WriteChecksums();
+
+            void WaitForPendingWrites();
+
+            // Load path
+            void FillBuffer(int64_t offset);
+            void RequestReadAhead(int64_t offset);
+            void WaitForReadAhead();
+
+            intptr_t FileHandle = PlatformFile::InvalidHandle;
+            PlatformFile::MappedRegion Mapping;
+            int64_t Position = 0;
+            int64_t Size = 0;
+            size_t BufferSize = DefaultBufferSize;
+
+            // Current block: bytes [BufferOffset, BufferOffset + BufferUsed) of the file
+            std::vector<uint8_t> Buffer;
+            int64_t BufferOffset = 0;
+            size_t BufferUsed = 0;
+
+            // Guarded by IoMutex, written blocks return to FreeBuffers from AsyncIO callbacks
+            std::vector<std::vector<uint8_t>> FreeBuffers;
+            size_t PendingWrites = 0;
+            bool IoFailed = false;
+            std::mutex IoMutex;
+            std::condition_variable IoCondition;
+
+            std::vector<uint8_t> ReadAheadBuffer;
+            int64_t ReadAheadOffset = -1;
+            IoHandle ReadAhead;
+
+            std::unique_ptr<ArchiveChecksums> Checksums;
+            int64_t ChecksumRescanFrom = -1;    // Saving: first offset written out of order
+        };
+
+    } // namespace Core
+
 } // namespace Titan
\ No newline at end of file
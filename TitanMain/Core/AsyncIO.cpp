@@ -0,0 +1,651 @@
+#include "AsyncIO.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include "PlatformFile.h"
+
+#if TITAN_HAS_IO_URING
+    #include <cerrno>
+    #include <linux/io_uring.h>
+    #include <poll.h>
+    #include <sys/eventfd.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace Titan
+{
+    namespace Core
+    {
+        enum class IoOperationState : uint8_t
+        {
+            Queued,
+            InFlight,
+            Done,
+        };
+
+        struct IoOperation
+        {
+            IoRequest Request;
+            AsyncIO* Owner = nullptr;
+            std::atomic<IoOperationState> State{ IoOperationState::Queued };
+            int64_t Transferred = 0;        // Backend-owned while InFlight
+            std::promise<IoResult> Promise;
+            std::shared_future<IoResult> Future;
+        };
+
+        // Exactly one caller gets here per operation
+        static void CompleteOperation(IoOperation& operation, IoStatus status)
+        {
+            IoResult result;
+            result.Status = status;
+            result.BytesTransferred = operation.Transferred;
+
+            operation.State.store(IoOperationState::Done, std::memory_order_release);
+            if (operation.Request.Callback)
+                operation.Request.Callback(result);
+            operation.Promise.set_value(result);
+        }
+
+        // Performs the transfer with blocking calls on the current thread
+        static void RunOperationBlocking(IoOperation& operation)
+        {
+            const IoRequest& request = operation.Request;
+            int64_t transferred = request.IsWrite
+                ? PlatformFile::WriteAt(request.FileHandle, request.Data, request.Length, request.Offset)
+                : PlatformFile::ReadAt(request.FileHandle, request.Data, request.Length, request.Offset);
+
+            operation.Transferred = std::max<int64_t>(transferred, 0);
+            CompleteOperation(operation, transferred < 0 ? IoStatus::Failed : IoStatus::Completed);
+        }
+
+        // IoHandle implementation
+        bool IoHandle::IsComplete() const
+        {
+            return Operation && Operation->State.load(std::memory_order_acquire) == IoOperationState::Done;
+        }
+
+        IoResult IoHandle::Wait() const
+        {
+            return Operation ? Operation->Future.get() : IoResult();
+        }
+
+        std::shared_future<IoResult> IoHandle::GetFuture() const
+        {
+            return Operation ? Operation->Future : std::shared_future<IoResult>();
+        }
+
+        bool IoHandle::Cancel()
+        {
+            return Operation && Operation->Owner->RequestCancel(Operation);
+        }
+
+#if TITAN_HAS_IO_URING
+        // Raw io_uring setup; the kernel headers are all we depend on
+        struct AsyncIO::IoUring
+        {
+            static constexpr uint64_t WakeTag = 0;
+            static constexpr uint64_t CancelTag = 1;
+
+            ~IoUring()
+            {
+                if (Sqes)
+                    ::munmap(Sqes, SqesSize);
+                if (CqRing && CqRing != SqRing)
+                    ::munmap(CqRing, CqRingSize);
+                if (SqRing)
+                    ::munmap(SqRing, SqRingSize);
+                if (RingFd >= 0)
+                    ::close(RingFd);
+                if (EventFd >= 0)
+                    ::close(EventFd);
+            }
+
+            bool Initialize(uint32_t entries)
+            {
+                io_uring_params params;
+                std::memset(&params, 0, sizeof(params));
+                RingFd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+                if (RingFd < 0)
+                    return false;
+
+                SqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+                CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (singleMap)
+                    SqRingSize = CqRingSize = std::max(SqRingSize, CqRingSize);
+
+                SqRing = ::mmap(nullptr, SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, RingFd, IORING_OFF_SQ_RING);
+                if (SqRing == MAP_FAILED)
+                {
+                    SqRing = nullptr;
+                    return false;
+                }
+
+                CqRing = singleMap ? SqRing : ::mmap(nullptr, CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, RingFd, IORING_OFF_CQ_RING);
+                if (CqRing == MAP_FAILED)
+                {
+                    CqRing = nullptr;
+                    return false;
+                }
+
+                SqesSize = params.sq_entries * sizeof(io_uring_sqe);
+                void* sqes = ::mmap(nullptr, SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, RingFd, IORING_OFF_SQES);
+                if (sqes == MAP_FAILED)
+                    return false;
+                Sqes = static_cast<io_uring_sqe*>(sqes);
+
+                uint8_t* sq = static_cast<uint8_t*>(SqRing);
+                SqHead = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+                SqTail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+                SqMask = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+                SqArray = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+                SqEntries = params.sq_entries;
+
+                uint8_t* cq = static_cast<uint8_t*>(CqRing);
+                CqHead = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+                CqTail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+                CqMask = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+                Cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+                CqEntries = params.cq_entries;
+
+                // Rings from 5.1-5.5 set up fine but reject IORING_OP_READ/WRITE, which came with the probe in 5.6
+                if (!SupportsOperations({ IORING_OP_READ, IORING_OP_WRITE, IORING_OP_POLL_ADD, IORING_OP_ASYNC_CANCEL }))
+                    return false;
+
+                EventFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+                return EventFd >= 0;
+            }
+
+            bool SupportsOperations(std::initializer_list<uint8_t> opcodes) const
+            {
+                // io_uring_probe ends in one io_uring_probe_op per opcode
+                constexpr uint32_t maxOps = 256;
+                std::vector<uint8_t> buffer(sizeof(io_uring_probe) + maxOps * sizeof(io_uring_probe_op), 0);
+                io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+                if (::syscall(__NR_io_uring_register, RingFd, IORING_REGISTER_PROBE, probe, maxOps) < 0)
+                    return false;
+
+                for (uint8_t opcode : opcodes)
+                {
+                    if (opcode > probe->last_op || !(probe->ops[opcode].flags & IO_URING_OP_SUPPORTED))
+                        return false;
+                }
+                return true;
+            }
+
+            // Submission entries not yet consumed by the kernel are not free
+            uint32_t GetFreeEntries() const
+            {
+                return SqEntries - (*SqTail + NumPrepared - __atomic_load_n(SqHead, __ATOMIC_ACQUIRE));
+            }
+
+            // Only the ring thread touches the queues; check GetFreeEntries first
+            io_uring_sqe& PrepareEntry(uint8_t opcode, uint64_t userData)
+            {
+                uint32_t tail = *SqTail + NumPrepared;
+                uint32_t index = tail & SqMask;
+                io_uring_sqe& sqe = Sqes[index];
+                std::memset(&sqe, 0, sizeof(sqe));
+                sqe.opcode = opcode;
+                sqe.user_data = userData;
+                SqArray[index] = index;
+                ++NumPrepared;
+                return sqe;
+            }
+
+            void PrepareTransfer(IoOperation& operation)
+            {
+                const IoRequest& request = operation.Request;
+                size_t remaining = request.Length - static_cast<size_t>(operation.Transferred);
+                io_uring_sqe& sqe = PrepareEntry(request.IsWrite ? IORING_OP_WRITE : IORING_OP_READ, reinterpret_cast<uint64_t>(&operation));
+                sqe.fd = static_cast<int>(request.FileHandle);
+                sqe.addr = reinterpret_cast<uint64_t>(static_cast<uint8_t*>(request.Data) + operation.Transferred);
+                sqe.len = static_cast<uint32_t>(std::min<size_t>(remaining, 0x7ffff000));
+                sqe.off = static_cast<uint64_t>(request.Offset + operation.Transferred);
+            }
+
+            // Submits everything prepared and waits for at least one completion
+            bool SubmitAndWait()
+            {
+                __atomic_store_n(SqTail, *SqTail + NumPrepared, __ATOMIC_RELEASE);
+                NumPrepared = 0;
+
+                for (;;)
+                {
+                    uint32_t toSubmit = *SqTail - __atomic_load_n(SqHead, __ATOMIC_ACQUIRE);
+                    if (::syscall(__NR_io_uring_enter, RingFd, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0) >= 0)
+                        return true;
+                    if (errno != EINTR && errno != EBUSY && errno != EAGAIN)
+                        return false;
+                }
+            }
+
+            int RingFd = -1;
+            int EventFd = -1;
+
+            void* SqRing = nullptr;
+            void* CqRing = nullptr;
+            size_t SqRingSize = 0;
+            size_t CqRingSize = 0;
+            io_uring_sqe* Sqes = nullptr;
+            size_t SqesSize = 0;
+
+            uint32_t* SqHead = nullptr;
+            uint32_t* SqTail = nullptr;
+            uint32_t* SqArray = nullptr;
+            uint32_t SqMask = 0;
+            uint32_t SqEntries = 0;
+            uint32_t NumPrepared = 0;
+
+            uint32_t* CqHead = nullptr;
+            uint32_t* CqTail = nullptr;
+            uint32_t CqMask = 0;
+            uint32_t CqEntries = 0;
+            io_uring_cqe* Cqes = nullptr;
+        };
+#else
+        struct AsyncIO::IoUring
+        {
+        };
+#endif
+
+        // AsyncIO implementation
+        AsyncIO& AsyncIO::Get()
+        {
+            static AsyncIO instance;
+            return instance;
+        }
+
+        AsyncIO::AsyncIO(uint32_t queueDepth, uint32_t fallbackThreads, bool allowIoUring)
+        {
+            NumFallbackThreads = std::max<uint32_t>(fallbackThreads, 1);
+#if TITAN_HAS_IO_URING
+            if (allowIoUring)
+            {
+                // Seccomp filters and old kernels refuse io_uring; fall back quietly
+                auto ring = std::make_unique<IoUring>();
+                if (ring->Initialize(std::max<uint32_t>(queueDepth, 8)))
+                {
+                    Ring = std::move(ring);
+                    UsingRing = true;
+                    Threads.emplace_back([this]() { RingLoop(); });
+                    return;
+                }
+            }
+#endif
+            for (uint32_t i = 0; i < NumFallbackThreads; ++i)
+            {
+                Threads.emplace_back([this]() { FallbackWorkerLoop(); });
+            }
+        }
+
+        AsyncIO::~AsyncIO()
+        {
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                IsStopping = true;
+            }
+            WakeBackend();
+
+            for (std::thread& thread : Threads)
+            {
+                thread.join();
+            }
+        }
+
+        IoHandle AsyncIO::Read(intptr_t fileHandle, void* data, size_t length, int64_t offset, IoPriority priority, IoCallback callback)
+        {
+            IoRequest request;
+            request.FileHandle = fileHandle;
+            request.Data = data;
+            request.Length = length;
+            request.Offset = offset;
+            request.Priority = priority;
+            request.Callback = std::move(callback);
+            return Submit(std::move(request));
+        }
+
+        IoHandle AsyncIO::Write(intptr_t fileHandle, const void* data, size_t length, int64_t offset, IoPriority priority, IoCallback callback)
+        {
+            IoRequest request;
+            request.FileHandle = fileHandle;
+            request.Data = const_cast<void*>(data);
+            request.Length = length;
+            request.Offset = offset;
+            request.IsWrite = true;
+            request.Priority = priority;
+            request.Callback = std::move(callback);
+            return Submit(std::move(request));
+        }
+
+        IoHandle AsyncIO::Submit(IoRequest request)
+        {
+            std::vector<IoRequest> requests;
+            requests.push_back(std::move(request));
+            return SubmitBatch(std::move(requests)).front();
+        }
+
+        std::vector<IoHandle> AsyncIO::SubmitBatch(std::vector<IoRequest> requests)
+        {
+            std::vector<IoHandle> handles;
+            handles.reserve(requests.size());
+
+            std::vector<std::shared_ptr<IoOperation>> operations;
+            operations.reserve(requests.size());
+            for (IoRequest& request : requests)
+            {
+                auto operation = std::make_shared<IoOperation>();
+                operation->Request = std::move(request);
+                operation->Owner = this;
+                operation->Future = operation->Promise.get_future().share();
+                operation->Request.Priority = std::min(operation->Request.Priority, static_cast<IoPriority>(static_cast<size_t>(IoPriority::Count) - 1));
+                handles.push_back(IoHandle(operation));
+                operations.push_back(std::move(operation));
+            }
+
+            bool isStopping;
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                isStopping = IsStopping;
+                if (!isStopping)
+                {
+                    for (auto& operation : operations)
+                    {
+                        Queues[static_cast<size_t>(operation->Request.Priority)].push_back(operation);
+                    }
+                }
+            }
+
+            if (isStopping)
+            {
+                for (auto& operation : operations)
+                {
+                    CompleteOperation(*operation, IoStatus::Cancelled);
+                }
+            }
+            else if (!operations.empty())
+            {
+                WakeBackend();
+            }
+            return handles;
+        }
+
+        bool AsyncIO::RequestCancel(const std::shared_ptr<IoOperation>& operation)
+        {
+            // Queued operations are claimed here; the backend skips them when popping
+            IoOperationState expected = IoOperationState::Queued;
+            if (operation->State.compare_exchange_strong(expected, IoOperationState::InFlight, std::memory_order_acq_rel))
+            {
+                CompleteOperation(*operation, IoStatus::Cancelled);
+                return true;
+            }
+
+            if (expected == IoOperationState::InFlight && UsingRing)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(Mutex);
+                    CancelRequests.push_back(operation);
+                }
+                WakeBackend();
+            }
+            return false;
+        }
+
+        std::shared_ptr<IoOperation> AsyncIO::PopQueued()
+        {
+            for (size_t priority = static_cast<size_t>(IoPriority::Count); priority-- > 0;)
+            {
+                auto& queue = Queues[priority];
+                while (!queue.empty())
+                {
+                    std::shared_ptr<IoOperation> operation = std::move(queue.front());
+                    queue.pop_front();
+
+                    IoOperationState expected = IoOperationState::Queued;
+                    if (operation->State.compare_exchange_strong(expected, IoOperationState::InFlight, std::memory_order_acq_rel))
+                        return operation;
+                }
+            }
+            return nullptr;
+        }
+
+        void AsyncIO::WakeBackend()
+        {
+#if TITAN_HAS_IO_URING
+            if (UsingRing)
+            {
+                uint64_t value = 1;
+                ssize_t written = ::write(Ring->EventFd, &value, sizeof(value));
+                (void)written;
+                return;
+            }
+#endif
+            Condition.notify_all();
+        }
+
+        void AsyncIO::FallbackWorkerLoop()
+        {
+            for (;;)
+            {
+                std::shared_ptr<IoOperation> operation;
+                {
+                    std::unique_lock<std::mutex> lock(Mutex);
+                    Condition.wait(lock, [this, &operation]()
+                    {
+                        operation = PopQueued();
+                        return operation != nullptr || IsStopping;
+                    });
+
+                    if (!operation)
+                        return;
+                }
+                RunOperationBlocking(*operation);
+            }
+        }
+
+        void AsyncIO::RingLoop()
+        {
+#if TITAN_HAS_IO_URING
+            IoUring& ring = *Ring;
+            std::unordered_map<IoOperation*, std::shared_ptr<IoOperation>> inFlight;
+            std::vector<IoOperation*> resubmit;
+            bool wakeArmed = false;
+            bool draining = false;
+            bool ringFailed = false;
+
+            // Keep room for the wake poll and cancel entries in both queues
+            const size_t maxInFlight = std::min(ring.SqEntries, ring.CqEntries / 2) - 2;
+
+            // Completes finished transfers; interrupted and short ones are left in flight and added to retry
+            auto reapCompletions = [&](std::vector<IoOperation*>& retry)
+            {
+                uint32_t head = *ring.CqHead;
+                uint32_t tail = __atomic_load_n(ring.CqTail, __ATOMIC_ACQUIRE);
+                for (; head != tail; ++head)
+                {
+                    const io_uring_cqe& cqe = ring.Cqes[head & ring.CqMask];
+                    if (cqe.user_data == IoUring::WakeTag)
+                    {
+                        uint64_t value;
+                        ssize_t read = ::read(ring.EventFd, &value, sizeof(value));
+                        (void)read;
+                        wakeArmed = false;
+                        continue;
+                    }
+                    if (cqe.user_data == IoUring::CancelTag)
+                        continue;
+
+                    IoOperation* operation = reinterpret_cast<IoOperation*>(cqe.user_data);
+                    int32_t result = cqe.res;
+                    if (result == -EINTR || result == -EAGAIN)
+                    {
+                        retry.push_back(operation);
+                        continue;
+                    }
+
+                    if (result > 0)
+                    {
+                        operation->Transferred += result;
+                        if (static_cast<size_t>(operation->Transferred) < operation->Request.Length)
+                        {
+                            // Short transfer, the rest goes out again unless it hit end of file next time
+                            retry.push_back(operation);
+                            continue;
+                        }
+                    }
+
+                    auto found = inFlight.find(operation);
+                    std::shared_ptr<IoOperation> keepAlive = std::move(found->second);
+                    inFlight.erase(found);
+                    CompleteOperation(*operation, result >= 0 ? IoStatus::Completed : result == -ECANCELED ? IoStatus::Cancelled : IoStatus::Failed);
+                }
+                __atomic_store_n(ring.CqHead, head, __ATOMIC_RELEASE);
+            };
+
+            for (;;)
+            {
+                if (!wakeArmed && !draining && ring.GetFreeEntries())
+                {
+                    io_uring_sqe& sqe = ring.PrepareEntry(IORING_OP_POLL_ADD, IoUring::WakeTag);
+                    sqe.fd = ring.EventFd;
+                    sqe.poll_events = POLLIN;
+                    wakeArmed = true;
+                }
+
+                while (!resubmit.empty() && ring.GetFreeEntries())
+                {
+                    ring.PrepareTransfer(*resubmit.back());
+                    resubmit.pop_back();
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(Mutex);
+                    for (const auto& operation : CancelRequests)
+                    {
+                        if (inFlight.count(operation.get()) && ring.GetFreeEntries())
+                        {
+                            io_uring_sqe& sqe = ring.PrepareEntry(IORING_OP_ASYNC_CANCEL, IoUring::CancelTag);
+                            sqe.addr = reinterpret_cast<uint64_t>(operation.get());
+                        }
+                    }
+                    CancelRequests.clear();
+
+                    while (inFlight.size() < maxInFlight && ring.GetFreeEntries())
+                    {
+                        std::shared_ptr<IoOperation> operation = PopQueued();
+                        if (!operation)
+                            break;
+
+                        ring.PrepareTransfer(*operation);
+                        inFlight.emplace(operation.get(), std::move(operation));
+                    }
+
+                    if (IsStopping && !draining)
+                    {
+                        // Queued work still runs; only new submissions are refused
+                        bool queuesEmpty = std::all_of(std::begin(Queues), std::end(Queues), [](const auto& queue) { return queue.empty(); });
+                        draining = queuesEmpty;
+                    }
+                }
+
+                if (draining && inFlight.empty())
+                    break;
+
+                if (!ring.SubmitAndWait())
+                {
+                    ringFailed = true;
+                    break;
+                }
+                reapCompletions(resubmit);
+            }
+
+            if (!ringFailed)
+                return;
+
+            // The ring is unusable. Operations the kernel never saw or let go of are handed to the
+            // fallback threads; the rest are cancelled and reaped first, their buffers are the
+            // kernel's until the completion shows up.
+            std::vector<IoOperation*> released = std::move(resubmit);
+            uint32_t sqHead = __atomic_load_n(ring.SqHead, __ATOMIC_ACQUIRE);
+            for (uint32_t index = sqHead; index != *ring.SqTail; ++index)
+            {
+                const io_uring_sqe& sqe = ring.Sqes[ring.SqArray[index & ring.SqMask]];
+                if (sqe.opcode == IORING_OP_READ || sqe.opcode == IORING_OP_WRITE)
+                    released.push_back(reinterpret_cast<IoOperation*>(sqe.user_data));
+            }
+            __atomic_store_n(ring.SqTail, sqHead, __ATOMIC_RELEASE);
+
+            for (const auto& entry : inFlight)
+            {
+                bool isReleased = std::find(released.begin(), released.end(), entry.first) != released.end();
+                if (!isReleased && ring.GetFreeEntries())
+                {
+                    io_uring_sqe& sqe = ring.PrepareEntry(IORING_OP_ASYNC_CANCEL, IoUring::CancelTag);
+                    sqe.addr = reinterpret_cast<uint64_t>(entry.first);
+                }
+            }
+
+            // Every entry left in inFlight is either released or still owned by the kernel
+            reapCompletions(released);
+            while (inFlight.size() > released.size())
+            {
+                if (!ring.SubmitAndWait())
+                {
+                    // Nothing more can be learned from the ring, report what it still holds as failed
+                    for (auto it = inFlight.begin(); it != inFlight.end();)
+                    {
+                        if (std::find(released.begin(), released.end(), it->first) == released.end())
+                        {
+                            std::shared_ptr<IoOperation> keepAlive = std::move(it->second);
+                            it = inFlight.erase(it);
+                            CompleteOperation(*keepAlive, IoStatus::Failed);
+                        }
+                        else
+                        {
+                            ++it;
+                        }
+                    }
+                    break;
+                }
+                reapCompletions(released);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                for (IoOperation* operation : released)
+                {
+                    // Started over from the beginning, a blocking transfer does not resume
+                    auto found = inFlight.find(operation);
+                    operation->Transferred = 0;
+                    operation->State.store(IoOperationState::Queued, std::memory_order_release);
+                    Queues[static_cast<size_t>(operation->Request.Priority)].push_front(std::move(found->second));
+                    inFlight.erase(found);
+                }
+                CancelRequests.clear();
+                UsingRing = false;
+            }
+            RunFallbackWorkers();
+#endif
+        }
+
+        void AsyncIO::RunFallbackWorkers()
+        {
+            // Called on the ring thread, which becomes one of the workers; Threads belongs to the destructor
+            std::vector<std::thread> workers;
+            for (uint32_t i = 1; i < NumFallbackThreads; ++i)
+            {
+                workers.emplace_back([this]() { FallbackWorkerLoop(); });
+            }
+            FallbackWorkerLoop();
+
+            for (std::thread& worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,148 @@
+#pragma once
+
+// Titan::Core::AsyncIO - Asynchronous positional file reads and writes
+// Uses io_uring on Linux and a small pool of blocking I/O threads elsewhere (or when the
+// kernel refuses io_uring). Requests are prioritized, cancellable and complete through
+// callbacks and/or futures.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) && defined(__has_include)
+    #if __has_include(<linux/io_uring.h>)
+        #define TITAN_HAS_IO_URING 1
+    #endif
+#endif
+#ifndef TITAN_HAS_IO_URING
+    #define TITAN_HAS_IO_URING 0
+#endif
+
+namespace Titan
+{
+    namespace Core
+    {
+        enum class IoPriority : uint8_t
+        {
+            Low,
+            Normal,
+            High,
+            Critical,       // Something is blocked waiting on it
+
+            Count
+        };
+
+        enum class IoStatus : uint8_t
+        {
+            Pending,
+            Completed,      // BytesTransferred may be short at end of file
+            Failed,
+            Cancelled,
+        };
+
+        struct IoResult
+        {
+            IoStatus Status = IoStatus::Pending;
+            int64_t BytesTransferred = 0;
+        };
+
+        using IoCallback = std::function<void(const IoResult&)>;
+
+        // One read or write. Data must stay valid until the request completes.
+        struct IoRequest
+        {
+            intptr_t FileHandle = -1;   // PlatformFile handle
+            void* Data = nullptr;
+            size_t Length = 0;
+            int64_t Offset = 0;
+            bool IsWrite = false;
+            IoPriority Priority = IoPriority::Normal;
+            IoCallback Callback;        // Runs on an I/O thread, keep it short
+        };
+
+        struct IoOperation;
+
+        // Tracks a submitted request; copies share the same request
+        class IoHandle
+        {
+        public:
+            IoHandle() = default;
+
+            bool IsValid() const { return Operation != nullptr; }
+            bool IsComplete() const;
+
+            // Blocks until the request completed, failed or was cancelled
+            IoResult Wait() const;
+            std::shared_future<IoResult> GetFuture() const;
+
+            // True if the request had not started and now completes as Cancelled. Started
+            // io_uring requests are asked to stop as well, which may or may not succeed.
+            bool Cancel();
+
+        private:
+            friend class AsyncIO;
+            explicit IoHandle(std::shared_ptr<IoOperation> operation) : Operation(std::move(operation)) {}
+
+            std::shared_ptr<IoOperation> Operation;
+        };
+
+        class AsyncIO
+        {
+        public:
+            static AsyncIO& Get();
+
+            // allowIoUring = false forces the thread backend
+            explicit AsyncIO(uint32_t queueDepth = 256, uint32_t fallbackThreads = 4, bool allowIoUring = true);
+            ~AsyncIO();
+
+            AsyncIO(const AsyncIO&) = delete;
+            AsyncIO& operator=(const AsyncIO&) = delete;
+
+            IoHandle Read(intptr_t fileHandle, void* data, size_t length, int64_t offset,
+                          IoPriority priority = IoPriority::Normal, IoCallback callback = IoCallback());
+            IoHandle Write(intptr_t fileHandle, const void* data, size_t length, int64_t offset,
+                           IoPriority priority = IoPriority::Normal, IoCallback callback = IoCallback());
+
+            IoHandle Submit(IoRequest request);
+
+            // Queues all requests under one lock and wakes the backend once
+            std::vector<IoHandle> SubmitBatch(std::vector<IoRequest> requests);
+
+            // False once the ring failed and the fallback threads took over
+            bool IsUsingIoUring() const { return UsingRing.load(); }
+
+        private:
+            friend class IoHandle;
+            struct IoUring;
+
+            bool RequestCancel(const std::shared_ptr<IoOperation>& operation);
+            std::shared_ptr<IoOperation> PopQueued();   // Caller holds Mutex
+            void WakeBackend();
+
+            void FallbackWorkerLoop();
+            void RingLoop();
+            void RunFallbackWorkers();
+
+            std::mutex Mutex;
+            std::condition_variable Condition;
+            std::deque<std::shared_ptr<IoOperation>> Queues[static_cast<size_t>(IoPriority::Count)];
+            std::vector<std::shared_ptr<IoOperation>> CancelRequests;
+            bool IsStopping = false;
+
+            std::unique_ptr<IoUring> Ring;
+            std::atomic<bool> UsingRing{ false };      // Written under Mutex
+            uint32_t NumFallbackThreads = 1;
+            std::vector<std::thread> Threads;
+        };
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
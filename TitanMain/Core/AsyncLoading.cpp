@@ -0,0 +1,335 @@
+#include "AsyncLoading.h"
+#include <algorithm>
+#include <chrono>
+#include "Archive.h"
+#include "GarbageCollection.h"
+#include "Object.h"
+#include "Package.h"
+#include "PlatformFile.h"
+#include "ThreadPool.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        struct AsyncLoadRequest
+        {
+            std::string Filename;
+            AsyncPackageLoader::CompletionCallback OnComplete;
+            std::atomic<AsyncLoadStatus> Status{AsyncLoadStatus::Reading};
+
+            // Reading
+            intptr_t FileHandle = PlatformFile::InvalidHandle;
+            std::vector<uint8_t> Buffer;
+            IoHandle Io;
+
+            // Linking through finalizing; released once complete
+            std::unique_ptr<MemoryArchive> Archive;
+            std::unique_ptr<PackageLoader> Loader;
+            std::atomic<size_t> RemainingTasks{0};
+
+            // Finalizing resumes from these on the next Tick once the budget runs out
+            size_t NextFinalize = 0;
+            bool ClustersCreated = false;
+            size_t NextBeginPlay = 0;
+
+            std::vector<Object*> Objects;
+            bool HasFailedExports = false;
+        };
+
+        static double GetSeconds()
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        // A deadline of 0 never passes
+        static bool HasPassed(double deadline)
+        {
+            return deadline > 0.0 && GetSeconds() >= deadline;
+        }
+
+        // AsyncLoadHandle implementation
+
+        AsyncLoadStatus AsyncLoadHandle::GetStatus() const
+        {
+            return Request ? Request->Status.load() : AsyncLoadStatus::Failed;
+        }
+
+        bool AsyncLoadHandle::IsComplete() const
+        {
+            AsyncLoadStatus status = GetStatus();
+            return status == AsyncLoadStatus::Completed || status == AsyncLoadStatus::Failed;
+        }
+
+        void AsyncLoadHandle::Wait() const
+        {
+            AsyncPackageLoader& loader = AsyncPackageLoader::Get();
+            std::unique_lock<std::mutex> lock(loader.Mutex);
+            loader.Condition.wait(lock, [this]() { return IsComplete(); });
+        }
+
+        const std::vector<Object*>& AsyncLoadHandle::GetObjects() const
+        {
+            static const std::vector<Object*> empty;
+            return Request && IsComplete() ? Request->Objects : empty;
+        }
+
+        Object* AsyncLoadHandle::FindObject(const std::string& fullName) const
+        {
+            for (Object* object : GetObjects())
+            {
+                if (object->GetFullName() == fullName)
+                    return object;
+            }
+            return nullptr;
+        }
+
+        const std::string& AsyncLoadHandle::GetFilename() const
+        {
+            static const std::string empty;
+            return Request ? Request->Filename : empty;
+        }
+
+        // AsyncPackageLoader implementation
+
+        AsyncPackageLoader& AsyncPackageLoader::Get()
+        {
+            // Created after the services it uses so it is destroyed before them
+            AsyncIO::Get();
+            ThreadPool::Get();
+            static AsyncPackageLoader instance;
+            return instance;
+        }
+
+        AsyncPackageLoader::~AsyncPackageLoader()
+        {
+            // Buffers and loaders must outlive the reads and workers using them
+            for (const std::shared_ptr<AsyncLoadRequest>& request : Requests)
+            {
+                request->Io.Cancel();
+                std::unique_lock<std::mutex> lock(Mutex);
+                Condition.wait(lock, [&request]()
+                {
+                    AsyncLoadStatus status = request->Status.load();
+                    return status != AsyncLoadStatus::Reading && status != AsyncLoadStatus::Deserializing;
+                });
+            }
+        }
+
+        void AsyncPackageLoader::SetStatus(AsyncLoadRequest& request, AsyncLoadStatus status)
+        {
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                request.Status = status;
+            }
+            Condition.notify_all();
+        }
+
+        AsyncLoadHandle AsyncPackageLoader::LoadPackage(const std::string& filename, IoPriority priority, CompletionCallback onComplete)
+        {
+            auto request = std::make_shared<AsyncLoadRequest>();
+            request->Filename = filename;
+            request->OnComplete = std::move(onComplete);
+            Requests.push_back(request);
+
+            // A failed open is reported from the next Tick
+            request->FileHandle = PlatformFile::Open(filename, false);
+            int64_t size = request->FileHandle != PlatformFile::InvalidHandle ? PlatformFile::GetSize(request->FileHandle) : -1;
+            if (size < 0)
+            {
+                PlatformFile::Close(request->FileHandle);
+                request->Status = AsyncLoadStatus::Failed;
+                return AsyncLoadHandle(request);
+            }
+
+            request->Buffer.resize(static_cast<size_t>(size));
+            AsyncLoadRequest* raw = request.get();
+            request->Io = AsyncIO::Get().Read(request->FileHandle, request->Buffer.data(), request->Buffer.size(), 0, priority,
+                [this, raw](const IoResult& result)
+            {
+                PlatformFile::Close(raw->FileHandle);
+                raw->FileHandle = PlatformFile::InvalidHandle;
+                if (result.Status != IoStatus::Completed || result.BytesTransferred != static_cast<int64_t>(raw->Buffer.size()))
+                {
+                    SetStatus(*raw, AsyncLoadStatus::Failed);
+                    return;
+                }
+
+                // Table parsing leaves the I/O thread free for the next read
+                ThreadPool::Get().Submit([this, raw]()
+                {
+                    raw->Archive = std::make_unique<MemoryArchive>(raw->Buffer.data(), raw->Buffer.size());
+                    raw->Loader = std::make_unique<PackageLoader>(*raw->Archive);
+                    SetStatus(*raw, raw->Loader->IsValid() ? AsyncLoadStatus::Linking : AsyncLoadStatus::Failed);
+                });
+            });
+            return AsyncLoadHandle(request);
+        }
+
+        void AsyncPackageLoader::Link(const std::shared_ptr<AsyncLoadRequest>& request)
+        {
+            PackageLoader& loader = *request->Loader;
+            loader.ResolveImports();
+
+            // With every export created, resolving references during deserialization is a lookup
+            if (!loader.CreateAllExports())
+                request->HasFailedExports = true;
+
+            bool isDelta = (static_cast<ArchiveFlags>(loader.GetSummary().DataFlags) & ArchiveFlags::Delta) != ArchiveFlags::None;
+            size_t numExports = loader.GetExports().size();
+            for (size_t i = 0; i < numExports; ++i)
+            {
+                // Warm the lazily built class caches the workers read
+                if (Object* object = loader.GetExports()[i].CreatedObject)
+                {
+                    object->GetClass()->GetAllProperties();
+                    if (isDelta)
+                        object->GetClass()->GetDefaultObject();
+                }
+            }
+
+            if (numExports == 0)
+            {
+                request->Status = AsyncLoadStatus::Finalizing;
+                return;
+            }
+
+            ThreadPool& pool = ThreadPool::Get();
+            size_t chunkSize = std::max<size_t>(1, numExports / ((pool.GetNumThreads() + 1) * 4));
+            size_t numTasks = (numExports + chunkSize - 1) / chunkSize;
+            request->RemainingTasks = numTasks;
+            request->Status = AsyncLoadStatus::Deserializing;
+
+            AsyncLoadRequest* raw = request.get();
+            for (size_t task = 0; task < numTasks; ++task)
+            {
+                size_t begin = task * chunkSize;
+                size_t end = std::min(begin + chunkSize, numExports);
+                pool.Submit([this, raw, begin, end]()
+                {
+                    PackageLoader& loader = *raw->Loader;
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        const ObjectExport& entry = loader.GetExports()[i];
+                        loader.SerializeExport(i, raw->Buffer.data() + entry.SerialOffset, static_cast<size_t>(entry.SerialSize));
+                    }
+
+                    if (raw->RemainingTasks.fetch_sub(1) == 1)
+                        SetStatus(*raw, AsyncLoadStatus::Finalizing);
+                });
+            }
+        }
+
+        bool AsyncPackageLoader::Finalize(const std::shared_ptr<AsyncLoadRequest>& request, double deadline)
+        {
+            PackageLoader& loader = *request->Loader;
+            const std::vector<ObjectExport>& exports = loader.GetExports();
+            for (; request->NextFinalize < exports.size(); ++request->NextFinalize)
+            {
+                if (HasPassed(deadline))
+                    return false;
+
+                size_t exportIndex = request->NextFinalize;
+                loader.FinishExport(exportIndex);
+
+                Object* object = exports[exportIndex].CreatedObject;
+                if (object && object->HasFlags(ObjectFlags::LoadCompleted))
+                    request->Objects.push_back(object);
+                else
+                    request->HasFailedExports = true;
+            }
+
+            if (!request->ClustersCreated)
+            {
+                if (HasPassed(deadline))
+                    return false;
+
+                GarbageCollector::Get().CreateClustersForLoadedObjects(request->Objects);
+                request->ClustersCreated = true;
+            }
+
+            for (; request->NextBeginPlay < request->Objects.size(); ++request->NextBeginPlay)
+            {
+                if (HasPassed(deadline))
+                    return false;
+
+                request->Objects[request->NextBeginPlay]->BeginPlay();
+            }
+
+            request->Loader.reset();
+            request->Archive.reset();
+            request->Buffer = std::vector<uint8_t>();
+            return true;
+        }
+
+        void AsyncPackageLoader::Tick(double maxSeconds)
+        {
+            double deadline = maxSeconds > 0.0 ? GetSeconds() + maxSeconds : 0.0;
+
+            // Callbacks may start new loads, so collect first
+            std::vector<std::shared_ptr<AsyncLoadRequest>> finished;
+            for (size_t i = 0; i < Requests.size();)
+            {
+                std::shared_ptr<AsyncLoadRequest> request = Requests[i];
+                AsyncLoadStatus status = request->Status.load();
+                if (status == AsyncLoadStatus::Linking)
+                {
+                    Link(request);
+                    status = request->Status.load();
+                }
+
+                if (status == AsyncLoadStatus::Finalizing && Finalize(request, deadline))
+                {
+                    SetStatus(*request, request->HasFailedExports ? AsyncLoadStatus::Failed : AsyncLoadStatus::Completed);
+                    status = request->Status.load();
+                }
+
+                if (status == AsyncLoadStatus::Completed || status == AsyncLoadStatus::Failed)
+                {
+                    finished.push_back(request);
+                    Requests.erase(Requests.begin() + i);
+                    continue;
+                }
+                ++i;
+            }
+
+            for (const std::shared_ptr<AsyncLoadRequest>& request : finished)
+            {
+                if (request->OnComplete)
+                    request->OnComplete(AsyncLoadHandle(request));
+            }
+        }
+
+        void AsyncPackageLoader::Flush(const AsyncLoadHandle& handle)
+        {
+            if (!handle.IsValid())
+                return;
+
+            auto isPending = [&handle]()
+            {
+                AsyncLoadStatus status = handle.GetStatus();
+                return status == AsyncLoadStatus::Reading || status == AsyncLoadStatus::Deserializing;
+            };
+
+            // Tick also delivers the completion callback, so keep going until the request left the list
+            while (std::find(Requests.begin(), Requests.end(), handle.Request) != Requests.end())
+            {
+                {
+                    std::unique_lock<std::mutex> lock(Mutex);
+                    Condition.wait(lock, [&isPending]() { return !isPending(); });
+                }
+                Tick();
+            }
+        }
+
+        void AsyncPackageLoader::Flush()
+        {
+            while (!Requests.empty())
+            {
+                Flush(AsyncLoadHandle(Requests.front()));
+            }
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
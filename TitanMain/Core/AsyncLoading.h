@@ -0,0 +1,112 @@
+#pragma once
+
+// Titan::Core::AsyncLoading - Background package loading
+// A package load moves through these stages:
+//     Reading        whole file through AsyncIO
+//     Linking        tables parsed on a worker; then on the game thread imports are resolved
+//                    against ObjectRegistry and every export is instantiated, unregistered
+//     Deserializing  exports read their data in parallel on the ThreadPool
+//     Finalizing     game thread registers the objects, calls PostInitProperties, builds GC
+//                    clusters and calls BeginPlay, within a per-tick time budget
+// Only the Linking and Finalizing steps touch the registry, both from AsyncPackageLoader::Tick.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "AsyncIO.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        class Object;
+        struct AsyncLoadRequest;
+
+        enum class AsyncLoadStatus : uint8_t
+        {
+            Reading,
+            Linking,
+            Deserializing,
+            Finalizing,
+            Completed,
+            Failed,         // Unreadable package, or some exports did not load
+        };
+
+        // Tracks one LoadPackage call; copies share the same request
+        class AsyncLoadHandle
+        {
+        public:
+            AsyncLoadHandle() = default;
+
+            bool IsValid() const { return Request != nullptr; }
+            AsyncLoadStatus GetStatus() const;
+            bool IsComplete() const;
+
+            // Blocks until the load completed or failed. Finalizing needs Tick on the game thread,
+            // so the game thread itself waits with AsyncPackageLoader::Flush instead.
+            void Wait() const;
+
+            // Loaded exports in export table order, valid once complete
+            const std::vector<Object*>& GetObjects() const;
+            Object* FindObject(const std::string& fullName) const;
+
+            const std::string& GetFilename() const;
+
+        private:
+            friend class AsyncPackageLoader;
+            explicit AsyncLoadHandle(std::shared_ptr<AsyncLoadRequest> request) : Request(std::move(request)) {}
+
+            std::shared_ptr<AsyncLoadRequest> Request;
+        };
+
+        class AsyncPackageLoader
+        {
+        public:
+            using CompletionCallback = std::function<void(const AsyncLoadHandle&)>;
+
+            static AsyncPackageLoader& Get();
+
+            AsyncPackageLoader() = default;
+            ~AsyncPackageLoader();
+
+            AsyncPackageLoader(const AsyncPackageLoader&) = delete;
+            AsyncPackageLoader& operator=(const AsyncPackageLoader&) = delete;
+
+            // Starts loading a package file; onComplete runs from a later Tick on the game thread
+            AsyncLoadHandle LoadPackage(const std::string& filename, IoPriority priority = IoPriority::Normal,
+                                        CompletionCallback onComplete = CompletionCallback());
+
+            // Game thread: advances linking and finalizing. maxSeconds bounds finalize work per
+            // call, 0 means no limit.
+            void Tick(double maxSeconds = 0.0);
+
+            // Game thread: ticks until the load (or every load) completed
+            void Flush(const AsyncLoadHandle& handle);
+            void Flush();
+
+            size_t GetNumPendingLoads() const { return Requests.size(); }
+
+        private:
+            friend class AsyncLoadHandle;
+
+            void Link(const std::shared_ptr<AsyncLoadRequest>& request);
+            bool Finalize(const std::shared_ptr<AsyncLoadRequest>& request, double deadline);
+            void SetStatus(AsyncLoadRequest& request, AsyncLoadStatus status);
+
+            // Requests in flight, only touched by the game thread
+            std::vector<std::shared_ptr<AsyncLoadRequest>> Requests;
+
+            // Signalled on every status change from any thread
+            std::mutex Mutex;
+            std::condition_variable Condition;
+        };
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "AsyncSaving.h"
+#include <chrono>
+#include "Archive.h"
+#include "CompressedArchive.h"
+#include "PlatformFile.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        SnapshotSaver::~SnapshotSaver()
+        {
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                IsStopping = true;
+            }
+            Condition.notify_all();
+
+            if (Writer.joinable())
+                Writer.join();
+        }
+
+        bool SnapshotSaver::Save(const std::string& filename, const std::vector<Object*>& objects, bool compress)
+        {
+            // The writer reads Capture until the save is done
+            if (IsSaving())
+                return false;
+
+            auto start = std::chrono::steady_clock::now();
+            bool captured = Capture.Capture(objects);
+            CaptureSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                LastSaveSucceeded = false;
+                if (!captured)
+                    return false;
+
+                PendingFilename = filename;
+                PendingCompress = compress;
+                IsWriting = true;
+            }
+
+            if (!Writer.joinable())
+                Writer = std::thread([this]() { WriterLoop(); });
+            Condition.notify_all();
+            return true;
+        }
+
+        void SnapshotSaver::WriterLoop()
+        {
+            std::unique_lock<std::mutex> lock(Mutex);
+            for (;;)
+            {
+                // A save queued before the destructor ran is still written
+                Condition.wait(lock, [this]() { return IsWriting || IsStopping; });
+                if (!IsWriting)
+                    return;
+
+                std::string filename = std::move(PendingFilename);
+                bool compress = PendingCompress;
+                lock.unlock();
+                bool succeeded = WriteSnapshot(filename, compress);
+                lock.lock();
+
+                LastSaveSucceeded = succeeded;
+                IsWriting = false;
+                Condition.notify_all();
+            }
+        }
+
+        bool SnapshotSaver::WriteSnapshot(const std::string& filename, bool compress)
+        {
+            // The previous save stays intact until the new one is completely on disk
+            std::string tempFilename = filename + ".tmp";
+            bool succeeded;
+            {
+                FileArchive file(tempFilename, false);
+                if (!file.IsOpen())
+                    return false;
+
+                if (compress)
+                {
+                    CompressedArchive compressed(file);
+                    Capture.Write(compressed);
+                    compressed.Close();
+                    succeeded = !compressed.HasError();
+                }
+                else
+                {
+                    succeeded = Capture.Write(file);
+                }
+
+                file.Sync();
+                succeeded = succeeded && !file.HasError();
+            }
+
+            return succeeded && PlatformFile::Rename(tempFilename, filename);
+        }
+
+        bool SnapshotSaver::IsSaving() const
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            return IsWriting;
+        }
+
+        bool SnapshotSaver::Wait()
+        {
+            std::unique_lock<std::mutex> lock(Mutex);
+            Condition.wait(lock, [this]() { return !IsWriting; });
+            return LastSaveSucceeded;
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+// Titan::Core::AsyncSaving - Object image snapshots written off the game thread
+// Save runs on the game thread only long enough to copy every object's reflected state into
+// the saver's ObjectImageCapture: one memcpy per trivially copyable run of its PropertyLayout,
+// strings and arrays copied behind the records, references resolved through registry slots.
+// Assembling the image, compressing it and writing the file then happen on the saver's own
+// thread, so the objects may change or be destroyed as soon as Save returns. A dedicated thread
+// rather than a ThreadPool task keeps that true on machines where the pool has no workers.
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ObjectImage.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        class Object;
+
+        class SnapshotSaver
+        {
+        public:
+            SnapshotSaver() = default;
+            ~SnapshotSaver();   // Finishes the running save
+
+            SnapshotSaver(const SnapshotSaver&) = delete;
+            SnapshotSaver& operator=(const SnapshotSaver&) = delete;
+
+            // Game thread. Captures objects and queues the write of filename, through a
+            // CompressedArchive if compress is set. The data goes to filename + ".tmp", which
+            // replaces filename once it is on disk. False without saving while the previous
+            // save is still being written or if the capture failed.
+            bool Save(const std::string& filename, const std::vector<Object*>& objects, bool compress = true);
+
+            bool IsSaving() const;
+
+            // Blocks until the queued write finished; whether the last save reached the file
+            bool Wait();
+
+            // Game-thread time of the last Save
+            double GetCaptureSeconds() const { return CaptureSeconds; }
+
+        private:
+            void WriterLoop();
+            bool WriteSnapshot(const std::string& filename, bool compress);
+
+            // Reused by every save, so periodic saves stop allocating once the buffers have grown
+            ObjectImageCapture Capture;
+
+            // Started by the first Save
+            std::thread Writer;
+            mutable std::mutex Mutex;
+            std::condition_variable Condition;
+            std::string PendingFilename;
+            bool PendingCompress = false;
+            bool IsWriting = false;
+            bool IsStopping = false;
+            bool LastSaveSucceeded = false;
+            double CaptureSeconds = 0.0;
+        };
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,281 @@
+#pragma once
+
+// Titan::Core::BitArray - Dense bit set used for object queries
+// Bits are stored in 64-bit words; set operations are vectorized where available
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define TITAN_BITARRAY_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+namespace Titan
+{
+    namespace Core
+    {
+        namespace BitOps
+        {
+            inline uint32_t CountTrailingZeros(uint64_t value)
+            {
+#if defined(_MSC_VER)
+                unsigned long index;
+                _BitScanForward64(&index, value);
+                return static_cast<uint32_t>(index);
+#else
+                return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+            }
+
+            inline uint32_t PopCount(uint64_t value)
+            {
+#if defined(_MSC_VER)
+                return static_cast<uint32_t>(__popcnt64(value));
+#else
+                return static_cast<uint32_t>(__builtin_popcountll(value));
+#endif
+            }
+
+            // dst &= src
+            inline void AndWords(uint64_t* dst, const uint64_t* src, size_t count)
+            {
+                size_t i = 0;
+#if defined(__AVX2__)
+                for (; i + 4 <= count; i += 4)
+                {
+                    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+                    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_and_si256(a, b));
+                }
+#elif defined(TITAN_BITARRAY_SSE2)
+                for (; i + 2 <= count; i += 2)
+                {
+                    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+                    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_and_si128(a, b));
+                }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+                for (; i + 2 <= count; i += 2)
+                {
+                    vst1q_u64(dst + i, vandq_u64(vld1q_u64(dst + i), vld1q_u64(src + i)));
+                }
+#endif
+                for (; i < count; ++i)
+                {
+                    dst[i] &= src[i];
+                }
+            }
+
+            // dst |= src
+            inline void OrWords(uint64_t* dst, const uint64_t* src, size_t count)
+            {
+                size_t i = 0;
+#if defined(__AVX2__)
+                for (; i + 4 <= count; i += 4)
+                {
+                    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+                    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_or_si256(a, b));
+                }
+#elif defined(TITAN_BITARRAY_SSE2)
+                for (; i + 2 <= count; i += 2)
+                {
+                    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+                    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(a, b));
+                }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+                for (; i + 2 <= count; i += 2)
+                {
+                    vst1q_u64(dst + i, vorrq_u64(vld1q_u64(dst + i), vld1q_u64(src + i)));
+                }
+#endif
+                for (; i < count; ++i)
+                {
+                    dst[i] |= src[i];
+                }
+            }
+
+            // dst &= ~src
+            inline void AndNotWords(uint64_t* dst, const uint64_t* src, size_t count)
+            {
+                size_t i = 0;
+#if defined(__AVX2__)
+                for (; i + 4 <= count; i += 4)
+                {
+                    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+                    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_andnot_si256(b, a));
+                }
+#elif defined(TITAN_BITARRAY_SSE2)
+                for (; i + 2 <= count; i += 2)
+                {
+                    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+                    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_andnot_si128(b, a));
+                }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+                for (; i + 2 <= count; i += 2)
+                {
+                    vst1q_u64(dst + i, vbicq_u64(vld1q_u64(dst + i), vld1q_u64(src + i)));
+                }
+#endif
+                for (; i < count; ++i)
+                {
+                    dst[i] &= ~src[i];
+                }
+            }
+        }
+
+        class BitArray
+        {
+        public:
+            BitArray() = default;
+            explicit BitArray(size_t numBits) { Resize(numBits); }
+
+            size_t Num() const { return NumBits; }
+            size_t NumWords() const { return Words.size(); }
+            const uint64_t* GetWords() const { return Words.data(); }
+            uint64_t GetWord(size_t wordIndex) const { return wordIndex < Words.size() ? Words[wordIndex] : 0; }
+
+            // Grows or shrinks the set, new bits are cleared
+            void Resize(size_t numBits)
+            {
+                NumBits = numBits;
+                Words.resize((numBits + 63) / 64, 0);
+                ClearUnusedBits();
+            }
+
+            void Reset()
+            {
+                std::fill(Words.begin(), Words.end(), 0);
+            }
+
+            bool Get(size_t index) const
+            {
+                return index < NumBits && (Words[index >> 6] & (uint64_t(1) << (index & 63))) != 0;
+            }
+
+            void Set(size_t index)
+            {
+                if (index >= NumBits)
+                    Resize(index + 1);
+                Words[index >> 6] |= uint64_t(1) << (index & 63);
+            }
+
+            void Clear(size_t index)
+            {
+                if (index < NumBits)
+                    Words[index >> 6] &= ~(uint64_t(1) << (index & 63));
+            }
+
+            void Set(size_t index, bool value)
+            {
+                if (value)
+                    Set(index);
+                else
+                    Clear(index);
+            }
+
+            size_t CountSetBits() const
+            {
+                size_t count = 0;
+                for (uint64_t word : Words)
+                {
+                    count += BitOps::PopCount(word);
+                }
+                return count;
+            }
+
+            bool Any() const
+            {
+                for (uint64_t word : Words)
+                {
+                    if (word)
+                        return true;
+                }
+                return false;
+            }
+
+            // Set operations - bits missing from the shorter operand count as zero
+            BitArray& operator&=(const BitArray& other)
+            {
+                size_t common = std::min(Words.size(), other.Words.size());
+                BitOps::AndWords(Words.data(), other.Words.data(), common);
+                std::fill(Words.begin() + common, Words.end(), 0);
+                return *this;
+            }
+
+            BitArray& operator|=(const BitArray& other)
+            {
+                if (other.NumBits > NumBits)
+                    Resize(other.NumBits);
+                BitOps::OrWords(Words.data(), other.Words.data(), other.Words.size());
+                return *this;
+            }
+
+            BitArray& AndNot(const BitArray& other)
+            {
+                size_t common = std::min(Words.size(), other.Words.size());
+                BitOps::AndNotWords(Words.data(), other.Words.data(), common);
+                return *this;
+            }
+
+            // Calls func(index) for every set bit in ascending order
+            template<typename Func>
+            void ForEachSetBit(Func&& func) const
+            {
+                ForEachSetBitInRange(0, NumBits, func);
+            }
+
+            // Same as ForEachSetBit, limited to [begin, end)
+            template<typename Func>
+            void ForEachSetBitInRange(size_t begin, size_t end, Func&& func) const
+            {
+                end = std::min(end, NumBits);
+                if (begin >= end)
+                    return;
+
+                size_t firstWord = begin >> 6;
+                size_t lastWord = (end - 1) >> 6;
+                for (size_t wordIndex = firstWord; wordIndex <= lastWord; ++wordIndex)
+                {
+                    uint64_t word = Words[wordIndex];
+                    if (wordIndex == firstWord)
+                        word &= ~uint64_t(0) << (begin & 63);
+                    if (wordIndex == lastWord && (end & 63) != 0)
+                        word &= ~uint64_t(0) >> (64 - (end & 63));
+
+                    while (word)
+                    {
+                        func((wordIndex << 6) + BitOps::CountTrailingZeros(word));
+                        word &= word - 1;
+                    }
+                }
+            }
+
+        private:
+            void ClearUnusedBits()
+            {
+                if ((NumBits & 63) != 0)
+                    Words.back() &= ~uint64_t(0) >> (64 - (NumBits & 63));
+            }
+
+            std::vector<uint64_t> Words;
+            size_t NumBits = 0;
+        };
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,318 @@
+#include "CompressedArchive.h"
+#include <algorithm>
+#include <cstring>
+#include "Compression.h"
+#include "ThreadPool.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        static constexpr int64_t FooterSize = sizeof(uint64_t) * 2 + sizeof(uint32_t) * 2;
+        static constexpr size_t MaxBlockSize = 64 * 1024 * 1024;
+
+        // Blocks compressed or decompressed per parallel batch
+        static size_t GetBatchSize()
+        {
+            return std::min<size_t>(ThreadPool::Get().GetNumThreads() + 1, 16);
+        }
+
+        CompressedArchive::CompressedArchive(Archive& inner, size_t blockSize)
+            : Archive((inner.IsLoading() ? ArchiveFlags::Loading : ArchiveFlags::Saving) | ArchiveFlags::Binary)
+            , Inner(inner)
+            , BlockSize(std::min(std::max<size_t>(blockSize, 4096), MaxBlockSize))
+            , DataStart(inner.Tell())
+        {
+            if (IsLoading())
+            {
+                ReadIndex();
+                return;
+            }
+
+            uint32_t magic = Magic;
+            uint32_t version = Version;
+            uint32_t storedBlockSize = static_cast<uint32_t>(BlockSize);
+            Inner << magic << version << storedBlockSize;
+        }
+
+        CompressedArchive::~CompressedArchive()
+        {
+            Close();
+        }
+
+        void CompressedArchive::Seek(int64_t position)
+        {
+            if (position < 0 || (IsSaving() && position < static_cast<int64_t>(FirstPendingBlock * BlockSize)))
+            {
+                SetError();
+                return;
+            }
+            Position = position;
+        }
+
+        int64_t CompressedArchive::Tell() const
+        {
+            return Position;
+        }
+
+        int64_t CompressedArchive::TotalSize() const
+        {
+            return Size;
+        }
+
+        void CompressedArchive::Serialize(void* data, size_t length)
+        {
+            uint8_t* bytes = static_cast<uint8_t*>(data);
+            if (IsSaving())
+            {
+                if (IsClosed)
+                {
+                    SetError();
+                    return;
+                }
+
+                while (length)
+                {
+                    size_t block = static_cast<size_t>(Position) / BlockSize;
+                    size_t offset = static_cast<size_t>(Position) % BlockSize;
+                    while (block >= FirstPendingBlock + PendingBlocks.size())
+                    {
+                        // Every block but the last is full size, gaps from seeking ahead read as zeros
+                        if (!PendingBlocks.empty())
+                            PendingBlocks.back().resize(BlockSize);
+                        PendingBlocks.emplace_back();
+                        PendingBlocks.back().reserve(BlockSize);
+                    }
+
+                    std::vector<uint8_t>& target = PendingBlocks[block - FirstPendingBlock];
+                    size_t chunk = std::min(length, BlockSize - offset);
+                    if (target.size() < offset + chunk)
+                        target.resize(offset + chunk);
+                    std::memcpy(target.data() + offset, bytes, chunk);
+
+                    Position += static_cast<int64_t>(chunk);
+                    Size = std::max(Size, Position);
+                    bytes += chunk;
+                    length -= chunk;
+
+                    if (PendingBlocks.size() > GetBatchSize())
+                        CompressPendingBlocks(false);
+                }
+                return;
+            }
+
+            if (Position < 0 || length > static_cast<uint64_t>(Size - std::min(Position, Size)))
+            {
+                std::memset(data, 0, length);
+                SetError();
+                return;
+            }
+
+            while (length)
+            {
+                size_t block = static_cast<size_t>(Position) / BlockSize;
+                if (!LoadBlock(block))
+                {
+                    std::memset(bytes, 0, length);
+                    SetError();
+                    return;
+                }
+
+                const std::vector<uint8_t>& source = DecodedBlocks[block - FirstDecodedBlock];
+                size_t offset = static_cast<size_t>(Position) % BlockSize;
+                size_t chunk = std::min(length, source.size() - offset);
+                std::memcpy(bytes, source.data() + offset, chunk);
+
+                Position += static_cast<int64_t>(chunk);
+                bytes += chunk;
+                length -= chunk;
+            }
+        }
+
+        void CompressedArchive::Close()
+        {
+            if (!IsSaving() || IsClosed)
+                return;
+
+            CompressPendingBlocks(true);
+            IsClosed = true;
+
+            uint64_t indexOffset = static_cast<uint64_t>(Inner.Tell() - DataStart);
+            for (BlockEntry& entry : Index)
+            {
+                Inner << entry.InnerOffset << entry.StoredSize << entry.RawSize;
+            }
+
+            uint64_t uncompressedSize = static_cast<uint64_t>(Size);
+            uint32_t numBlocks = static_cast<uint32_t>(Index.size());
+            uint32_t magic = Magic;
+            Inner << uncompressedSize << indexOffset << numBlocks << magic;
+
+            if (Inner.HasError())
+                SetError();
+        }
+
+        void CompressedArchive::CompressPendingBlocks(bool includeLast)
+        {
+            size_t count = includeLast ? PendingBlocks.size() : PendingBlocks.size() - std::min<size_t>(PendingBlocks.size(), 1);
+            if (count == 0)
+                return;
+
+            std::vector<std::vector<uint8_t>> compressed(count);
+            ThreadPool::Get().ParallelFor(count, 1, [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const std::vector<uint8_t>& raw = PendingBlocks[i];
+                    compressed[i].resize(Compression::CompressBound(raw.size()));
+                    // Keep the block raw unless compression saves something
+                    size_t size = Compression::Compress(raw.data(), raw.size(), compressed[i].data(), raw.size() - std::min<size_t>(raw.size(), 1));
+                    compressed[i].resize(size);
+                }
+            });
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                std::vector<uint8_t>& raw = PendingBlocks[i];
+                BlockEntry entry;
+                entry.InnerOffset = static_cast<uint64_t>(Inner.Tell() - DataStart);
+                entry.RawSize = static_cast<uint32_t>(raw.size());
+
+                if (!compressed[i].empty())
+                {
+                    entry.StoredSize = static_cast<uint32_t>(compressed[i].size());
+                    Inner.Serialize(compressed[i].data(), compressed[i].size());
+                }
+                else
+                {
+                    entry.StoredSize = static_cast<uint32_t>(raw.size()) | StoredRawFlag;
+                    if (!raw.empty())
+                        Inner.Serialize(raw.data(), raw.size());
+                }
+                Index.push_back(entry);
+            }
+
+            PendingBlocks.erase(PendingBlocks.begin(), PendingBlocks.begin() + count);
+            FirstPendingBlock += count;
+            if (Inner.HasError())
+                SetError();
+        }
+
+        void CompressedArchive::ReadIndex()
+        {
+            uint32_t magic = 0;
+            uint32_t version = 0;
+            uint32_t storedBlockSize = 0;
+            Inner << magic << version << storedBlockSize;
+            if (magic != Magic || version != Version || storedBlockSize == 0 || storedBlockSize > MaxBlockSize
+                || Inner.TotalSize() - DataStart < FooterSize)
+            {
+                SetError();
+                return;
+            }
+            BlockSize = storedBlockSize;
+
+            uint64_t uncompressedSize = 0;
+            uint64_t indexOffset = 0;
+            uint32_t numBlocks = 0;
+            Inner.Seek(Inner.TotalSize() - FooterSize);
+            Inner << uncompressedSize << indexOffset << numBlocks << magic;
+
+            int64_t indexEnd = Inner.TotalSize() - FooterSize - DataStart;
+            uint64_t entrySize = sizeof(uint64_t) + sizeof(uint32_t) * 2;
+            if (Inner.HasError() || magic != Magic || indexOffset > static_cast<uint64_t>(indexEnd)
+                || static_cast<uint64_t>(indexEnd) - indexOffset != numBlocks * entrySize
+                || uncompressedSize > static_cast<uint64_t>(numBlocks) * BlockSize)
+            {
+                SetError();
+                return;
+            }
+
+            Inner.Seek(DataStart + static_cast<int64_t>(indexOffset));
+            Index.resize(numBlocks);
+            uint64_t expectedRaw = uncompressedSize;
+            uint64_t expectedOffset = sizeof(uint32_t) * 3;
+            for (BlockEntry& entry : Index)
+            {
+                Inner << entry.InnerOffset << entry.StoredSize << entry.RawSize;
+
+                // Blocks are back to back after the header and full size except the last
+                uint64_t storedSize = entry.StoredSize & ~StoredRawFlag;
+                if (entry.RawSize != std::min<uint64_t>(expectedRaw, BlockSize) || entry.InnerOffset != expectedOffset
+                    || ((entry.StoredSize & StoredRawFlag) && storedSize != entry.RawSize))
+                {
+                    SetError();
+                    Index.clear();
+                    return;
+                }
+                expectedRaw -= entry.RawSize;
+                expectedOffset += storedSize;
+            }
+            if (expectedRaw != 0 || expectedOffset != indexOffset || Inner.HasError())
+            {
+                SetError();
+                Index.clear();
+                return;
+            }
+
+            Size = static_cast<int64_t>(uncompressedSize);
+        }
+
+        bool CompressedArchive::LoadBlock(size_t blockIndex)
+        {
+            if (blockIndex >= FirstDecodedBlock && blockIndex < FirstDecodedBlock + DecodedBlocks.size())
+                return true;
+            if (blockIndex >= Index.size())
+                return false;
+
+            // Reading on from the previous window decodes a batch ahead; random seeks decode one block
+            bool sequential = !DecodedBlocks.empty() && blockIndex == FirstDecodedBlock + DecodedBlocks.size();
+            size_t count = sequential ? std::min(GetBatchSize(), Index.size() - blockIndex) : 1;
+
+            const BlockEntry& first = Index[blockIndex];
+            const BlockEntry& last = Index[blockIndex + count - 1];
+            uint64_t storedEnd = last.InnerOffset + (last.StoredSize & ~StoredRawFlag);
+            std::vector<uint8_t> stored(static_cast<size_t>(storedEnd - first.InnerOffset));
+            Inner.Seek(DataStart + static_cast<int64_t>(first.InnerOffset));
+            if (!stored.empty())
+                Inner.Serialize(stored.data(), stored.size());
+            if (Inner.HasError())
+                return false;
+
+            DecodedBlocks.resize(count);
+            FirstDecodedBlock = blockIndex;
+
+            std::vector<uint8_t> failed(count, 0);
+            ThreadPool::Get().ParallelFor(count, 1, [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const BlockEntry& entry = Index[blockIndex + i];
+                    const uint8_t* source = stored.data() + (entry.InnerOffset - first.InnerOffset);
+                    uint32_t storedSize = entry.StoredSize & ~StoredRawFlag;
+
+                    std::vector<uint8_t>& decoded = DecodedBlocks[i];
+                    decoded.resize(entry.RawSize);
+                    if (entry.StoredSize & StoredRawFlag)
+                    {
+                        if (storedSize)
+                            std::memcpy(decoded.data(), source, storedSize);
+                    }
+                    else if (!Compression::Decompress(source, storedSize, decoded.data(), decoded.size()))
+                    {
+                        failed[i] = 1;
+                    }
+                }
+            });
+
+            if (std::find(failed.begin(), failed.end(), 1) != failed.end())
+            {
+                DecodedBlocks.clear();
+                return false;
+            }
+            return true;
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+// Titan::Core::CompressedArchive - Block-compressed stream on top of another archive
+// The uncompressed stream is cut into independent BlockSize blocks, each compressed with
+// Compression::Compress on the ThreadPool and followed by a block index, so a load can
+// seek anywhere while decompressing only the block that holds the data.
+//
+// Layout in the inner archive:
+//     Header  { Magic, Version, BlockSize }
+//     Blocks  (compressed, or stored raw when compression does not help)
+//     Index   { InnerOffset, StoredSize, RawSize } per block
+//     Footer  { UncompressedSize, IndexOffset, NumBlocks, Magic }
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Archive.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        class CompressedArchive : public Archive
+        {
+        public:
+            static constexpr size_t DefaultBlockSize = 256 * 1024;
+            static constexpr uint32_t Magic = 0x504D4354;   // "TCMP"
+            static constexpr uint32_t Version = 1;
+
+            // inner must be positioned where the compressed data starts (saving) or begins (loading)
+            // and outlive this archive. blockSize only matters when saving.
+            explicit CompressedArchive(Archive& inner, size_t blockSize = DefaultBlockSize);
+            ~CompressedArchive();
+
+            CompressedArchive(const CompressedArchive&) = delete;
+            CompressedArchive& operator=(const CompressedArchive&) = delete;
+
+            // Saving seeks may only target blocks that were not compressed yet
+            virtual void Seek(int64_t position) override;
+            virtual int64_t Tell() const override;
+            virtual int64_t TotalSize() const override;
+
+            virtual void Serialize(void* data, size_t length) override;
+
+            // Saving: compresses what is left and writes the index and footer. Called by the
+            // destructor if needed; the archive accepts no more data afterwards.
+            void Close();
+
+            size_t GetBlockSize() const { return BlockSize; }
+            size_t GetNumBlocks() const { return Index.size(); }
+
+        private:
+            struct BlockEntry
+            {
+                uint64_t InnerOffset = 0;
+                uint32_t StoredSize = 0;    // High bit set: stored uncompressed
+                uint32_t RawSize = 0;
+            };
+
+            static constexpr uint32_t StoredRawFlag = 0x80000000u;
+
+            // Save path
+            void CompressPendingBlocks(bool includeLast);
+
+            // Load path
+            void ReadIndex();
+            bool LoadBlock(size_t blockIndex);
+
+            Archive& Inner;
+            size_t BlockSize = DefaultBlockSize;
+            int64_t Position = 0;
+            int64_t Size = 0;
+            int64_t DataStart = 0;
+            bool IsClosed = false;
+            std::vector<BlockEntry> Index;
+
+            // Saving: uncompressed blocks starting at block index FirstPendingBlock, the last one
+            // still filling. Flushed in batches sized to the worker count.
+            std::vector<std::vector<uint8_t>> PendingBlocks;
+            size_t FirstPendingBlock = 0;
+
+            // Loading: decompressed window of consecutive blocks starting at FirstDecodedBlock.
+            // Sequential access widens the window so several blocks decompress in parallel.
+            std::vector<std::vector<uint8_t>> DecodedBlocks;
+            size_t FirstDecodedBlock = 0;
+        };
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
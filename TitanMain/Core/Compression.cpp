@@ -0,0 +1,208 @@
+#include "Compression.h"
+#include <cstring>
+
+namespace Titan
+{
+    namespace Core
+    {
+        namespace Compression
+        {
+            static constexpr size_t MinMatch = 4;
+            static constexpr size_t LastLiterals = 5;       // The format ends every block with literals
+            static constexpr size_t MatchSearchLimit = 12;  // No match may start in the last 12 bytes
+            static constexpr size_t MaxOffset = 65535;
+            static constexpr uint32_t HashBits = 14;
+
+            static inline uint32_t Read32(const uint8_t* data)
+            {
+                uint32_t value;
+                std::memcpy(&value, data, sizeof(value));
+                return value;
+            }
+
+            static inline uint32_t Hash(uint32_t sequence)
+            {
+                return (sequence * 2654435761u) >> (32 - HashBits);
+            }
+
+            // Writes the 255-run continuation of a length that did not fit its 4-bit token field
+            static inline uint8_t* WriteLength(uint8_t* output, size_t length)
+            {
+                for (; length >= 255; length -= 255)
+                {
+                    *output++ = 255;
+                }
+                *output++ = static_cast<uint8_t>(length);
+                return output;
+            }
+
+            // Emits one sequence; matchLength 0 means the final literal-only sequence
+            static inline bool EmitSequence(const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength,
+                                            uint8_t*& output, const uint8_t* outputEnd)
+            {
+                size_t worstCase = 1 + literalLength + literalLength / 255 + 1 + 2 + matchLength / 255 + 1;
+                if (worstCase > static_cast<size_t>(outputEnd - output))
+                    return false;
+
+                uint8_t* token = output++;
+                *token = static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4);
+                if (literalLength >= 15)
+                    output = WriteLength(output, literalLength - 15);
+
+                if (literalLength)
+                    std::memcpy(output, literals, literalLength);
+                output += literalLength;
+
+                if (matchLength == 0)
+                    return true;
+
+                *output++ = static_cast<uint8_t>(offset);
+                *output++ = static_cast<uint8_t>(offset >> 8);
+
+                size_t matchCode = matchLength - MinMatch;
+                *token |= static_cast<uint8_t>(matchCode >= 15 ? 15 : matchCode);
+                if (matchCode >= 15)
+                    output = WriteLength(output, matchCode - 15);
+                return true;
+            }
+
+            size_t Compress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationCapacity)
+            {
+                uint8_t* output = destination;
+                const uint8_t* outputEnd = destination + destinationCapacity;
+                size_t anchor = 0;
+
+                if (sourceSize > MatchSearchLimit)
+                {
+                    uint32_t table[1u << HashBits] = {};
+                    const size_t searchEnd = sourceSize - MatchSearchLimit;
+                    const size_t matchEnd = sourceSize - LastLiterals;
+
+                    size_t position = 1;
+                    uint32_t misses = 0;
+                    while (position < searchEnd)
+                    {
+                        uint32_t sequence = Read32(source + position);
+                        uint32_t& slot = table[Hash(sequence)];
+                        size_t candidate = slot;
+                        slot = static_cast<uint32_t>(position);
+
+                        if (candidate >= position || position - candidate > MaxOffset || Read32(source + candidate) != sequence)
+                        {
+                            // Skip faster through incompressible data
+                            position += 1 + (misses++ >> 6);
+                            continue;
+                        }
+                        misses = 0;
+
+                        while (position > anchor && candidate > 0 && source[position - 1] == source[candidate - 1])
+                        {
+                            --position;
+                            --candidate;
+                        }
+
+                        size_t length = MinMatch;
+                        while (position + length < matchEnd && source[position + length] == source[candidate + length])
+                        {
+                            ++length;
+                        }
+
+                        if (!EmitSequence(source + anchor, position - anchor, position - candidate, length, output, outputEnd))
+                            return 0;
+
+                        position += length;
+                        anchor = position;
+                        if (position - 2 < searchEnd)
+                            table[Hash(Read32(source + position - 2))] = static_cast<uint32_t>(position - 2);
+                    }
+                }
+
+                if (!EmitSequence(source + anchor, sourceSize - anchor, 0, 0, output, outputEnd))
+                    return 0;
+                return static_cast<size_t>(output - destination);
+            }
+
+            // Adds 255-run continuation bytes to length; false if the input ends first
+            static inline bool ReadLength(const uint8_t*& input, const uint8_t* inputEnd, size_t& length, size_t limit)
+            {
+                uint8_t byte;
+                do
+                {
+                    if (input == inputEnd || length > limit)
+                        return false;
+                    byte = *input++;
+                    length += byte;
+                } while (byte == 255);
+                return true;
+            }
+
+            bool Decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize)
+            {
+                const uint8_t* input = source;
+                const uint8_t* inputEnd = source + sourceSize;
+                uint8_t* output = destination;
+                uint8_t* outputEnd = destination + destinationSize;
+
+                while (input < inputEnd)
+                {
+                    uint8_t token = *input++;
+
+                    size_t literalLength = token >> 4;
+                    if (literalLength == 15 && !ReadLength(input, inputEnd, literalLength, destinationSize))
+                        return false;
+                    if (literalLength > static_cast<size_t>(inputEnd - input) || literalLength > static_cast<size_t>(outputEnd - output))
+                        return false;
+
+                    if (literalLength)
+                        std::memcpy(output, input, literalLength);
+                    input += literalLength;
+                    output += literalLength;
+
+                    if (input == inputEnd)
+                        break;
+
+                    if (inputEnd - input < 2)
+                        return false;
+                    size_t offset = input[0] | (static_cast<size_t>(input[1]) << 8);
+                    input += 2;
+                    if (offset == 0 || offset > static_cast<size_t>(output - destination))
+                        return false;
+
+                    size_t matchLength = token & 15;
+                    if (matchLength == 15 && !ReadLength(input, inputEnd, matchLength, destinationSize))
+                        return false;
+                    matchLength += MinMatch;
+                    if (matchLength > static_cast<size_t>(outputEnd - output))
+                        return false;
+
+                    const uint8_t* match = output - offset;
+                    if (offset >= matchLength)
+                    {
+                        std::memcpy(output, match, matchLength);
+                        output += matchLength;
+                    }
+                    else
+                    {
+                        // Overlapping copy repeats the last offset bytes
+                        uint8_t* copyEnd = output + matchLength;
+                        if (offset >= 8)
+                        {
+                            for (; copyEnd - output >= 8; output += 8, match += 8)
+                            {
+                                std::memcpy(output, match, 8);
+                            }
+                        }
+                        while (output < copyEnd)
+                        {
+                            *output++ = *match++;
+                        }
+                    }
+                }
+
+                return output == outputEnd;
+            }
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
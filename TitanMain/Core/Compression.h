@@ -0,0 +1,31 @@
+#pragma once
+
+// Titan::Core::Compression - Fast block compression
+// In-house codec producing the LZ4 block format: greedy hash-chain-free matching, byte-aligned
+// tokens, no entropy stage. Meant for data that is compressed once and decompressed often.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Titan
+{
+    namespace Core
+    {
+        namespace Compression
+        {
+            // Worst-case compressed size of sourceSize bytes
+            constexpr size_t CompressBound(size_t sourceSize)
+            {
+                return sourceSize + sourceSize / 255 + 16;
+            }
+
+            // Returns the compressed size, or 0 if it does not fit in destinationCapacity
+            size_t Compress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationCapacity);
+
+            // Decompresses exactly destinationSize bytes; false on malformed or truncated input
+            bool Decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize);
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
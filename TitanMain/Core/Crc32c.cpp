@@ -0,0 +1,188 @@
+#include "Crc32c.h"
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <nmmintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define TITAN_CRC32C_TARGET
+    #else
+        #define TITAN_CRC32C_TARGET __attribute__((target("sse4.2")))
+    #endif
+    #define TITAN_CRC32C_SSE42 1
+#elif defined(__ARM_FEATURE_CRC32) || defined(_M_ARM64)
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <arm_acle.h>
+    #endif
+    #define TITAN_CRC32C_ARM 1
+#endif
+
+namespace Titan
+{
+    namespace Core
+    {
+        namespace Crc32c
+        {
+            // Reflected Castagnoli polynomial
+            static constexpr uint32_t Polynomial = 0x82F63B78u;
+
+            // Table[k][b]: CRC of byte b followed by k zero bytes
+            static constexpr std::array<std::array<uint32_t, 256>, 8> MakeTables()
+            {
+                std::array<std::array<uint32_t, 256>, 8> tables{};
+                for (uint32_t byte = 0; byte < 256; ++byte)
+                {
+                    uint32_t crc = byte;
+                    for (int bit = 0; bit < 8; ++bit)
+                    {
+                        crc = (crc >> 1) ^ (Polynomial & (0u - (crc & 1u)));
+                    }
+                    tables[0][byte] = crc;
+                }
+                for (size_t k = 1; k < 8; ++k)
+                {
+                    for (uint32_t byte = 0; byte < 256; ++byte)
+                    {
+                        uint32_t previous = tables[k - 1][byte];
+                        tables[k][byte] = (previous >> 8) ^ tables[0][previous & 0xFF];
+                    }
+                }
+                return tables;
+            }
+
+            static constexpr std::array<std::array<uint32_t, 256>, 8> Tables = MakeTables();
+
+            // Little-endian word loads, like every platform Titan targets
+            static uint32_t UpdateSlicing8(uint32_t crc, const uint8_t* bytes, size_t size)
+            {
+                while (size && (reinterpret_cast<uintptr_t>(bytes) & 7))
+                {
+                    crc = (crc >> 8) ^ Tables[0][(crc ^ *bytes++) & 0xFF];
+                    --size;
+                }
+
+                for (; size >= 8; size -= 8, bytes += 8)
+                {
+                    uint32_t low;
+                    uint32_t high;
+                    std::memcpy(&low, bytes, sizeof(low));
+                    std::memcpy(&high, bytes + 4, sizeof(high));
+                    low ^= crc;
+                    crc = Tables[7][low & 0xFF] ^ Tables[6][(low >> 8) & 0xFF] ^ Tables[5][(low >> 16) & 0xFF] ^ Tables[4][low >> 24]
+                        ^ Tables[3][high & 0xFF] ^ Tables[2][(high >> 8) & 0xFF] ^ Tables[1][(high >> 16) & 0xFF] ^ Tables[0][high >> 24];
+                }
+
+                while (size--)
+                {
+                    crc = (crc >> 8) ^ Tables[0][(crc ^ *bytes++) & 0xFF];
+                }
+                return crc;
+            }
+
+#if TITAN_CRC32C_SSE42
+            TITAN_CRC32C_TARGET
+            static uint32_t UpdateHardware(uint32_t crc, const uint8_t* bytes, size_t size)
+            {
+                while (size && (reinterpret_cast<uintptr_t>(bytes) & 7))
+                {
+                    crc = _mm_crc32_u8(crc, *bytes++);
+                    --size;
+                }
+
+                uint64_t crc64 = crc;
+                for (; size >= 8; size -= 8, bytes += 8)
+                {
+                    uint64_t word;
+                    std::memcpy(&word, bytes, sizeof(word));
+                    crc64 = _mm_crc32_u64(crc64, word);
+                }
+                crc = static_cast<uint32_t>(crc64);
+
+                while (size--)
+                {
+                    crc = _mm_crc32_u8(crc, *bytes++);
+                }
+                return crc;
+            }
+
+            static bool HasHardwareSupport()
+            {
+    #if defined(_MSC_VER)
+                int info[4];
+                __cpuid(info, 1);
+                return (info[2] & (1 << 20)) != 0;
+    #else
+                return __builtin_cpu_supports("sse4.2");
+    #endif
+            }
+#elif TITAN_CRC32C_ARM
+            static uint32_t UpdateHardware(uint32_t crc, const uint8_t* bytes, size_t size)
+            {
+                while (size && (reinterpret_cast<uintptr_t>(bytes) & 7))
+                {
+                    crc = __crc32cb(crc, *bytes++);
+                    --size;
+                }
+
+                for (; size >= 8; size -= 8, bytes += 8)
+                {
+                    uint64_t word;
+                    std::memcpy(&word, bytes, sizeof(word));
+                    crc = __crc32cd(crc, word);
+                }
+
+                while (size--)
+                {
+                    crc = __crc32cb(crc, *bytes++);
+                }
+                return crc;
+            }
+
+            static bool HasHardwareSupport()
+            {
+                return true;
+            }
+#endif
+
+            using UpdateFunction = uint32_t (*)(uint32_t crc, const uint8_t* bytes, size_t size);
+
+            static UpdateFunction SelectImplementation()
+            {
+#if TITAN_CRC32C_SSE42 || TITAN_CRC32C_ARM
+                if (HasHardwareSupport())
+                    return &UpdateHardware;
+#endif
+                return &UpdateSlicing8;
+            }
+
+            // Safe to call from other static initializers
+            static UpdateFunction GetImplementation()
+            {
+                static const UpdateFunction implementation = SelectImplementation();
+                return implementation;
+            }
+
+            uint32_t Update(uint32_t crc, const void* data, size_t size)
+            {
+                return ~GetImplementation()(~crc, static_cast<const uint8_t*>(data), size);
+            }
+
+            const char* GetImplementationName()
+            {
+                if (GetImplementation() == &UpdateSlicing8)
+                    return "slicing-by-8";
+#if TITAN_CRC32C_SSE42
+                return "sse4.2";
+#else
+                return "arm-crc";
+#endif
+            }
+
+        } // namespace Crc32c
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+// Titan::Core::Crc32c - CRC32C (Castagnoli) checksums
+// Uses the SSE4.2 crc32 instruction or the ARMv8 CRC extension when the CPU has it, and
+// slicing-by-8 tables otherwise. x86 builds pick the implementation at runtime, so they do not
+// need to be compiled with SSE4.2 enabled.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Titan
+{
+    namespace Core
+    {
+        namespace Crc32c
+        {
+            // Continues a checksum over more data; start with 0
+            uint32_t Update(uint32_t crc, const void* data, size_t size);
+
+            inline uint32_t Compute(const void* data, size_t size) { return Update(0, data, size); }
+
+            // "sse4.2", "arm-crc" or "slicing-by-8"
+            const char* GetImplementationName();
+
+        } // namespace Crc32c
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
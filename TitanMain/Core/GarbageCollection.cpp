@@ -0,0 +1,276 @@
+#include "GarbageCollection.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Titan
+{
+    namespace Core
+    {
+        GarbageCollector& GarbageCollector::Get()
+        {
+            static GarbageCollector instance;
+            return instance;
+        }
+
+        void GarbageCollector::MarkObject(Object* object, int32_t referencerCluster, BitArray& reachable)
+        {
+            int32_t index = object->GetInternalIndex();
+            if (index == InvalidObjectIndex || object->IsPendingKill())
+                return;
+
+            int32_t clusterIndex = object->ClusterIndex;
+            if (clusterIndex != InvalidObjectIndex)
+            {
+                ObjectCluster& cluster = Clusters[clusterIndex];
+                if (referencerCluster != clusterIndex && index != cluster.RootIndex)
+                {
+                    // Individually referenced from outside, stop treating the members as a unit
+                    cluster.NeedsDissolving = true;
+                }
+
+                if (reachable.Get(cluster.RootIndex))
+                    return;
+
+                // One node for the whole cluster, the root stands in for every member on the mark stack
+                ObjectRegistry& registry = ObjectRegistry::Get();
+                for (int32_t memberIndex : cluster.Objects)
+                {
+                    Object* member = registry.GetObjectAt(memberIndex);
+                    if (member && member->ClusterIndex == clusterIndex)
+                        reachable.Set(memberIndex);
+                }
+                MarkStack.push_back(registry.GetObjectAt(cluster.RootIndex));
+                return;
+            }
+
+            if (reachable.Get(index))
+                return;
+
+            reachable.Set(index);
+            MarkStack.push_back(object);
+        }
+
+        void GarbageCollector::MarkReferences(Object* object, int32_t referencerCluster, BitArray& reachable)
+        {
+            if (Object* outer = object->GetOuter())
+            {
+                MarkObject(outer, referencerCluster, reachable);
+            }
+
+            if (Class* objectClass = object->GetClass())
+            {
+                objectClass->GetReferenceTokenStream().ForEachReference(object, [&](Object* reference)
+                {
+                    MarkObject(reference, referencerCluster, reachable);
+                });
+            }
+        }
+
+        void GarbageCollector::MarkReachableObjects(BitArray& outReachable)
+        {
+            ObjectRegistry& registry = ObjectRegistry::Get();
+
+            outReachable.Resize(registry.GetSlotCount());
+            outReachable.Reset();
+            MarkStack.clear();
+
+            BitArray roots = registry.GetFlagBits(ObjectFlags::MarkAsRootSet);
+            roots |= registry.GetFlagBits(ObjectFlags::Standalone);
+            registry.ForEachObject(roots, [&](Object* object) { MarkObject(object, InvalidObjectIndex, outReachable); });
+
+            while (!MarkStack.empty())
+            {
+                Object* object = MarkStack.back();
+                MarkStack.pop_back();
+
+                int32_t clusterIndex = object->ClusterIndex;
+                if (clusterIndex != InvalidObjectIndex)
+                {
+                    // Cluster root - only the references leaving the cluster are followed
+                    if (Clusters[clusterIndex].IsDirty)
+                        CollectClusterReferences(clusterIndex);
+
+                    for (const ClusterReference& reference : Clusters[clusterIndex].ReferencedObjects)
+                    {
+                        Object* referenced = registry.GetObjectAt(reference.Index);
+                        if (referenced && referenced == reference.Referenced)
+                            MarkObject(referenced, clusterIndex, outReachable);
+                    }
+                    continue;
+                }
+
+                MarkReferences(object, InvalidObjectIndex, outReachable);
+            }
+
+            // Clusters stay whole for this pass (conservative), their members are tracked individually from now on
+            for (int32_t clusterIndex = 0; clusterIndex < static_cast<int32_t>(Clusters.size()); ++clusterIndex)
+            {
+                if (Clusters[clusterIndex].NeedsDissolving)
+                    DissolveCluster(clusterIndex);
+            }
+        }
+
+        size_t GarbageCollector::CollectGarbage()
+        {
+            ObjectRegistry& registry = ObjectRegistry::Get();
+
+            BitArray unreachable;
+            MarkReachableObjects(unreachable);
+
+            // Flip to the set of unreachable slots
+            BitArray reachable = std::move(unreachable);
+            unreachable = registry.GetAllObjectBits();
+            unreachable.AndNot(reachable);
+
+            std::vector<Object*> garbage;
+            garbage.reserve(unreachable.CountSetBits());
+            registry.ForEachObject(unreachable, [&](Object* object) { garbage.push_back(object); });
+
+            for (Object* object : garbage)
+            {
+                Object::DestroyObject(object);
+            }
+            return garbage.size();
+        }
+
+        void GarbageCollector::CreateClustersForLoadedObjects(const std::vector<Object*>& loadedObjects)
+        {
+            std::unordered_set<Object*> loaded(loadedObjects.begin(), loadedObjects.end());
+            std::unordered_map<Object*, std::vector<Object*>> groups;
+            for (Object* object : loadedObjects)
+            {
+                if (!object || !object->HasFlags(ObjectFlags::WasLoaded) || object->ClusterIndex != InvalidObjectIndex)
+                    continue;
+
+                // Root on the outermost object of this same load, outers above it may be long-lived
+                // objects that merely contain the loaded ones
+                Object* root = object;
+                for (Object* outer = object->GetOuter(); outer; outer = outer->GetOuter())
+                {
+                    if (loaded.count(outer) && outer->HasFlags(ObjectFlags::WasLoaded) && outer->ClusterIndex == InvalidObjectIndex)
+                        root = outer;
+                }
+                groups[root].push_back(object);
+            }
+
+            for (auto& group : groups)
+            {
+                if (group.second.size() > 1)
+                    CreateCluster(group.first, group.second);
+            }
+        }
+
+        int32_t GarbageCollector::CreateCluster(Object* root, const std::vector<Object*>& members)
+        {
+            if (!root || root->GetInternalIndex() == InvalidObjectIndex || root->ClusterIndex != InvalidObjectIndex)
+                return InvalidObjectIndex;
+
+            int32_t clusterIndex;
+            if (!FreeClusters.empty())
+            {
+                clusterIndex = FreeClusters.back();
+                FreeClusters.pop_back();
+            }
+            else
+            {
+                clusterIndex = static_cast<int32_t>(Clusters.size());
+                Clusters.emplace_back();
+            }
+
+            ObjectCluster& cluster = Clusters[clusterIndex];
+            cluster = ObjectCluster();
+            cluster.RootIndex = root->GetInternalIndex();
+            cluster.Objects.push_back(cluster.RootIndex);
+            root->ClusterIndex = clusterIndex;
+
+            for (Object* member : members)
+            {
+                // Root set members would be referenced individually and dissolve the cluster right away
+                if (!member || member->ClusterIndex != InvalidObjectIndex || member->GetInternalIndex() == InvalidObjectIndex ||
+                    member->HasFlags(ObjectFlags::MarkAsRootSet))
+                    continue;
+
+                member->ClusterIndex = clusterIndex;
+                cluster.Objects.push_back(member->GetInternalIndex());
+            }
+
+            CollectClusterReferences(clusterIndex);
+            return clusterIndex;
+        }
+
+        void GarbageCollector::CollectClusterReferences(int32_t clusterIndex)
+        {
+            ObjectRegistry& registry = ObjectRegistry::Get();
+            ObjectCluster& cluster = Clusters[clusterIndex];
+
+            std::vector<Object*> referenced;
+            auto addReference = [&](Object* reference)
+            {
+                if (reference->ClusterIndex != clusterIndex)
+                    referenced.push_back(reference);
+            };
+
+            for (int32_t memberIndex : cluster.Objects)
+            {
+                Object* member = registry.GetObjectAt(memberIndex);
+                if (!member || member->ClusterIndex != clusterIndex)
+                    continue;
+
+                if (Object* outer = member->GetOuter())
+                {
+                    addReference(outer);
+                }
+                if (Class* objectClass = member->GetClass())
+                {
+                    objectClass->GetReferenceTokenStream().ForEachReference(member, addReference);
+                }
+            }
+
+            std::sort(referenced.begin(), referenced.end());
+            referenced.erase(std::unique(referenced.begin(), referenced.end()), referenced.end());
+
+            cluster.ReferencedObjects.clear();
+            cluster.ReferencedObjects.reserve(referenced.size());
+            for (Object* reference : referenced)
+            {
+                if (reference->GetInternalIndex() != InvalidObjectIndex)
+                    cluster.ReferencedObjects.push_back({ reference->GetInternalIndex(), reference });
+            }
+            cluster.IsDirty = false;
+        }
+
+        void GarbageCollector::DissolveCluster(int32_t clusterIndex)
+        {
+            if (clusterIndex < 0 || clusterIndex >= static_cast<int32_t>(Clusters.size()) || Clusters[clusterIndex].RootIndex == InvalidObjectIndex)
+                return;
+
+            ObjectRegistry& registry = ObjectRegistry::Get();
+            ObjectCluster& cluster = Clusters[clusterIndex];
+            for (int32_t memberIndex : cluster.Objects)
+            {
+                Object* member = registry.GetObjectAt(memberIndex);
+                if (member && member->ClusterIndex == clusterIndex)
+                    member->ClusterIndex = InvalidObjectIndex;
+            }
+
+            cluster = ObjectCluster();
+            FreeClusters.push_back(clusterIndex);
+        }
+
+        void GarbageCollector::MarkClusterDirty(Object* object)
+        {
+            if (object && object->ClusterIndex != InvalidObjectIndex)
+                Clusters[object->ClusterIndex].IsDirty = true;
+        }
+
+        const ObjectCluster* GarbageCollector::GetCluster(int32_t clusterIndex) const
+        {
+            if (clusterIndex < 0 || clusterIndex >= static_cast<int32_t>(Clusters.size()) || Clusters[clusterIndex].RootIndex == InvalidObjectIndex)
+                return nullptr;
+            return &Clusters[clusterIndex];
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+// Titan::Core::GarbageCollection - Mark & sweep over registered objects
+// Marking follows each Class's reference token stream, reachability bits are keyed by object slot
+
+#include <vector>
+#include "BitArray.h"
+#include "Object.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        // Reference from a cluster member to an object outside the cluster. The pointer tells a live
+        // entry from a slot that has been reused by another object since.
+        struct ClusterReference
+        {
+            int32_t Index = InvalidObjectIndex;
+            Object* Referenced = nullptr;
+        };
+
+        // Objects loaded together and kept alive as a unit. Reaching any member marks the whole
+        // cluster and only the references leaving it, collected when the cluster is made, are followed.
+        // Clusters are treated as immutable: code storing a reference into a member afterwards must
+        // call GarbageCollector::MarkClusterDirty so the list is collected again before the next mark.
+        struct ObjectCluster
+        {
+            int32_t RootIndex = InvalidObjectIndex;     // Slot of the cluster root
+            std::vector<int32_t> Objects;               // Member slots, root included
+            std::vector<ClusterReference> ReferencedObjects;
+            bool IsDirty = false;                       // Members changed references since ReferencedObjects was collected
+            bool NeedsDissolving = false;               // A member was referenced from outside the cluster
+        };
+
+        class GarbageCollector
+        {
+        public:
+            static GarbageCollector& Get();
+
+            // Sets a bit for every object reachable from the roots (MarkAsRootSet or Standalone)
+            // through outers and reflected references
+            void MarkReachableObjects(BitArray& outReachable);
+
+            // Destroys every registered object that is not reachable, returns how many were destroyed
+            size_t CollectGarbage();
+
+            // Clusters
+            // Groups freshly loaded objects (WasLoaded) under their outermost outer from the same list and
+            // makes one cluster per group, rooted on that outer
+            void CreateClustersForLoadedObjects(const std::vector<Object*>& loadedObjects);
+            int32_t CreateCluster(Object* root, const std::vector<Object*>& members);
+            void DissolveCluster(int32_t clusterIndex);
+
+            // Write barrier for clustered objects, call after storing a reference into object
+            void MarkClusterDirty(Object* object);
+
+            const ObjectCluster* GetCluster(int32_t clusterIndex) const;
+            size_t GetClusterCount() const { return Clusters.size() - FreeClusters.size(); }
+
+        private:
+            GarbageCollector() = default;
+            ~GarbageCollector() = default;
+
+            void MarkObject(Object* object, int32_t referencerCluster, BitArray& reachable);
+            void MarkReferences(Object* object, int32_t referencerCluster, BitArray& reachable);
+            void CollectClusterReferences(int32_t clusterIndex);
+
+            std::vector<Object*> MarkStack;
+            std::vector<ObjectCluster> Clusters;
+            std::vector<int32_t> FreeClusters;
+        };
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include "LazyLoading.h"
+#include <mutex>
+#include "Object.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        // A lazy handle is (Generation << LazyHandleIndexBits | index) << 1 | LazyObjectTag. Entries
+        // are reused once their package goes away; the generation tells stale handles apart.
+        constexpr unsigned LazyHandleIndexBits = sizeof(uintptr_t) * 4;
+        constexpr uintptr_t LazyHandleIndexMask = (static_cast<uintptr_t>(1) << LazyHandleIndexBits) - 1;
+        constexpr uintptr_t LazyHandleGenerationMask = ~static_cast<uintptr_t>(0) >> (LazyHandleIndexBits + 1);
+
+        struct LazyHandleEntry
+        {
+            std::weak_ptr<LazyPackage> Package;
+            size_t ExportIndex = 0;
+            uintptr_t Generation = 0;
+        };
+
+        struct LazyHandleTable
+        {
+            std::mutex Mutex;
+            std::vector<LazyHandleEntry> Entries;
+            std::vector<size_t> FreeEntries;
+        };
+
+        static LazyHandleTable& GetLazyHandleTable()
+        {
+            static LazyHandleTable table;
+            return table;
+        }
+
+        // Caller holds the table mutex; nullptr for stale or foreign handles
+        static LazyHandleEntry* FindLazyHandleEntry(LazyHandleTable& table, uintptr_t handle)
+        {
+            uintptr_t value = handle >> 1;
+            size_t index = static_cast<size_t>(value & LazyHandleIndexMask);
+            if (index >= table.Entries.size())
+                return nullptr;
+
+            LazyHandleEntry& entry = table.Entries[index];
+            return entry.Generation == ((value >> LazyHandleIndexBits) & LazyHandleGenerationMask) ? &entry : nullptr;
+        }
+
+        Object* ResolveLazyObject(uintptr_t handle)
+        {
+            std::shared_ptr<LazyPackage> package;
+            size_t exportIndex = 0;
+            {
+                LazyHandleTable& table = GetLazyHandleTable();
+                std::lock_guard<std::mutex> lock(table.Mutex);
+                if (LazyHandleEntry* entry = FindLazyHandleEntry(table, handle))
+                {
+                    package = entry->Package.lock();
+                    exportIndex = entry->ExportIndex;
+                }
+            }
+            return package ? package->LoadExport(exportIndex) : nullptr;
+        }
+
+        std::string GetLazyObjectName(uintptr_t handle)
+        {
+            std::shared_ptr<LazyPackage> package;
+            size_t exportIndex = 0;
+            {
+                LazyHandleTable& table = GetLazyHandleTable();
+                std::lock_guard<std::mutex> lock(table.Mutex);
+                if (LazyHandleEntry* entry = FindLazyHandleEntry(table, handle))
+                {
+                    package = entry->Package.lock();
+                    exportIndex = entry->ExportIndex;
+                }
+            }
+            return package ? package->GetLoader().GetExportFullName(exportIndex) : std::string();
+        }
+
+        std::shared_ptr<LazyPackage> LazyPackage::Open(const std::string& filename)
+        {
+            std::shared_ptr<LazyPackage> package(new LazyPackage());
+            package->Filename = filename;
+            package->File = std::make_unique<FileArchive>(filename, FileArchive::LoadMode::MemoryMapped);
+            if (!package->File->IsOpen())
+                return nullptr;
+
+            package->Loader = std::make_unique<PackageLoader>(*package->File);
+            if (!package->Loader->IsValid())
+                return nullptr;
+
+            size_t numExports = package->Loader->GetExports().size();
+            package->Handles.assign(numExports, 0);
+            package->LoadedObjects.resize(numExports);
+
+            LazyPackage* raw = package.get();
+            package->Loader->SetLazyHandleProvider([raw](size_t exportIndex) { return raw->GetHandle(exportIndex); });
+            return package;
+        }
+
+        LazyPackage::~LazyPackage()
+        {
+            ReleaseHandles();
+        }
+
+        uintptr_t LazyPackage::GetHandle(size_t exportIndex)
+        {
+            if (!Handles[exportIndex])
+            {
+                LazyHandleTable& table = GetLazyHandleTable();
+                std::lock_guard<std::mutex> lock(table.Mutex);
+
+                size_t index;
+                if (!table.FreeEntries.empty())
+                {
+                    index = table.FreeEntries.back();
+                    table.FreeEntries.pop_back();
+                }
+                else if (table.Entries.size() <= LazyHandleIndexMask)
+                {
+                    index = table.Entries.size();
+                    table.Entries.emplace_back();
+                }
+                else
+                {
+                    // Table full, the reference loads right away instead
+                    return 0;
+                }
+
+                LazyHandleEntry& entry = table.Entries[index];
+                entry.Package = weak_from_this();
+                entry.ExportIndex = exportIndex;
+                Handles[exportIndex] = (((entry.Generation << LazyHandleIndexBits) | index) << 1) | LazyObjectTag;
+            }
+            return Handles[exportIndex];
+        }
+
+        void LazyPackage::ReleaseHandles()
+        {
+            LazyHandleTable& table = GetLazyHandleTable();
+            std::lock_guard<std::mutex> lock(table.Mutex);
+            for (uintptr_t& handle : Handles)
+            {
+                if (!handle)
+                    continue;
+
+                size_t index = static_cast<size_t>((handle >> 1) & LazyHandleIndexMask);
+                LazyHandleEntry& entry = table.Entries[index];
+                entry.Package.reset();
+                entry.Generation = (entry.Generation + 1) & LazyHandleGenerationMask;
+                table.FreeEntries.push_back(index);
+                handle = 0;
+            }
+        }
+
+        Object* LazyPackage::LoadObject(const std::string& fullName)
+        {
+            return Loader ? LoadExport(Loader->FindExport(fullName)) : nullptr;
+        }
+
+        Object* LazyPackage::LoadExport(size_t exportIndex)
+        {
+            if (!Loader || exportIndex >= LoadedObjects.size())
+                return nullptr;
+
+            if (LoadedObjects[exportIndex])
+                return LoadedObjects[exportIndex]->IsPendingKill() ? nullptr : LoadedObjects[exportIndex].Get();
+
+            std::vector<size_t> finished;
+            Object* object = Loader->LoadExport(exportIndex, &finished);
+
+            // Hold everything this load brought in, dependencies included
+            const std::vector<ObjectExport>& exports = Loader->GetExports();
+            for (size_t index : finished)
+            {
+                Object* loaded = exports[index].CreatedObject;
+                if (loaded && !LoadedObjects[index] && loaded->HasFlags(ObjectFlags::LoadCompleted))
+                    LoadedObjects[index] = loaded;
+            }
+            return object;
+        }
+
+        size_t LazyPackage::GetNumLoadedExports() const
+        {
+            size_t count = 0;
+            for (const ObjectPtr<Object>& loaded : LoadedObjects)
+            {
+                if (loaded)
+                    ++count;
+            }
+            return count;
+        }
+
+        void LazyPackage::Close()
+        {
+            ReleaseHandles();
+            LoadedObjects.clear();
+            Loader.reset();
+            File.reset();
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+// Titan::Core::LazyLoading - On-demand loading of package exports
+// A LazyPackage keeps a package file memory-mapped and loads exports one at a time. Loading an
+// export also loads what it cannot do without (its outers and raw Object* references), while
+// ObjectPtr references to exports that are not loaded yet become lazy handles. The first Get()
+// or dereference of such an ObjectPtr loads that export through its export table offset.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Archive.h"
+#include "Package.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        class LazyPackage : public std::enable_shared_from_this<LazyPackage>
+        {
+        public:
+            // nullptr if the file is missing or not a package
+            static std::shared_ptr<LazyPackage> Open(const std::string& filename);
+
+            ~LazyPackage();
+
+            LazyPackage(const LazyPackage&) = delete;
+            LazyPackage& operator=(const LazyPackage&) = delete;
+
+            // Loads one export by full name or index; nullptr if it does not exist or failed
+            Object* LoadObject(const std::string& fullName);
+            Object* LoadExport(size_t exportIndex);
+
+            const std::string& GetFilename() const { return Filename; }
+            const PackageLoader& GetLoader() const { return *Loader; }
+            size_t GetNumLoadedExports() const;
+
+            // Lazy handles created for this package resolve to null afterwards, as they do once
+            // the package is destroyed
+            void Close();
+
+        private:
+            LazyPackage() = default;
+
+            uintptr_t GetHandle(size_t exportIndex);
+            void ReleaseHandles();
+
+            std::string Filename;
+            std::unique_ptr<FileArchive> File;
+            std::unique_ptr<PackageLoader> Loader;
+            std::vector<uintptr_t> Handles;     // Per export, 0 until a lazy reference needs one
+
+            // Loaded exports are kept alive while the package is open; ones the GC destroyed
+            // since resolve to null
+            std::vector<ObjectPtr<Object>> LoadedObjects;
+        };
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "Name.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        NameTable& NameTable::Get()
+        {
+            static NameTable instance;
+            return instance;
+        }
+
+        const std::string& NameTable::Intern(std::string_view value)
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            auto found = Lookup.find(value);
+            if (found != Lookup.end())
+                return *found->second;
+
+            // Deque entries never move, so the lookup keys can view them
+            const std::string& entry = Entries.emplace_back(value);
+            Lookup.emplace(entry, &entry);
+            return entry;
+        }
+
+        size_t NameTable::GetNum() const
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            return Entries.size();
+        }
+
+        const std::string& Name::ToString() const
+        {
+            static const std::string none;
+            return Entry ? *Entry : none;
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+// Titan::Core::Name - Global table of interned strings
+// Every distinct string is stored once for the lifetime of the process, so a Name is a single
+// pointer and compares by identity. Used for strings that repeat across many objects (object,
+// class and tag names) and by archives in ArchiveFlags::StringTable mode.
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Titan
+{
+    namespace Core
+    {
+        class NameTable
+        {
+        public:
+            static NameTable& Get();
+
+            // The interned copy of value, valid until exit. Thread-safe.
+            const std::string& Intern(std::string_view value);
+
+            size_t GetNum() const;
+
+        private:
+            NameTable() = default;
+
+            mutable std::mutex Mutex;
+            std::deque<std::string> Entries;
+            std::unordered_map<std::string_view, const std::string*> Lookup;
+        };
+
+        class Name
+        {
+        public:
+            Name() = default;
+            Name(std::string_view value) : Entry(value.empty() ? nullptr : &NameTable::Get().Intern(value)) {}
+            Name(const char* value) : Name(std::string_view(value)) {}
+            Name(const std::string& value) : Name(std::string_view(value)) {}
+
+            // Archives hand out entries that are already interned
+            static Name FromInterned(const std::string* entry)
+            {
+                Name name;
+                name.Entry = entry && !entry->empty() ? entry : nullptr;
+                return name;
+            }
+
+            const std::string& ToString() const;
+            bool IsNone() const { return Entry == nullptr; }
+
+            bool operator==(const Name& other) const { return Entry == other.Entry; }
+            bool operator!=(const Name& other) const { return Entry != other.Entry; }
+
+            size_t GetHash() const { return std::hash<const std::string*>()(Entry); }
+
+        private:
+            const std::string* Entry = nullptr;
+        };
+
+    } // namespace Core
+
+} // namespace Titan
+
+namespace std
+{
+    template<>
+    struct hash<Titan::Core::Name>
+    {
+        size_t operator()(const Titan::Core::Name& name) const { return name.GetHash(); }
+    };
+}
\ No newline at end of file
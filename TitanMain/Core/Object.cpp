@@ -1,173 +1,570 @@
-#include "Object.h"
-#include <algorithm>
-
-namespace Titan
-{
-    namespace Core
-    {
-        // ObjectBase implementation
-        ObjectBase::ObjectBase()
-        {
-            RefCount.store(1); // Start with 1 reference
-        }
-
-        ObjectBase::~ObjectBase()
-        {
-            // Ensure we're not being destroyed while still referenced
-            // In a real implementation, this would be handled by GC
-        }
-
-        void ObjectBase::BeginDestroy()
-        {
-            AddFlags(ObjectFlags::BeginDestroyed);
-        }
-
-        void ObjectBase::FinishDestroy()
-        {
-            AddFlags(ObjectFlags::FinishDestroyed);
-        }
-
-        void ObjectBase::AddRef()
-        {
-            RefCount.fetch_add(1);
-        }
-
-        void ObjectBase::Release()
-        {
-            if (RefCount.fetch_sub(1) == 1)
-            {
-                // Last reference, object can be destroyed
-                delete this;
-            }
-        }
-
-        // Object implementation
-        Object::Object()
-        {
-            // Initialize basic object properties
-            AddFlags(ObjectFlags::NeedInitialization);
-        }
-
-        Object::~Object()
-        {
-            // Cleanup object
-        }
-
-        Object* Object::CreateObject(Class* objectClass, Object* outer, const std::string& name)
-        {
-            if (!objectClass)
-                return nullptr;
-
-            Object* newObject = objectClass->CreateObject(outer, name);
-            if (newObject)
-            {
-                ObjectRegistry::Get().RegisterObject(newObject);
-                newObject->PostInitProperties();
-            }
-            return newObject;
-        }
-
-        void Object::DestroyObject(Object* object)
-        {
-            if (!object)
-                return;
-
-            object->BeginDestroy();
-            ObjectRegistry::Get().UnregisterObject(object);
-            object->FinishDestroy();
-            object->Release();
-        }
-
-        std::string Object::GetFullName() const
-        {
-            std::string result = Name;
-            if (OuterPrivate)
-            {
-                result = OuterPrivate->GetFullName() + "." + result;
-            }
-            return result;
-        }
-
-        std::string Object::GetPathName() const
-        {
-            std::string result = Name;
-            if (OuterPrivate)
-            {
-                result = OuterPrivate->GetPathName() + "/" + result;
-            }
-            return result;
-        }
-
-        // Class implementation
-        Class::Class(const std::string& name, Class* superClass)
-            : Name(name), SuperClass(superClass)
-        {
-        }
-
-        Class::~Class()
-        {
-        }
-
-        Object* Class::CreateObject(Object* outer, const std::string& name)
-        {
-            // Base implementation - derived classes should override
-            // In a real implementation, this would use reflection or factory pattern
-            return nullptr;
-        }
-
-        // ObjectRegistry implementation
-        ObjectRegistry& ObjectRegistry::Get()
-        {
-            static ObjectRegistry instance;
-            return instance;
-        }
-
-        void ObjectRegistry::RegisterObject(Object* object)
-        {
-            if (!object)
-                return;
-
-            std::string name = object->GetFullName();
-            Objects[name] = object;
-
-            Class* objClass = object->GetClass();
-            if (objClass)
-            {
-                ObjectsByClass[objClass].push_back(object);
-            }
-        }
-
-        void ObjectRegistry::UnregisterObject(Object* object)
-        {
-            if (!object)
-                return;
-
-            std::string name = object->GetFullName();
-            Objects.erase(name);
-
-            Class* objClass = object->GetClass();
-            if (objClass)
-            {
-                auto& classObjects = ObjectsByClass[objClass];
-                classObjects.erase(
-                    std::remove(classObjects.begin(), classObjects.end(), object),
-                    classObjects.end()
-                );
-            }
-        }
-
-        Object* ObjectRegistry::FindObject(const std::string& name) const
-        {
-            auto it = Objects.find(name);
-            return it != Objects.end() ? it->second : nullptr;
-        }
-
-        std::vector<Object*> ObjectRegistry::GetObjectsOfClass(Class* objectClass) const
-        {
-            auto it = ObjectsByClass.find(objectClass);
-            return it != ObjectsByClass.end() ? it->second : std::vector<Object*>{};
-        }
-
-    } // namespace Core
-
+#include "Object.h"
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include "GarbageCollection.h"
+#include "PropertySerialization.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        // ObjectBase implementation
+        ObjectBase::ObjectBase()
+        {
+            RefCount.store(1); // Start with 1 reference
+        }
+
+        ObjectBase::~ObjectBase()
+        {
+            // Ensure we're not being destroyed while still referenced
+            // In a real implementation, this would be handled by GC
+        }
+
+        void ObjectBase::SetFlags(ObjectFlags flags)
+        {
+            UpdateFlags(flags);
+        }
+
+        void ObjectBase::AddFlags(ObjectFlags flags)
+        {
+            UpdateFlags(ObjectFlagsPrivate | flags);
+        }
+
+        void ObjectBase::RemoveFlags(ObjectFlags flags)
+        {
+            UpdateFlags(ObjectFlagsPrivate & ~flags);
+        }
+
+        void ObjectBase::UpdateFlags(ObjectFlags newFlags)
+        {
+            ObjectFlags oldFlags = ObjectFlagsPrivate;
+            ObjectFlagsPrivate = newFlags;
+
+            // Keep the registry flag bitsets in sync
+            if (InternalIndex != InvalidObjectIndex && oldFlags != newFlags)
+            {
+                ObjectRegistry::Get().OnFlagsChanged(this, oldFlags, newFlags);
+            }
+        }
+
+        void ObjectBase::BeginDestroy()
+        {
+            AddFlags(ObjectFlags::BeginDestroyed);
+        }
+
+        void ObjectBase::FinishDestroy()
+        {
+            AddFlags(ObjectFlags::FinishDestroyed);
+        }
+
+        void ObjectBase::AddRef()
+        {
+            RefCount.fetch_add(1);
+        }
+
+        void ObjectBase::Release()
+        {
+            if (RefCount.fetch_sub(1) == 1)
+            {
+                // Last reference, object can be destroyed
+                delete this;
+            }
+        }
+
+        // Object implementation
+        Object::Object()
+        {
+            // Initialize basic object properties
+            AddFlags(ObjectFlags::NeedInitialization);
+        }
+
+        Object::~Object()
+        {
+            // Cleanup object
+        }
+
+        Class* Object::StaticClassPrivate = Object::RegisterStaticClass();
+
+        Class* Object::RegisterStaticClass()
+        {
+            static NativeClass<Object> s_Class("Object", nullptr);
+            return &s_Class;
+        }
+
+        Object* Object::CreateObject(Class* objectClass, Object* outer, const std::string& name)
+        {
+            if (!objectClass)
+                return nullptr;
+
+            Object* newObject = objectClass->CreateObject(outer, name);
+            if (newObject)
+            {
+                // Factories may leave these unset, the registry indexes by class
+                if (!newObject->ClassPrivate)
+                    newObject->ClassPrivate = objectClass;
+                if (!newObject->OuterPrivate)
+                    newObject->OuterPrivate = outer;
+                if (newObject->Name.empty())
+                    newObject->Name = name;
+
+                ObjectRegistry::Get().RegisterObject(newObject);
+                newObject->PostInitProperties();
+            }
+            return newObject;
+        }
+
+        void Object::DestroyObject(Object* object)
+        {
+            if (!object)
+                return;
+
+            object->BeginDestroy();
+            if (object->GetClusterIndex() != InvalidObjectIndex)
+            {
+                // Cluster bookkeeping refers to member slots, which are about to be freed
+                GarbageCollector::Get().DissolveCluster(object->GetClusterIndex());
+            }
+            ObjectRegistry::Get().UnregisterObject(object);
+            object->FinishDestroy();
+            object->Release();
+        }
+
+        void Object::Serialize(Archive& archive)
+        {
+            SerializeProperties(archive, this);
+        }
+
+        std::string Object::GetFullName() const
+        {
+            std::string result = Name;
+            if (OuterPrivate)
+            {
+                result = OuterPrivate->GetFullName() + "." + result;
+            }
+            return result;
+        }
+
+        std::string Object::GetPathName() const
+        {
+            std::string result = Name;
+            if (OuterPrivate)
+            {
+                result = OuterPrivate->GetPathName() + "/" + result;
+            }
+            return result;
+        }
+
+        // Game thread
+        static std::atomic<std::thread::id>& GetGameThreadId()
+        {
+            static std::atomic<std::thread::id> id;
+            return id;
+        }
+
+        void SetGameThread()
+        {
+            GetGameThreadId().store(std::this_thread::get_id());
+        }
+
+        bool IsInGameThread()
+        {
+            std::thread::id current = std::this_thread::get_id();
+            std::thread::id expected;
+            return GetGameThreadId().compare_exchange_strong(expected, current) || expected == current;
+        }
+
+        // Class implementation
+        static std::vector<Class*>& GetRegisteredClasses()
+        {
+            static std::vector<Class*> s_Classes;
+            return s_Classes;
+        }
+
+        // Guards the registered classes and the class tree numbering
+        static std::mutex& GetClassRegistryMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::atomic<uint32_t> Class::ClassTreeSequence{0};
+
+        Class::Class(const std::string& name, Class* superClass)
+            : Name(name), SuperClass(superClass)
+        {
+            std::lock_guard<std::mutex> lock(GetClassRegistryMutex());
+            GetRegisteredClasses().push_back(this);
+            InvalidateClassTree();
+        }
+
+        Class* Class::FindClass(const std::string& name)
+        {
+            std::lock_guard<std::mutex> lock(GetClassRegistryMutex());
+            for (Class* registered : GetRegisteredClasses())
+            {
+                if (registered->Name == name)
+                    return registered;
+            }
+            return nullptr;
+        }
+
+        Class::~Class()
+        {
+            if (DefaultObject)
+                DefaultObject->Release();
+
+            std::lock_guard<std::mutex> lock(GetClassRegistryMutex());
+            auto& classes = GetRegisteredClasses();
+            classes.erase(std::remove(classes.begin(), classes.end(), this), classes.end());
+            InvalidateClassTree();
+        }
+
+        void Class::InvalidateClassTree()
+        {
+            // Registry mutex held
+            uint32_t sequence = ClassTreeSequence.load(std::memory_order_relaxed);
+            if ((sequence & 1) == 0)
+                ClassTreeSequence.store(sequence + 1, std::memory_order_relaxed);
+        }
+
+        uint32_t Class::RebuildClassTree()
+        {
+            std::lock_guard<std::mutex> lock(GetClassRegistryMutex());
+            uint32_t sequence = ClassTreeSequence.load(std::memory_order_relaxed);
+            if ((sequence & 1) == 0)
+                return sequence;
+
+            // Readers that started before the registration see the sequence change and retry
+            std::atomic_thread_fence(std::memory_order_release);
+
+            const auto& classes = GetRegisteredClasses();
+
+            std::unordered_map<const Class*, std::vector<Class*>> children;
+            std::vector<Class*> roots;
+            for (Class* registered : classes)
+            {
+                if (registered->SuperClass)
+                    children[registered->SuperClass].push_back(registered);
+                else
+                    roots.push_back(registered);
+            }
+
+            // Depth-first numbering so each subtree is a contiguous index range
+            int32_t nextIndex = 0;
+            std::vector<std::pair<Class*, bool>> stack;
+            for (auto it = roots.rbegin(); it != roots.rend(); ++it)
+            {
+                stack.emplace_back(*it, false);
+            }
+            while (!stack.empty())
+            {
+                auto [current, visited] = stack.back();
+                stack.pop_back();
+
+                if (visited)
+                {
+                    current->ClassTreeNumChildren.store(nextIndex - current->ClassTreeIndex.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+                    continue;
+                }
+
+                current->ClassTreeIndex.store(nextIndex++, std::memory_order_relaxed);
+                stack.emplace_back(current, true);
+
+                auto found = children.find(current);
+                if (found != children.end())
+                {
+                    for (auto it = found->second.rbegin(); it != found->second.rend(); ++it)
+                    {
+                        stack.emplace_back(*it, false);
+                    }
+                }
+            }
+
+            ClassTreeSequence.store(sequence + 1, std::memory_order_release);
+            return sequence + 1;
+        }
+
+        std::vector<std::string> Class::GetPropertyNames() const
+        {
+            std::vector<std::string> names = SuperClass ? SuperClass->GetPropertyNames() : std::vector<std::string>{};
+            for (const Property& property : Properties)
+            {
+                names.push_back(property.Name);
+            }
+            return names;
+        }
+
+        void Class::AddProperty(const Property& property)
+        {
+            Properties.push_back(property);
+            ReferenceTokensAssembled = false;
+            AllPropertiesAssembled = false;
+        }
+
+        const Property* Class::FindProperty(const std::string& name) const
+        {
+            for (const Class* current = this; current; current = current->SuperClass)
+            {
+                for (const Property& property : current->Properties)
+                {
+                    if (property.Name == name)
+                        return &property;
+                }
+            }
+            return nullptr;
+        }
+
+        const std::vector<const Property*>& Class::GetAllProperties()
+        {
+            if (!AllPropertiesAssembled)
+            {
+                AllProperties = SuperClass ? SuperClass->GetAllProperties() : std::vector<const Property*>{};
+                for (const Property& property : Properties)
+                {
+                    AllProperties.push_back(&property);
+                }
+                AllPropertiesAssembled = true;
+            }
+            return AllProperties;
+        }
+
+        Object* Class::GetDefaultObject()
+        {
+            if (!DefaultObject)
+            {
+                // Kept out of the registry so object queries and GC never see it
+                DefaultObject = CreateObject(nullptr, "Default__" + Name);
+                if (DefaultObject)
+                {
+                    DefaultObject->ClassPrivate = this;
+                    DefaultObject->Name = "Default__" + Name;
+                    DefaultObject->AddFlags(ObjectFlags::ClassDefaultObject);
+                }
+            }
+            return DefaultObject;
+        }
+
+        void Class::RecordSerialSize(size_t size)
+        {
+            // Concurrent savers may lose an update, which only makes the estimate lag
+            size_t estimate = EstimatedSerialSize.load(std::memory_order_relaxed);
+            estimate = estimate ? estimate - estimate / 4 + size / 4 : size;
+            EstimatedSerialSize.store(std::max<size_t>(estimate, 1), std::memory_order_relaxed);
+        }
+
+        const ReferenceTokenStream& Class::GetReferenceTokenStream()
+        {
+            if (!ReferenceTokensAssembled)
+            {
+                AssembleReferenceTokenStream();
+            }
+            return ReferenceTokens;
+        }
+
+        void Class::AssembleReferenceTokenStream()
+        {
+            ReferenceTokens.Reset();
+            if (SuperClass)
+            {
+                ReferenceTokens.Append(SuperClass->GetReferenceTokenStream());
+            }
+            ReferenceTokens.EmitProperties(Properties);
+            ReferenceTokensAssembled = true;
+        }
+
+        Object* Class::CreateObject(Object* outer, const std::string& name)
+        {
+            // Base implementation - derived classes should override
+            // In a real implementation, this would use reflection or factory pattern
+            return nullptr;
+        }
+
+        // ObjectRegistry implementation
+        ObjectRegistry& ObjectRegistry::Get()
+        {
+            static ObjectRegistry instance;
+            return instance;
+        }
+
+        void ObjectRegistry::RegisterObject(Object* object)
+        {
+            if (!object || object->InternalIndex != InvalidObjectIndex)
+                return;
+
+            int32_t index;
+            if (!FreeSlots.empty())
+            {
+                index = FreeSlots.back();
+                FreeSlots.pop_back();
+                Slots[index] = object;
+            }
+            else
+            {
+                index = static_cast<int32_t>(Slots.size());
+                Slots.push_back(object);
+            }
+
+            object->InternalIndex = index;
+            AllocatedSlots.Set(index);
+            NumObjects++;
+
+            std::string name = object->GetFullName();
+            Objects[name] = object;
+
+            Class* objClass = object->GetClass();
+            if (objClass)
+            {
+                ClassBits[objClass].Set(index);
+            }
+
+            OnFlagsChanged(object, ObjectFlags::None, object->GetFlags());
+        }
+
+        void ObjectRegistry::UnregisterObject(Object* object)
+        {
+            if (!object || object->InternalIndex == InvalidObjectIndex)
+                return;
+
+            int32_t index = object->InternalIndex;
+
+            std::string name = object->GetFullName();
+            auto it = Objects.find(name);
+            if (it != Objects.end() && it->second == object)
+            {
+                Objects.erase(it);
+            }
+
+            Class* objClass = object->GetClass();
+            if (objClass)
+            {
+                auto classIt = ClassBits.find(objClass);
+                if (classIt != ClassBits.end())
+                {
+                    classIt->second.Clear(index);
+                }
+            }
+
+            OnFlagsChanged(object, object->GetFlags(), ObjectFlags::None);
+
+            AllocatedSlots.Clear(index);
+            Slots[index] = nullptr;
+            FreeSlots.push_back(index);
+            NumObjects--;
+
+            object->InternalIndex = InvalidObjectIndex;
+        }
+
+        void ObjectRegistry::OnFlagsChanged(ObjectBase* object, ObjectFlags oldFlags, ObjectFlags newFlags)
+        {
+            uint32_t index = static_cast<uint32_t>(object->InternalIndex);
+            uint32_t changed = static_cast<uint32_t>(oldFlags) ^ static_cast<uint32_t>(newFlags);
+            while (changed)
+            {
+                uint32_t bit = BitOps::CountTrailingZeros(changed);
+                FlagBits[bit].Set(index, (static_cast<uint32_t>(newFlags) >> bit) & 1);
+                changed &= changed - 1;
+            }
+        }
+
+        Object* ObjectRegistry::FindObject(const std::string& name) const
+        {
+            auto it = Objects.find(name);
+            return it != Objects.end() ? it->second : nullptr;
+        }
+
+        std::vector<Object*> ObjectRegistry::GetObjectsOfClass(Class* objectClass) const
+        {
+            std::vector<Object*> result;
+            if (const BitArray* classBits = GetClassBits(objectClass))
+            {
+                result.reserve(classBits->CountSetBits());
+                ForEachObject(*classBits, [&](Object* object) { result.push_back(object); });
+            }
+            return result;
+        }
+
+        Object* ObjectRegistry::GetObjectAt(int32_t index) const
+        {
+            return index >= 0 && index < static_cast<int32_t>(Slots.size()) ? Slots[index] : nullptr;
+        }
+
+        const BitArray& ObjectRegistry::GetFlagBits(ObjectFlags flag) const
+        {
+            static const BitArray s_Empty;
+            uint32_t bits = static_cast<uint32_t>(flag);
+            return bits ? FlagBits[BitOps::CountTrailingZeros(bits)] : s_Empty;
+        }
+
+        const BitArray* ObjectRegistry::GetClassBits(Class* objectClass) const
+        {
+            auto it = ClassBits.find(objectClass);
+            return it != ClassBits.end() ? &it->second : nullptr;
+        }
+
+        BitArray ObjectRegistry::QueryObjects(ObjectFlags requiredFlags, ObjectFlags excludedFlags, Class* objectClass) const
+        {
+            BitArray result;
+            if (objectClass)
+            {
+                const BitArray* classBits = GetClassBits(objectClass);
+                if (!classBits)
+                    return result;
+                result = *classBits;
+            }
+            else
+            {
+                result = AllocatedSlots;
+            }
+
+            uint32_t required = static_cast<uint32_t>(requiredFlags);
+            while (required)
+            {
+                result &= FlagBits[BitOps::CountTrailingZeros(required)];
+                required &= required - 1;
+            }
+
+            uint32_t excluded = static_cast<uint32_t>(excludedFlags);
+            while (excluded)
+            {
+                result.AndNot(FlagBits[BitOps::CountTrailingZeros(excluded)]);
+                excluded &= excluded - 1;
+            }
+
+            return result;
+        }
+
+        uint64_t ObjectRegistry::GetMatchingSlotsWord(size_t wordIndex, ObjectFlags requiredFlags, ObjectFlags excludedFlags) const
+        {
+            uint64_t word = AllocatedSlots.GetWord(wordIndex);
+
+            uint32_t required = static_cast<uint32_t>(requiredFlags);
+            while (required && word)
+            {
+                word &= FlagBits[BitOps::CountTrailingZeros(required)].GetWord(wordIndex);
+                required &= required - 1;
+            }
+
+            uint32_t excluded = static_cast<uint32_t>(excludedFlags);
+            while (excluded && word)
+            {
+                word &= ~FlagBits[BitOps::CountTrailingZeros(excluded)].GetWord(wordIndex);
+                excluded &= excluded - 1;
+            }
+
+            return word;
+        }
+
+        std::vector<Object*> ObjectRegistry::GetObjectsWithFlags(ObjectFlags requiredFlags, ObjectFlags excludedFlags) const
+        {
+            BitArray objectBits = QueryObjects(requiredFlags, excludedFlags);
+
+            std::vector<Object*> result;
+            result.reserve(objectBits.CountSetBits());
+            ForEachObject(objectBits, [&](Object* object) { result.push_back(object); });
+            return result;
+        }
+
+    } // namespace Core
+
 } // namespace Titan
\ No newline at end of file
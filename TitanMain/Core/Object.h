@@ -1,265 +1,522 @@
-#pragma once
-
-// Titan::Core::Object - Base object system
-// Inspired by UE UObject system, simplified for our needs
-
-#include <atomic>
-#include <memory>
-#include <string>
-#include <unordered_map>
-#include <vector>
-
-namespace Titan
-{
-    namespace Core
-    {
-        // Forward declarations
-        class Class;
-        class Object;
-
-        // Object flags - simplified version of UE's EObjectFlags
-        enum class ObjectFlags : uint32_t
-        {
-            None                    = 0,
-            Public                  = 1 << 0,   // Can be referenced by external packages
-            Standalone             = 1 << 1,   // Keep object around for editing even if unreferenced
-            MarkAsNative           = 1 << 2,   // Object is native to engine
-            Transient              = 1 << 3,   // Object is not saved to disk
-            MarkAsRootSet          = 1 << 4,   // Object is in root set, do not garbage collect
-            NeedInitialization     = 1 << 5,   // Object needs to be initialized
-            BeginDestroyed         = 1 << 6,   // Object is being destroyed
-            FinishDestroyed        = 1 << 7,   // Object has been destroyed
-            BeingRegenerated       = 1 << 8,   // Object is being regenerated
-            DefaultSubObject       = 1 << 9,   // Object is a default subobject
-            WasLoaded              = 1 << 10,  // Object was loaded
-            TextExportTransient    = 1 << 11,  // Object shouldn't be exported to text
-            LoadCompleted          = 1 << 12,  // Object loading is complete
-            InitializedProps       = 1 << 13,  // Properties have been initialized
-            ConstructedObject      = 1 << 14,  // Object has been constructed
-        };
-
-        inline ObjectFlags operator|(ObjectFlags a, ObjectFlags b)
-        {
-            return static_cast<ObjectFlags>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
-        }
-
-        inline ObjectFlags operator&(ObjectFlags a, ObjectFlags b)
-        {
-            return static_cast<ObjectFlags>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
-        }
-
-        inline ObjectFlags operator~(ObjectFlags a)
-        {
-            return static_cast<ObjectFlags>(~static_cast<uint32_t>(a));
-        }
-
-        inline ObjectFlags& operator|=(ObjectFlags& a, ObjectFlags b)
-        {
-            a = a | b;
-            return a;
-        }
-
-        inline ObjectFlags& operator&=(ObjectFlags& a, ObjectFlags b)
-        {
-            a = a & b;
-            return a;
-        }
-
-        // Base object class - similar to UObjectBase
-        class ObjectBase
-        {
-        public:
-            ObjectBase();
-            virtual ~ObjectBase();
-
-            // Basic properties
-            const std::string& GetName() const { return Name; }
-            void SetName(const std::string& name) { Name = name; }
-
-            Class* GetClass() const { return ClassPrivate; }
-            Object* GetOuter() const { return OuterPrivate; }
-
-            ObjectFlags GetFlags() const { return ObjectFlagsPrivate; }
-            void SetFlags(ObjectFlags flags) { ObjectFlagsPrivate = flags; }
-            void AddFlags(ObjectFlags flags) { ObjectFlagsPrivate |= flags; }
-            void RemoveFlags(ObjectFlags flags) { ObjectFlagsPrivate &= ~flags; }
-            bool HasFlags(ObjectFlags flags) const { return (ObjectFlagsPrivate & flags) != ObjectFlags::None; }
-
-            // Memory management
-            virtual void BeginDestroy();
-            virtual void FinishDestroy();
-            bool IsPendingKill() const { return HasFlags(ObjectFlags::BeginDestroyed); }
-
-            // Reference counting
-            void AddRef();
-            void Release();
-            int32_t GetRefCount() const { return RefCount.load(); }
-
-        protected:
-            std::string Name;
-            Class* ClassPrivate = nullptr;
-            Object* OuterPrivate = nullptr;
-            ObjectFlags ObjectFlagsPrivate = ObjectFlags::None;
-            std::atomic<int32_t> RefCount{0};
-        };
-
-        // Main object class - similar to UObject
-        class Object : public ObjectBase
-        {
-        public:
-            Object();
-            virtual ~Object();
-
-            // Object lifecycle
-            virtual void PostInitProperties() {}
-            virtual void BeginPlay() {}
-            virtual void Tick(float deltaTime) {}
-            virtual void EndPlay() {}
-
-            // Serialization
-            virtual void Serialize(class Archive& archive) {}
-
-            // Property access
-            template<typename T>
-            T* GetProperty(const std::string& name);
-
-            template<typename T>
-            void SetProperty(const std::string& name, const T& value);
-
-            // Utility functions
-            std::string GetFullName() const;
-            std::string GetPathName() const;
-
-            // Static functions
-            static Object* CreateObject(Class* objectClass, Object* outer = nullptr, const std::string& name = "");
-            static void DestroyObject(Object* object);
-
-            template<typename T, typename... Args>
-            static T* CreateObject(Object* outer = nullptr, const std::string& name = "")
-            {
-                return static_cast<T*>(CreateObject(T::StaticClass(), outer, name));
-            }
-        };
-
-        // Class system - simplified version of UClass
-        class Class
-        {
-        public:
-            Class(const std::string& name, Class* superClass = nullptr);
-            virtual ~Class();
-
-            const std::string& GetName() const { return Name; }
-            Class* GetSuperClass() const { return SuperClass; }
-
-            // Object creation
-            virtual Object* CreateObject(Object* outer = nullptr, const std::string& name = "");
-
-            // Reflection-like functions
-            virtual std::vector<std::string> GetPropertyNames() const { return {}; }
-            virtual bool HasProperty(const std::string& name) const { return false; }
-
-        protected:
-            std::string Name;
-            Class* SuperClass = nullptr;
-        };
-
-        // Object registry - simplified FUObjectArray
-        class ObjectRegistry
-        {
-        public:
-            static ObjectRegistry& Get();
-
-            void RegisterObject(Object* object);
-            void UnregisterObject(Object* object);
-
-            Object* FindObject(const std::string& name) const;
-            std::vector<Object*> GetObjectsOfClass(Class* objectClass) const;
-
-            size_t GetObjectCount() const { return Objects.size(); }
-
-        private:
-            ObjectRegistry() = default;
-            ~ObjectRegistry() = default;
-
-            std::unordered_map<std::string, Object*> Objects;
-            std::unordered_map<Class*, std::vector<Object*>> ObjectsByClass;
-        };
-
-        // Smart pointer for objects - simplified TObjectPtr
-        template<typename T>
-        class ObjectPtr
-        {
-        public:
-            ObjectPtr() : Ptr(nullptr) {}
-            ObjectPtr(T* ptr) : Ptr(ptr) { AddRef(); }
-            ObjectPtr(const ObjectPtr& other) : Ptr(other.Ptr) { AddRef(); }
-            ObjectPtr(ObjectPtr&& other) noexcept : Ptr(other.Ptr) { other.Ptr = nullptr; }
-
-            ~ObjectPtr() { Release(); }
-
-            ObjectPtr& operator=(const ObjectPtr& other)
-            {
-                if (this != &other)
-                {
-                    Release();
-                    Ptr = other.Ptr;
-                    AddRef();
-                }
-                return *this;
-            }
-
-            ObjectPtr& operator=(ObjectPtr&& other) noexcept
-            {
-                if (this != &other)
-                {
-                    Release();
-                    Ptr = other.Ptr;
-                    other.Ptr = nullptr;
-                }
-                return *this;
-            }
-
-            T* operator->() const { return Ptr; }
-            T& operator*() const { return *Ptr; }
-
-            operator bool() const { return Ptr != nullptr; }
-            bool operator!() const { return Ptr == nullptr; }
-
-            T* Get() const { return Ptr; }
-
-            bool IsValid() const { return Ptr != nullptr; }
-
-        private:
-            void AddRef()
-            {
-                if (Ptr)
-                {
-                    Ptr->AddRef();
-                }
-            }
-
-            void Release()
-            {
-                if (Ptr)
-                {
-                    Ptr->Release();
-                }
-            }
-
-            T* Ptr;
-        };
-
-        // Helper macros for class registration
-        #define TITAN_CLASS(ClassName, SuperClass) \
-            class ClassName : public SuperClass { \
-            public: \
-                static Class* StaticClass() { \
-                    static Class s_Class(#ClassName, SuperClass::StaticClass()); \
-                    return &s_Class; \
-                } \
-                virtual Class* GetClass() const override { return StaticClass(); } \
-            };
-
-    } // namespace Core
-
+#pragma once
+
+// Titan::Core::Object - Base object system
+// Inspired by UE UObject system, simplified for our needs
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "BitArray.h"
+#include "Property.h"
+#include "ReferenceTokenStream.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        // Forward declarations
+        class Class;
+        class Object;
+        class ObjectRegistry;
+        class GarbageCollector;
+
+        // Slot index of an object that is not registered
+        constexpr int32_t InvalidObjectIndex = -1;
+
+        // Object flags - simplified version of UE's EObjectFlags
+        enum class ObjectFlags : uint32_t
+        {
+            None                    = 0,
+            Public                  = 1 << 0,   // Can be referenced by external packages
+            Standalone             = 1 << 1,   // Keep object around for editing even if unreferenced
+            MarkAsNative           = 1 << 2,   // Object is native to engine
+            Transient              = 1 << 3,   // Object is not saved to disk
+            MarkAsRootSet          = 1 << 4,   // Object is in root set, do not garbage collect
+            NeedInitialization     = 1 << 5,   // Object needs to be initialized
+            BeginDestroyed         = 1 << 6,   // Object is being destroyed
+            FinishDestroyed        = 1 << 7,   // Object has been destroyed
+            BeingRegenerated       = 1 << 8,   // Object is being regenerated
+            DefaultSubObject       = 1 << 9,   // Object is a default subobject
+            WasLoaded              = 1 << 10,  // Object was loaded
+            TextExportTransient    = 1 << 11,  // Object shouldn't be exported to text
+            LoadCompleted          = 1 << 12,  // Object loading is complete
+            InitializedProps       = 1 << 13,  // Properties have been initialized
+            ConstructedObject      = 1 << 14,  // Object has been constructed
+            ClassDefaultObject     = 1 << 15,  // Per-class template holding default property values
+        };
+
+        // Number of bits ObjectFlags can hold, one registry bitset is kept per bit
+        constexpr uint32_t NumObjectFlagBits = 32;
+
+        constexpr ObjectFlags operator|(ObjectFlags a, ObjectFlags b)
+        {
+            return static_cast<ObjectFlags>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+        }
+
+        constexpr ObjectFlags operator&(ObjectFlags a, ObjectFlags b)
+        {
+            return static_cast<ObjectFlags>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
+        }
+
+        inline ObjectFlags operator~(ObjectFlags a)
+        {
+            return static_cast<ObjectFlags>(~static_cast<uint32_t>(a));
+        }
+
+        inline ObjectFlags& operator|=(ObjectFlags& a, ObjectFlags b)
+        {
+            a = a | b;
+            return a;
+        }
+
+        inline ObjectFlags& operator&=(ObjectFlags& a, ObjectFlags b)
+        {
+            a = a & b;
+            return a;
+        }
+
+        // Base object class - similar to UObjectBase
+        class ObjectBase
+        {
+        public:
+            ObjectBase();
+            virtual ~ObjectBase();
+
+            // Basic properties
+            const std::string& GetName() const { return Name; }
+            void SetName(const std::string& name) { Name = name; }
+
+            Class* GetClass() const { return ClassPrivate; }
+            Object* GetOuter() const { return OuterPrivate; }
+
+            ObjectFlags GetFlags() const { return ObjectFlagsPrivate; }
+            void SetFlags(ObjectFlags flags);
+            void AddFlags(ObjectFlags flags);
+            void RemoveFlags(ObjectFlags flags);
+            bool HasFlags(ObjectFlags flags) const { return (ObjectFlagsPrivate & flags) != ObjectFlags::None; }
+
+            // Slot in ObjectRegistry, InvalidObjectIndex while unregistered
+            int32_t GetInternalIndex() const { return InternalIndex; }
+
+            // GC cluster this object belongs to, InvalidObjectIndex if none
+            int32_t GetClusterIndex() const { return ClusterIndex; }
+
+            // Memory management
+            virtual void BeginDestroy();
+            virtual void FinishDestroy();
+            bool IsPendingKill() const { return HasFlags(ObjectFlags::BeginDestroyed); }
+
+            // Reference counting
+            void AddRef();
+            void Release();
+            int32_t GetRefCount() const { return RefCount.load(); }
+
+        protected:
+            std::string Name;
+            Class* ClassPrivate = nullptr;
+            Object* OuterPrivate = nullptr;
+            ObjectFlags ObjectFlagsPrivate = ObjectFlags::None;
+            std::atomic<int32_t> RefCount{0};
+
+        private:
+            friend class Class;
+            friend class ObjectRegistry;
+            friend class PackageLoader;
+            friend class ObjectImage;
+            friend class GarbageCollector;
+
+            void UpdateFlags(ObjectFlags newFlags);
+
+            int32_t InternalIndex = InvalidObjectIndex;
+            int32_t ClusterIndex = InvalidObjectIndex;
+        };
+
+        // Main object class - similar to UObject
+        class Object : public ObjectBase
+        {
+        public:
+            Object();
+            virtual ~Object();
+
+            // Object lifecycle
+            virtual void PostInitProperties() {}
+            virtual void BeginPlay() {}
+            virtual void Tick(float deltaTime) {}
+            virtual void EndPlay() {}
+
+            // Serialization, by default the reflected properties (see PropertySerialization.h)
+            virtual void Serialize(class Archive& archive);
+
+            // Statically dispatched field serialization, see StaticArchive.h.
+            // Derived classes chain Super::SerializeFields first.
+            template<typename ArchiveType>
+            void SerializeFields(ArchiveType&) {}
+
+            // Property access
+            template<typename T>
+            T* GetProperty(const std::string& name);
+
+            template<typename T>
+            void SetProperty(const std::string& name, const T& value);
+
+            // Utility functions
+            std::string GetFullName() const;
+            std::string GetPathName() const;
+
+            // Class checks, a range compare on the class tree (no RTTI)
+            bool IsA(const Class* someClass) const;
+
+            template<typename T>
+            bool IsA() const { return IsA(T::StaticClass()); }
+
+            // Reflection
+            static Class* StaticClass() { return StaticClassPrivate ? StaticClassPrivate : RegisterStaticClass(); }
+
+            // Static functions
+            static Object* CreateObject(Class* objectClass, Object* outer = nullptr, const std::string& name = "");
+            static void DestroyObject(Object* object);
+
+            template<typename T, typename... Args>
+            static T* CreateObject(Object* outer = nullptr, const std::string& name = "")
+            {
+                return static_cast<T*>(CreateObject(T::StaticClass(), outer, name));
+            }
+
+        private:
+            static Class* RegisterStaticClass();
+            static Class* StaticClassPrivate;
+        };
+
+        // Class system - simplified version of UClass
+        class Class
+        {
+        public:
+            Class(const std::string& name, Class* superClass = nullptr);
+            virtual ~Class();
+
+            const std::string& GetName() const { return Name; }
+            Class* GetSuperClass() const { return SuperClass; }
+
+            // Position in the depth-first class tree; descendants occupy
+            // (ClassTreeIndex, ClassTreeIndex + ClassTreeNumChildren]
+            int32_t GetClassTreeIndex() const
+            {
+                GetClassTreeSequence();
+                return ClassTreeIndex.load(std::memory_order_relaxed);
+            }
+            int32_t GetClassTreeNumChildren() const
+            {
+                GetClassTreeSequence();
+                return ClassTreeNumChildren.load(std::memory_order_relaxed);
+            }
+
+            // True if this is otherClass or derives from it. Retried if the tree was renumbered
+            // while it was read, so classes may be registered while other threads check.
+            bool IsChildOf(const Class* otherClass) const
+            {
+                if (!otherClass)
+                    return false;
+
+                for (;;)
+                {
+                    uint32_t sequence = GetClassTreeSequence();
+                    bool isChild = static_cast<uint32_t>(ClassTreeIndex.load(std::memory_order_relaxed) - otherClass->ClassTreeIndex.load(std::memory_order_relaxed))
+                        <= static_cast<uint32_t>(otherClass->ClassTreeNumChildren.load(std::memory_order_relaxed));
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (ClassTreeSequence.load(std::memory_order_relaxed) == sequence)
+                        return isChild;
+                }
+            }
+
+            // Object creation
+            virtual Object* CreateObject(Object* outer = nullptr, const std::string& name = "");
+
+            // Registered class with this name, nullptr if there is none
+            static Class* FindClass(const std::string& name);
+
+            // Reflection-like functions
+            virtual std::vector<std::string> GetPropertyNames() const;
+            virtual bool HasProperty(const std::string& name) const { return FindProperty(name) != nullptr; }
+
+            // Reflected properties declared by this class (see TITAN_PROPERTY)
+            void AddProperty(const Property& property);
+            const std::vector<Property>& GetProperties() const { return Properties; }
+            const Property* FindProperty(const std::string& name) const;
+
+            // Properties of this class and its supers, super class properties first.
+            // Cached on first use like the reference token stream.
+            const std::vector<const Property*>& GetAllProperties();
+
+            // Unregistered instance holding the class defaults, created on first use
+            Object* GetDefaultObject();
+
+            // Running average of the bytes an instance serializes to, 0 until one was recorded.
+            // Savers reserve this up front instead of running a CountingArchive pass each time.
+            size_t GetEstimatedSerialSize() const { return EstimatedSerialSize.load(std::memory_order_relaxed); }
+            void RecordSerialSize(size_t size);
+
+            // Object references held by instances, super class references first.
+            // Assembled on first use; register properties before the first GC.
+            const ReferenceTokenStream& GetReferenceTokenStream();
+            void AssembleReferenceTokenStream();
+
+        protected:
+            std::string Name;
+            Class* SuperClass = nullptr;
+
+            std::vector<Property> Properties;
+            ReferenceTokenStream ReferenceTokens;
+            bool ReferenceTokensAssembled = false;
+
+            std::vector<const Property*> AllProperties;
+            bool AllPropertiesAssembled = false;
+
+            Object* DefaultObject = nullptr;
+
+            std::atomic<size_t> EstimatedSerialSize{0};
+
+        private:
+            // Even while the numbering is current. Creating or destroying a class makes it odd,
+            // the next class check renumbers the tree once and makes it even again.
+            static std::atomic<uint32_t> ClassTreeSequence;
+
+            static uint32_t GetClassTreeSequence()
+            {
+                uint32_t sequence = ClassTreeSequence.load(std::memory_order_acquire);
+                return (sequence & 1) ? RebuildClassTree() : sequence;
+            }
+
+            // Renumbers every registered class if the tree is stale, returns the new sequence
+            static uint32_t RebuildClassTree();
+            static void InvalidateClassTree();
+
+            std::atomic<int32_t> ClassTreeIndex{0};
+            std::atomic<int32_t> ClassTreeNumChildren{0};
+        };
+
+        // Class for native C++ types, creates instances with the default constructor
+        template<typename T>
+        class NativeClass : public Class
+        {
+        public:
+            NativeClass(const std::string& name, Class* superClass)
+                : Class(name, superClass) {}
+
+            virtual Object* CreateObject(Object* = nullptr, const std::string& = "") override
+            {
+                if constexpr (std::is_abstract<T>::value || !std::is_default_constructible<T>::value)
+                    return nullptr;
+                else
+                    return new T();
+            }
+        };
+
+        inline bool Object::IsA(const Class* someClass) const
+        {
+            return ClassPrivate && ClassPrivate->IsChildOf(someClass);
+        }
+
+        // Checked downcast, nullptr if object is not a T
+        template<typename T, typename From>
+        T* Cast(From* object)
+        {
+            return object && object->IsA(T::StaticClass()) ? static_cast<T*>(object) : nullptr;
+        }
+
+        template<typename T, typename From>
+        const T* Cast(const From* object)
+        {
+            return object && object->IsA(T::StaticClass()) ? static_cast<const T*>(object) : nullptr;
+        }
+
+        // Object registry - simplified FUObjectArray
+        // Every registered object owns a slot; per-flag and per-class bitsets keyed by
+        // slot index are kept up to date so queries never scan the object list
+        class ObjectRegistry
+        {
+        public:
+            static ObjectRegistry& Get();
+
+            void RegisterObject(Object* object);
+            void UnregisterObject(Object* object);
+
+            Object* FindObject(const std::string& name) const;
+            std::vector<Object*> GetObjectsOfClass(Class* objectClass) const;
+
+            size_t GetObjectCount() const { return NumObjects; }
+
+            // Slot access
+            Object* GetObjectAt(int32_t index) const;
+            int32_t GetSlotCount() const { return static_cast<int32_t>(Slots.size()); }
+
+            // Bitset queries
+            const BitArray& GetAllObjectBits() const { return AllocatedSlots; }
+            const BitArray& GetFlagBits(ObjectFlags flag) const;
+            const BitArray* GetClassBits(Class* objectClass) const;
+
+            // Objects having all of requiredFlags, none of excludedFlags and (optionally) exactly objectClass
+            BitArray QueryObjects(ObjectFlags requiredFlags, ObjectFlags excludedFlags = ObjectFlags::None, Class* objectClass = nullptr) const;
+
+            // One 64-slot word of QueryObjects(requiredFlags, excludedFlags) without building the whole set
+            uint64_t GetMatchingSlotsWord(size_t wordIndex, ObjectFlags requiredFlags, ObjectFlags excludedFlags) const;
+            std::vector<Object*> GetObjectsWithFlags(ObjectFlags requiredFlags, ObjectFlags excludedFlags = ObjectFlags::None) const;
+
+            template<typename Func>
+            void ForEachObject(const BitArray& objectBits, Func&& func) const
+            {
+                objectBits.ForEachSetBit([&](size_t index)
+                {
+                    if (index < Slots.size() && Slots[index])
+                        func(Slots[index]);
+                });
+            }
+
+        private:
+            friend class ObjectBase;
+
+            ObjectRegistry() = default;
+            ~ObjectRegistry() = default;
+
+            void OnFlagsChanged(ObjectBase* object, ObjectFlags oldFlags, ObjectFlags newFlags);
+
+            std::unordered_map<std::string, Object*> Objects;
+            std::vector<Object*> Slots;
+            std::vector<int32_t> FreeSlots;
+            size_t NumObjects = 0;
+
+            BitArray AllocatedSlots;
+            BitArray FlagBits[NumObjectFlagBits];
+            std::unordered_map<Class*, BitArray> ClassBits;
+        };
+
+        // The game thread creates objects, ticks loading and resolves lazy references. The engine
+        // claims it at startup; otherwise the first thread to ask becomes the game thread.
+        void SetGameThread();
+        bool IsInGameThread();
+
+        // Loads the package export behind a lazy ObjectPtr handle, see LazyLoading.h. Game thread only.
+        Object* ResolveLazyObject(uintptr_t handle);
+
+        // Full name of the export behind a lazy handle, without loading it; empty once its package is closed
+        std::string GetLazyObjectName(uintptr_t handle);
+
+        // Smart pointer for objects - simplified TObjectPtr
+        // May also hold a lazy handle (LazyObjectTag set) to an export that is not loaded yet;
+        // the first Get() / dereference loads it. Resolving is game thread only (asserted), other threads
+        // read the raw slot and treat lazy handles as not loaded.
+        template<typename T>
+        class ObjectPtr
+        {
+        public:
+            ObjectPtr() : Value(0) {}
+            ObjectPtr(T* ptr) : Value(reinterpret_cast<uintptr_t>(ptr)) { AddRef(); }
+            ObjectPtr(const ObjectPtr& other) : Value(other.Value) { AddRef(); }
+            ObjectPtr(ObjectPtr&& other) noexcept : Value(other.Value) { other.Value = 0; }
+
+            ~ObjectPtr() { Release(); }
+
+            ObjectPtr& operator=(const ObjectPtr& other)
+            {
+                if (this != &other)
+                {
+                    Release();
+                    Value = other.Value;
+                    AddRef();
+                }
+                return *this;
+            }
+
+            ObjectPtr& operator=(ObjectPtr&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    Release();
+                    Value = other.Value;
+                    other.Value = 0;
+                }
+                return *this;
+            }
+
+            static ObjectPtr FromLazyHandle(uintptr_t handle)
+            {
+                ObjectPtr result;
+                result.Value = handle | LazyObjectTag;
+                return result;
+            }
+
+            T* operator->() const { return Get(); }
+            T& operator*() const { return *Get(); }
+
+            // A lazy reference counts as set without being loaded
+            operator bool() const { return Value != 0; }
+            bool operator!() const { return Value == 0; }
+
+            T* Get() const
+            {
+                if (Value & LazyObjectTag)
+                    Resolve();
+                return reinterpret_cast<T*>(Value);
+            }
+
+            bool IsValid() const { return Value != 0; }
+
+            bool IsLoaded() const { return (Value & LazyObjectTag) == 0; }
+            uintptr_t GetLazyHandle() const { return IsLoaded() ? 0 : Value; }
+
+        private:
+            void Resolve() const
+            {
+                assert(IsInGameThread() && "Lazy ObjectPtr resolved off the game thread");
+                T* object = Cast<T>(ResolveLazyObject(Value));
+                Value = reinterpret_cast<uintptr_t>(object);
+                AddRef();
+            }
+
+            void AddRef() const
+            {
+                if (Value && IsLoaded())
+                {
+                    reinterpret_cast<T*>(Value)->AddRef();
+                }
+            }
+
+            void Release()
+            {
+                if (Value && IsLoaded())
+                {
+                    reinterpret_cast<T*>(Value)->Release();
+                }
+            }
+
+            mutable uintptr_t Value;
+        };
+
+        // Helper macros for class registration
+        // TITAN_CLASS_BODY goes inside a class deriving from SuperClass. StaticClass() is a load of a
+        // cached pointer; the slow path only runs if called before this class's static init.
+        #define TITAN_CLASS_BODY(ClassName, SuperClass) \
+            public: \
+                using Super = SuperClass; \
+                static ::Titan::Core::Class* StaticClass() { \
+                    return StaticClassPrivate ? StaticClassPrivate : RegisterStaticClass(); \
+                } \
+            private: \
+                static ::Titan::Core::Class* RegisterStaticClass() { \
+                    static ::Titan::Core::NativeClass<ClassName> s_Class(#ClassName, Super::StaticClass()); \
+                    return &s_Class; \
+                } \
+                static inline ::Titan::Core::Class* StaticClassPrivate = RegisterStaticClass(); \
+            public:
+
+        #define TITAN_CLASS(ClassName, SuperClass) \
+            class ClassName : public SuperClass { \
+                TITAN_CLASS_BODY(ClassName, SuperClass) \
+            };
+
+    } // namespace Core
+
 } // namespace Titan
\ No newline at end of file
@@ -0,0 +1,851 @@
+#include "ObjectImage.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include "Archive.h"
+#include "CompressedArchive.h"
+#include "Object.h"
+#include "PropertySerialization.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        // On-disk records, copied with memcpy so the image needs no alignment
+        struct ObjectImageHeader
+        {
+            uint32_t Magic = ObjectImage::Magic;
+            uint32_t Version = ObjectImage::Version;
+            uint32_t PointerSize = sizeof(void*);
+            uint32_t EndianTag = 0x01020304;
+            uint32_t NumClasses = 0;
+            uint32_t NumObjects = 0;
+            uint32_t NumExternals = 0;
+            uint32_t Reserved = 0;
+            uint64_t ClassOffset = 0;
+            uint64_t ObjectOffset = 0;
+            uint64_t ExternalOffset = 0;
+            uint64_t DataOffset = 0;
+            uint64_t BlobOffset = 0;
+            uint64_t BlobSize = 0;
+            uint64_t TotalSize = 0;
+        };
+
+        struct ObjectImageClass
+        {
+            uint32_t NameOffset = 0;
+            uint32_t NameLength = 0;
+            uint64_t LayoutHash = 0;
+        };
+
+        struct ObjectImageObject
+        {
+            uint32_t ClassIndex = 0;
+            uint32_t Flags = 0;
+            uint32_t Outer = 0;
+            uint32_t NameOffset = 0;
+            uint32_t NameLength = 0;
+            uint32_t Reserved = 0;
+            uint64_t DataOffset = 0;
+        };
+
+        struct ObjectImageExternal
+        {
+            uint32_t NameOffset = 0;
+            uint32_t NameLength = 0;
+        };
+
+        // String: blob offset and length. Object: reference. Arrays: blob offset and count.
+        struct ObjectImageSlot
+        {
+            uint32_t First = 0;
+            uint32_t Second = 0;
+        };
+
+        // Runtime state that does not survive into a new object
+        constexpr ObjectFlags NonImageFlags = ObjectFlags::BeginDestroyed | ObjectFlags::FinishDestroyed | ObjectFlags::ClassDefaultObject;
+
+        static size_t GetRecordSize(const PropertyLayout& layout)
+        {
+            return layout.CopySize + layout.Slots.size() * sizeof(ObjectImageSlot);
+        }
+
+        // Elements of the array property at address, through the Property's thunk
+        static uint8_t* GetArrayData(const Property& property, uint8_t* address, size_t& count)
+        {
+            count = 0;
+            return property.GetArrayData ? property.GetArrayData(address, count) : nullptr;
+        }
+
+        // Append-only bytes that keep their capacity between captures and are never zero-filled
+        class CaptureBuffer
+        {
+        public:
+            size_t GetSize() const { return Size; }
+            uint8_t* GetData() { return Data.get(); }
+
+            void Clear() { Size = 0; }
+            void Truncate(size_t size) { Size = std::min(Size, size); }
+
+            // The returned bytes stay valid until the next Append
+            uint8_t* Append(size_t size)
+            {
+                if (size > Capacity - Size)
+                {
+                    size_t capacity = std::max<size_t>(std::max(Capacity * 2, Size + size), 4096);
+                    std::unique_ptr<uint8_t[]> data(new uint8_t[capacity]);
+                    if (Size)
+                        std::memcpy(data.get(), Data.get(), Size);
+                    Data = std::move(data);
+                    Capacity = capacity;
+                }
+
+                uint8_t* result = Data.get() + Size;
+                Size += size;
+                return result;
+            }
+
+        private:
+            std::unique_ptr<uint8_t[]> Data;
+            size_t Size = 0;
+            size_t Capacity = 0;
+        };
+
+        struct ObjectImageCaptureState
+        {
+            // Direct-mapped caches in front of ClassIndices and GetPropertyLayout, which locks
+            struct ClassCacheEntry
+            {
+                const Class* Key = nullptr;
+                uint32_t Index = 0;
+            };
+            struct StructCacheEntry
+            {
+                const StructInfo* Key = nullptr;
+                const PropertyLayout* Layout = nullptr;
+            };
+            static constexpr size_t CacheSize = 64;
+
+            static size_t GetCacheBucket(const void* key)
+            {
+                return (reinterpret_cast<uintptr_t>(key) >> 4) % CacheSize;
+            }
+
+            void Reset()
+            {
+                Members.clear();
+                MemberSlots.clear();
+                ObjectTable.clear();
+                Classes.clear();
+                Layouts.clear();
+                LayoutHashes.clear();
+                ClassIndices.clear();
+                std::fill(std::begin(ClassCache), std::end(ClassCache), ClassCacheEntry());
+                std::fill(std::begin(StructCache), std::end(StructCache), StructCacheEntry());
+                ExternalNames.clear();
+                Externals.clear();
+                Unregistered.clear();
+                Data.Clear();
+                Blob.Clear();
+                Overflow = false;
+                Valid = false;
+            }
+
+            // Blob space for size bytes, copied from data unless it is null
+            uint32_t AppendBlob(const void* data, size_t size)
+            {
+                size_t start = Blob.GetSize();
+                size_t offset = (start + 3) & ~static_cast<size_t>(3);
+                if (offset + size > UINT32_MAX)
+                {
+                    Overflow = true;
+                    return 0;
+                }
+
+                uint8_t* padding = Blob.Append(offset - start + size);
+                for (size_t i = start; i < offset; ++i)
+                {
+                    *padding++ = 0;
+                }
+                if (data && size)
+                    std::memcpy(Blob.GetData() + offset, data, size);
+                return static_cast<uint32_t>(offset);
+            }
+
+            uint32_t GetReference(Object* object)
+            {
+                if (!object)
+                    return 0;
+
+                int32_t slot = object->GetInternalIndex();
+                if (slot != InvalidObjectIndex)
+                {
+                    if (static_cast<size_t>(slot) < SlotReferences.size() && SlotReferences[slot])
+                        return SlotReferences[slot];
+                }
+                else if (!Unregistered.empty())
+                {
+                    auto internal = Unregistered.find(object);
+                    if (internal != Unregistered.end())
+                        return internal->second;
+                }
+
+                auto external = Externals.emplace(object, static_cast<uint32_t>(ExternalNames.size()));
+                if (external.second)
+                    ExternalNames.push_back(object->GetFullName());
+                return ObjectImage::ExternalReferenceBit | external.first->second;
+            }
+
+            // Unloaded exports stay unloaded: the export's full name is stored like any other external
+            uint32_t GetLazyReference(uintptr_t handle)
+            {
+                // Tagged handles never collide with object addresses
+                auto external = Externals.emplace(reinterpret_cast<const Object*>(handle), static_cast<uint32_t>(ExternalNames.size()));
+                if (external.second)
+                {
+                    std::string name = GetLazyObjectName(handle);
+                    if (name.empty())
+                    {
+                        Externals.erase(external.first);
+                        return 0;
+                    }
+                    ExternalNames.push_back(std::move(name));
+                }
+                return ObjectImage::ExternalReferenceBit | external.first->second;
+            }
+
+            uint32_t GetClassIndex(Class* objectClass)
+            {
+                ClassCacheEntry& cached = ClassCache[GetCacheBucket(objectClass)];
+                if (cached.Key == objectClass)
+                    return cached.Index;
+
+                auto found = ClassIndices.emplace(objectClass, static_cast<uint32_t>(Classes.size()));
+                if (found.second)
+                {
+                    const PropertyLayout& layout = GetPropertyLayout(objectClass);
+                    Classes.push_back(objectClass);
+                    Layouts.push_back(&layout);
+                    LayoutHashes.push_back(layout.Hash);
+                }
+                cached.Key = objectClass;
+                cached.Index = found.first->second;
+                return cached.Index;
+            }
+
+            const PropertyLayout& GetStructLayout(const StructInfo* structInfo)
+            {
+                StructCacheEntry& cached = StructCache[GetCacheBucket(structInfo)];
+                if (cached.Key != structInfo)
+                {
+                    cached.Key = structInfo;
+                    cached.Layout = &GetPropertyLayout(structInfo);
+                }
+                return *cached.Layout;
+            }
+
+            // Fills the record at offset in out, which may be the blob itself
+            void WriteRecord(const PropertyLayout& layout, uint8_t* container, CaptureBuffer& out, size_t offset)
+            {
+                size_t cursor = offset;
+                for (const PropertyLayout::CopyRun& run : layout.CopyRuns)
+                {
+                    std::memcpy(out.GetData() + cursor, container + run.Offset, run.Size);
+                    cursor += run.Size;
+                }
+
+                for (const Property& slot : layout.Slots)
+                {
+                    ObjectImageSlot entry = WriteSlot(slot, container + slot.Offset);
+                    std::memcpy(out.GetData() + cursor, &entry, sizeof(entry));
+                    cursor += sizeof(entry);
+                }
+            }
+
+            std::vector<Object*> Members;
+            std::vector<int32_t> MemberSlots;       // Registry slots set in SlotReferences
+            std::vector<ObjectImageObject> ObjectTable;
+            std::vector<Class*> Classes;
+            std::vector<const PropertyLayout*> Layouts;
+            std::vector<uint64_t> LayoutHashes;
+            std::unordered_map<const Class*, uint32_t> ClassIndices;
+            ClassCacheEntry ClassCache[CacheSize];
+            StructCacheEntry StructCache[CacheSize];
+            std::vector<std::string> ExternalNames;
+            std::unordered_map<const Object*, uint32_t> Externals;
+            std::unordered_map<const Object*, uint32_t> Unregistered;  // Members without a registry slot
+            std::vector<uint32_t> SlotReferences;   // Reference of the member in each registry slot, 0 outside Capture
+            CaptureBuffer Data;
+            CaptureBuffer Blob;
+            bool Overflow = false;
+            bool Valid = false;
+
+        private:
+            // Reads the raw slot; ObjectPtr::Get would load lazy references on the game thread
+            uint32_t ReadReference(const Property& property, uint8_t* address)
+            {
+                Object* object = *reinterpret_cast<Object**>(address);
+                if (property.IsObjectPtr && IsLazyObjectHandle(object))
+                    return GetLazyReference(reinterpret_cast<uintptr_t>(object));
+                return GetReference(object);
+            }
+
+            ObjectImageSlot WriteSlot(const Property& property, uint8_t* address)
+            {
+                ObjectImageSlot entry;
+                size_t count = 0;
+                switch (property.Type)
+                {
+                case PropertyType::String:
+                {
+                    const std::string& value = *reinterpret_cast<const std::string*>(address);
+                    count = value.size();
+                    if (count)
+                        entry.First = AppendBlob(value.data(), count);
+                    break;
+                }
+                case PropertyType::Object:
+                    entry.First = ReadReference(property, address);
+                    break;
+                case PropertyType::ObjectArray:
+                {
+                    uint8_t* elements = GetArrayData(property, address, count);
+                    if (count == 0)
+                        break;
+                    entry.First = AppendBlob(nullptr, count * sizeof(uint32_t));
+                    for (size_t i = 0; i < count && !Overflow; ++i)
+                    {
+                        uint32_t reference = ReadReference(property, elements + i * sizeof(Object*));
+                        std::memcpy(Blob.GetData() + entry.First + i * sizeof(uint32_t), &reference, sizeof(reference));
+                    }
+                    break;
+                }
+                case PropertyType::StructArray:
+                {
+                    uint8_t* elements = property.Struct ? GetArrayData(property, address, count) : nullptr;
+                    if (count == 0)
+                        break;
+
+                    // Element records are reserved first, nested arrays append behind them
+                    const PropertyLayout& elementLayout = GetStructLayout(property.Struct);
+                    size_t recordSize = GetRecordSize(elementLayout);
+                    entry.First = AppendBlob(nullptr, count * recordSize);
+                    for (size_t i = 0; i < count && !Overflow; ++i)
+                    {
+                        WriteRecord(elementLayout, elements + i * property.Struct->Size, Blob, entry.First + i * recordSize);
+                    }
+                    break;
+                }
+                default:
+                    break;
+                }
+
+                if (count > UINT32_MAX)
+                    Overflow = true;
+                entry.Second = static_cast<uint32_t>(count);
+                return entry;
+            }
+        };
+
+        class ObjectImageReader
+        {
+        public:
+            ObjectImageReader(const uint8_t* image, const ObjectImageHeader& header)
+                : Header(header), Blob(header.BlobOffset <= header.TotalSize ? image + header.BlobOffset : image) {}
+
+            bool IsInImage(uint64_t offset, uint64_t size) const
+            {
+                return offset <= Header.TotalSize && size <= Header.TotalSize - offset;
+            }
+
+            bool IsInBlob(uint64_t offset, uint64_t size) const
+            {
+                return offset <= Header.BlobSize && size <= Header.BlobSize - offset;
+            }
+
+            bool ReadString(uint32_t offset, uint32_t length, std::string& value) const
+            {
+                if (!IsInBlob(offset, length))
+                    return false;
+                value.assign(reinterpret_cast<const char*>(Blob) + offset, length);
+                return true;
+            }
+
+            bool IsValidReference(uint32_t reference) const
+            {
+                if (reference & ObjectImage::ExternalReferenceBit)
+                    return (reference & ~ObjectImage::ExternalReferenceBit) < Header.NumExternals;
+                return reference <= Header.NumObjects;
+            }
+
+            Object* Resolve(uint32_t reference) const
+            {
+                if (reference & ObjectImage::ExternalReferenceBit)
+                    return Externals[reference & ~ObjectImage::ExternalReferenceBit];
+                return reference ? Objects[reference - 1] : nullptr;
+            }
+
+            // Checks every slot before anything is applied, so a bad image never leaves
+            // half-initialized objects behind
+            bool CheckRecord(const PropertyLayout& layout, const uint8_t* record) const
+            {
+                const uint8_t* slots = record + layout.CopySize;
+                for (size_t i = 0; i < layout.Slots.size(); ++i)
+                {
+                    const Property& property = layout.Slots[i];
+                    ObjectImageSlot entry;
+                    std::memcpy(&entry, slots + i * sizeof(entry), sizeof(entry));
+                    switch (property.Type)
+                    {
+                    case PropertyType::String:
+                        if (!IsInBlob(entry.First, entry.Second))
+                            return false;
+                        break;
+                    case PropertyType::Object:
+                        if (!IsValidReference(entry.First))
+                            return false;
+                        break;
+                    case PropertyType::ObjectArray:
+                    {
+                        if (!property.ResizeArray || !IsInBlob(entry.First, static_cast<uint64_t>(entry.Second) * sizeof(uint32_t)))
+                            return false;
+                        for (uint32_t element = 0; element < entry.Second; ++element)
+                        {
+                            uint32_t reference;
+                            std::memcpy(&reference, Blob + entry.First + element * sizeof(uint32_t), sizeof(reference));
+                            if (!IsValidReference(reference))
+                                return false;
+                        }
+                        break;
+                    }
+                    case PropertyType::StructArray:
+                    {
+                        if (!property.Struct || !property.ResizeArray)
+                            return false;
+
+                        const PropertyLayout& elementLayout = GetPropertyLayout(property.Struct);
+                        size_t recordSize = GetRecordSize(elementLayout);
+                        if (!IsInBlob(entry.First, static_cast<uint64_t>(entry.Second) * recordSize))
+                            return false;
+                        for (uint32_t element = 0; element < entry.Second; ++element)
+                        {
+                            if (!CheckRecord(elementLayout, Blob + entry.First + element * recordSize))
+                                return false;
+                        }
+                        break;
+                    }
+                    default:
+                        break;
+                    }
+                }
+                return true;
+            }
+
+            void ApplyRecord(const PropertyLayout& layout, const uint8_t* record, uint8_t* container) const
+            {
+                for (const PropertyLayout::CopyRun& run : layout.CopyRuns)
+                {
+                    std::memcpy(container + run.Offset, record, run.Size);
+                    record += run.Size;
+                }
+
+                // The rebasing pass: offsets and indices become pointers into this process
+                for (const Property& property : layout.Slots)
+                {
+                    ObjectImageSlot entry;
+                    std::memcpy(&entry, record, sizeof(entry));
+                    record += sizeof(entry);
+
+                    uint8_t* address = container + property.Offset;
+                    switch (property.Type)
+                    {
+                    case PropertyType::String:
+                        reinterpret_cast<std::string*>(address)->assign(reinterpret_cast<const char*>(Blob) + entry.First, entry.Second);
+                        break;
+                    case PropertyType::Object:
+                        AssignReference(property, address, entry.First);
+                        break;
+                    case PropertyType::ObjectArray:
+                    {
+                        property.ResizeArray(address, entry.Second);
+                        size_t count;
+                        uint8_t* elements = GetArrayData(property, address, count);
+                        for (size_t i = 0; i < count; ++i)
+                        {
+                            uint32_t reference;
+                            std::memcpy(&reference, Blob + entry.First + i * sizeof(uint32_t), sizeof(reference));
+                            AssignReference(property, elements + i * sizeof(Object*), reference);
+                        }
+                        break;
+                    }
+                    case PropertyType::StructArray:
+                    {
+                        const PropertyLayout& elementLayout = GetPropertyLayout(property.Struct);
+                        size_t recordSize = GetRecordSize(elementLayout);
+                        property.ResizeArray(address, entry.Second);
+                        size_t count;
+                        uint8_t* elements = GetArrayData(property, address, count);
+                        for (size_t i = 0; i < count; ++i)
+                        {
+                            ApplyRecord(elementLayout, Blob + entry.First + i * recordSize, elements + i * property.Struct->Size);
+                        }
+                        break;
+                    }
+                    default:
+                        break;
+                    }
+                }
+            }
+
+            const ObjectImageHeader& Header;
+            const uint8_t* Blob;
+            std::vector<Object*> Objects;
+            std::vector<Object*> Externals;
+
+        private:
+            void AssignReference(const Property& property, uint8_t* address, uint32_t reference) const
+            {
+                if (property.IsObjectPtr)
+                    *reinterpret_cast<ObjectPtr<Object>*>(address) = ObjectPtr<Object>(Resolve(reference));
+                else
+                    *reinterpret_cast<Object**>(address) = Resolve(reference);
+            }
+        };
+
+        // ObjectImageCapture implementation
+
+        ObjectImageCapture::ObjectImageCapture()
+            : State(std::make_unique<ObjectImageCaptureState>())
+        {
+        }
+
+        ObjectImageCapture::~ObjectImageCapture() = default;
+
+        bool ObjectImageCapture::Capture(const std::vector<Object*>& objects)
+        {
+            ObjectImageCaptureState& state = *State;
+            state.Reset();
+
+            // References to members resolve through their registry slots; duplicates keep the first
+            size_t numSlots = static_cast<size_t>(ObjectRegistry::Get().GetSlotCount());
+            if (state.SlotReferences.size() < numSlots)
+                state.SlotReferences.resize(numSlots, 0);
+            for (Object* object : objects)
+            {
+                if (!object || !object->GetClass())
+                    continue;
+
+                uint32_t reference = static_cast<uint32_t>(state.Members.size() + 1);
+                int32_t slot = object->GetInternalIndex();
+                if (slot != InvalidObjectIndex && static_cast<size_t>(slot) < state.SlotReferences.size())
+                {
+                    if (state.SlotReferences[slot])
+                        continue;
+                    state.SlotReferences[slot] = reference;
+                    state.MemberSlots.push_back(slot);
+                }
+                else if (!state.Unregistered.emplace(object, reference).second)
+                {
+                    continue;
+                }
+                state.Members.push_back(object);
+            }
+
+            state.ObjectTable.resize(state.Members.size());
+            for (size_t i = 0; i < state.Members.size(); ++i)
+            {
+                Object* object = state.Members[i];
+                ObjectImageObject& entry = state.ObjectTable[i];
+                entry.ClassIndex = state.GetClassIndex(object->GetClass());
+                entry.Flags = static_cast<uint32_t>(object->GetFlags() & ~NonImageFlags);
+                entry.Outer = state.GetReference(object->GetOuter());
+                entry.NameOffset = state.AppendBlob(object->GetName().data(), object->GetName().size());
+                entry.NameLength = static_cast<uint32_t>(object->GetName().size());
+
+                const PropertyLayout& layout = *state.Layouts[entry.ClassIndex];
+                entry.DataOffset = state.Data.GetSize();
+                state.Data.Append(GetRecordSize(layout));
+                state.WriteRecord(layout, reinterpret_cast<uint8_t*>(object), state.Data, static_cast<size_t>(entry.DataOffset));
+            }
+
+            for (int32_t slot : state.MemberSlots)
+            {
+                state.SlotReferences[slot] = 0;
+            }
+
+            state.Valid = !state.Overflow && state.Members.size() < ObjectImage::ExternalReferenceBit
+                && state.ExternalNames.size() < ObjectImage::ExternalReferenceBit;
+            return state.Valid;
+        }
+
+        // Class and external names go behind the captured blob when the image is written
+        static uint64_t GetFinalBlobSize(const ObjectImageCaptureState& state)
+        {
+            uint64_t size = state.Blob.GetSize();
+            auto addName = [&size](const std::string& name) { size = ((size + 3) & ~uint64_t(3)) + name.size(); };
+            for (const Class* objectClass : state.Classes)
+            {
+                addName(objectClass->GetName());
+            }
+            for (const std::string& name : state.ExternalNames)
+            {
+                addName(name);
+            }
+            return size;
+        }
+
+        static ObjectImageHeader MakeHeader(const ObjectImageCaptureState& state, uint64_t blobSize)
+        {
+            ObjectImageHeader header;
+            header.NumClasses = static_cast<uint32_t>(state.Classes.size());
+            header.NumObjects = static_cast<uint32_t>(state.ObjectTable.size());
+            header.NumExternals = static_cast<uint32_t>(state.ExternalNames.size());
+            header.ClassOffset = sizeof(header);
+            header.ObjectOffset = header.ClassOffset + state.Classes.size() * sizeof(ObjectImageClass);
+            header.ExternalOffset = header.ObjectOffset + state.ObjectTable.size() * sizeof(ObjectImageObject);
+            header.DataOffset = header.ExternalOffset + state.ExternalNames.size() * sizeof(ObjectImageExternal);
+            header.BlobOffset = header.DataOffset + state.Data.GetSize();
+            header.BlobSize = blobSize;
+            header.TotalSize = header.BlobOffset + header.BlobSize;
+            return header;
+        }
+
+        uint64_t ObjectImageCapture::GetImageSize() const
+        {
+            return State->Valid ? MakeHeader(*State, GetFinalBlobSize(*State)).TotalSize : 0;
+        }
+
+        bool ObjectImageCapture::Write(Archive& archive)
+        {
+            ObjectImageCaptureState& state = *State;
+            if (!state.Valid)
+            {
+                archive.SetError();
+                return false;
+            }
+
+            // Names are appended for this write only, so the capture can be written again
+            size_t capturedBlobSize = state.Blob.GetSize();
+            std::vector<ObjectImageClass> classTable(state.Classes.size());
+            for (size_t i = 0; i < classTable.size(); ++i)
+            {
+                const std::string& name = state.Classes[i]->GetName();
+                classTable[i].NameOffset = state.AppendBlob(name.data(), name.size());
+                classTable[i].NameLength = static_cast<uint32_t>(name.size());
+                classTable[i].LayoutHash = state.LayoutHashes[i];
+            }
+
+            std::vector<ObjectImageExternal> externalTable(state.ExternalNames.size());
+            for (size_t i = 0; i < externalTable.size(); ++i)
+            {
+                const std::string& name = state.ExternalNames[i];
+                externalTable[i].NameOffset = state.AppendBlob(name.data(), name.size());
+                externalTable[i].NameLength = static_cast<uint32_t>(name.size());
+            }
+
+            if (state.Overflow)
+            {
+                state.Blob.Truncate(capturedBlobSize);
+                state.Overflow = false;
+                archive.SetError();
+                return false;
+            }
+
+            ObjectImageHeader header = MakeHeader(state, state.Blob.GetSize());
+            archive.Serialize(&header, sizeof(header));
+            if (!classTable.empty())
+                archive.Serialize(classTable.data(), classTable.size() * sizeof(ObjectImageClass));
+
+            // Data offsets were captured relative to the data section
+            ObjectImageObject batch[256];
+            for (size_t first = 0; first < state.ObjectTable.size(); first += 256)
+            {
+                size_t count = std::min<size_t>(256, state.ObjectTable.size() - first);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    batch[i] = state.ObjectTable[first + i];
+                    batch[i].DataOffset += header.DataOffset;
+                }
+                archive.Serialize(batch, count * sizeof(ObjectImageObject));
+            }
+
+            if (!externalTable.empty())
+                archive.Serialize(externalTable.data(), externalTable.size() * sizeof(ObjectImageExternal));
+            if (state.Data.GetSize())
+                archive.Serialize(state.Data.GetData(), state.Data.GetSize());
+            if (state.Blob.GetSize())
+                archive.Serialize(state.Blob.GetData(), state.Blob.GetSize());
+
+            state.Blob.Truncate(capturedBlobSize);
+            return !archive.HasError();
+        }
+
+        // ObjectImage implementation
+
+        std::vector<uint8_t> ObjectImage::Build(const std::vector<Object*>& objects)
+        {
+            ObjectImageCapture capture;
+            if (!capture.Capture(objects))
+                return std::vector<uint8_t>();
+
+            MemoryArchive archive;
+            archive.Reserve(static_cast<size_t>(capture.GetImageSize()));
+            if (!capture.Write(archive))
+                return std::vector<uint8_t>();
+            return std::move(archive.GetData());
+        }
+
+        bool ObjectImage::Save(const std::string& filename, const std::vector<Object*>& objects)
+        {
+            ObjectImageCapture capture;
+            if (!capture.Capture(objects))
+                return false;
+
+            FileArchive archive(filename, false);
+            capture.Write(archive);
+            archive.Flush();
+            return !archive.HasError();
+        }
+
+        std::vector<Object*> ObjectImage::Load(const uint8_t* data, size_t size)
+        {
+            ObjectImageHeader header;
+            if (!data || size < sizeof(header))
+                return std::vector<Object*>();
+            std::memcpy(&header, data, sizeof(header));
+
+            const ObjectImageHeader expected;
+            if (header.Magic != Magic || header.Version != Version || header.PointerSize != expected.PointerSize
+                || header.EndianTag != expected.EndianTag || header.TotalSize > size)
+            {
+                return std::vector<Object*>();
+            }
+
+            ObjectImageReader reader(data, header);
+            if (!reader.IsInImage(header.ClassOffset, static_cast<uint64_t>(header.NumClasses) * sizeof(ObjectImageClass))
+                || !reader.IsInImage(header.ObjectOffset, static_cast<uint64_t>(header.NumObjects) * sizeof(ObjectImageObject))
+                || !reader.IsInImage(header.ExternalOffset, static_cast<uint64_t>(header.NumExternals) * sizeof(ObjectImageExternal))
+                || !reader.IsInImage(header.BlobOffset, header.BlobSize))
+            {
+                return std::vector<Object*>();
+            }
+
+            // A class whose properties moved since the image was built cannot take a raw copy
+            std::vector<Class*> classes(header.NumClasses);
+            std::vector<const PropertyLayout*> layouts(header.NumClasses);
+            for (uint32_t i = 0; i < header.NumClasses; ++i)
+            {
+                ObjectImageClass entry;
+                std::memcpy(&entry, data + header.ClassOffset + i * sizeof(entry), sizeof(entry));
+
+                std::string name;
+                if (!reader.ReadString(entry.NameOffset, entry.NameLength, name) || !(classes[i] = Class::FindClass(name)))
+                    return std::vector<Object*>();
+                layouts[i] = &GetPropertyLayout(classes[i]);
+                if (layouts[i]->Hash != entry.LayoutHash)
+                    return std::vector<Object*>();
+            }
+
+            reader.Externals.resize(header.NumExternals);
+            for (uint32_t i = 0; i < header.NumExternals; ++i)
+            {
+                ObjectImageExternal entry;
+                std::memcpy(&entry, data + header.ExternalOffset + i * sizeof(entry), sizeof(entry));
+
+                std::string name;
+                if (!reader.ReadString(entry.NameOffset, entry.NameLength, name))
+                    return std::vector<Object*>();
+                reader.Externals[i] = ObjectRegistry::Get().FindObject(name);
+            }
+
+            std::vector<ObjectImageObject> entries(header.NumObjects);
+            std::vector<std::string> names(header.NumObjects);
+            for (uint32_t i = 0; i < header.NumObjects; ++i)
+            {
+                ObjectImageObject& entry = entries[i];
+                std::memcpy(&entry, data + header.ObjectOffset + i * sizeof(entry), sizeof(entry));
+                if (entry.ClassIndex >= header.NumClasses || !reader.IsValidReference(entry.Outer)
+                    || !reader.ReadString(entry.NameOffset, entry.NameLength, names[i])
+                    || !reader.IsInImage(entry.DataOffset, GetRecordSize(*layouts[entry.ClassIndex]))
+                    || !reader.CheckRecord(*layouts[entry.ClassIndex], data + entry.DataOffset))
+                {
+                    return std::vector<Object*>();
+                }
+            }
+
+            // Everything is created before any record is applied, references may point forward
+            std::vector<Object*>& objects = reader.Objects;
+            objects.reserve(header.NumObjects);
+            for (uint32_t i = 0; i < header.NumObjects; ++i)
+            {
+                Class* objectClass = classes[entries[i].ClassIndex];
+                Object* object = objectClass->CreateObject(nullptr, names[i]);
+                if (!object)
+                {
+                    for (Object* created : objects)
+                    {
+                        created->Release();
+                    }
+                    return std::vector<Object*>();
+                }
+
+                // Same defaults as Object::CreateObject, registration waits until the data is in
+                if (!object->ClassPrivate)
+                    object->ClassPrivate = objectClass;
+                if (object->Name.empty())
+                    object->Name = names[i];
+                object->AddFlags(static_cast<ObjectFlags>(entries[i].Flags) | ObjectFlags::WasLoaded);
+                objects.push_back(object);
+            }
+
+            for (uint32_t i = 0; i < header.NumObjects; ++i)
+            {
+                Object* object = objects[i];
+                if (Object* outer = reader.Resolve(entries[i].Outer))
+                    object->OuterPrivate = outer;
+                reader.ApplyRecord(*layouts[entries[i].ClassIndex], data + entries[i].DataOffset, reinterpret_cast<uint8_t*>(object));
+            }
+
+            for (Object* object : objects)
+            {
+                ObjectRegistry::Get().RegisterObject(object);
+                object->AddFlags(ObjectFlags::LoadCompleted);
+                object->PostInitProperties();
+            }
+            return objects;
+        }
+
+        std::vector<Object*> ObjectImage::Load(const std::string& filename)
+        {
+            FileArchive archive(filename, FileArchive::LoadMode::MemoryMapped);
+            if (!archive.IsOpen() || archive.HasError())
+                return std::vector<Object*>();
+
+            size_t size = static_cast<size_t>(archive.TotalSize());
+            uint32_t magic = 0;
+            if (size >= sizeof(magic))
+            {
+                archive.Serialize(&magic, sizeof(magic));
+                archive.Seek(0);
+            }
+
+            // Images saved compressed are decompressed to memory first
+            if (magic == CompressedArchive::Magic)
+            {
+                CompressedArchive compressed(archive);
+                std::vector<uint8_t> buffer(static_cast<size_t>(compressed.TotalSize()));
+                compressed.Serialize(buffer.data(), buffer.size());
+                return compressed.HasError() || archive.HasError() ? std::vector<Object*>() : Load(buffer.data(), buffer.size());
+            }
+
+            if (const uint8_t* mapped = archive.ReadInPlace(size))
+                return Load(mapped, size);
+
+            std::vector<uint8_t> buffer(size);
+            archive.Serialize(buffer.data(), size);
+            return archive.HasError() ? std::vector<Object*>() : Load(buffer.data(), size);
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+// Titan::Core::ObjectImage - Position-independent memory image of a set of objects
+// Meant for fast restarts of the same build rather than for content: the image stores every
+// object's reflected state in its native in-memory layout, so loading is a bulk copy of the
+// trivially copyable property runs plus one pass that rebases the reference slots. Objects are
+// still constructed through their class (they carry vtables, strings and arrays that cannot
+// live in a mapping), but no per-field Archive dispatch happens.
+//
+// Layout, all offsets relative to the start of the image:
+//     Header    { Magic, Version, PointerSize, EndianTag, counts, table offsets, BlobSize, TotalSize }
+//     Classes   { NameOffset, NameLength, LayoutHash }
+//     Objects   { ClassIndex, Flags, Outer, NameOffset, NameLength, DataOffset }
+//     Externals { NameOffset, NameLength }   (full names of referenced objects outside the image)
+//     Data      per object: the class's copy runs back to back, then 8 bytes per slot
+//     Blob      string bytes, reference arrays, struct array elements; blob offsets are relative
+//               to the start of the blob
+//
+// A reference is a uint32: 0 null, N > 0 object N - 1, or ExternalReferenceBit | external index.
+// Images are rejected when a class is missing or its PropertyLayout hash changed.
+//
+// Building is split in two: ObjectImageCapture copies the objects' state on the game thread, and
+// writing the image from that copy may happen on any thread (see AsyncSaving.h).
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Titan
+{
+    namespace Core
+    {
+        class Archive;
+        class Object;
+        struct ObjectImageCaptureState;
+
+        class ObjectImage
+        {
+        public:
+            static constexpr uint32_t Magic = 0x474D4954;   // "TIMG"
+            static constexpr uint32_t Version = 1;
+            static constexpr uint32_t ExternalReferenceBit = 0x80000000u;
+
+            // Builds the image of objects; outers and references outside the set are stored by
+            // full name. Empty if the image would exceed the 32-bit offset range.
+            static std::vector<uint8_t> Build(const std::vector<Object*>& objects);
+            static bool Save(const std::string& filename, const std::vector<Object*>& objects);
+
+            // Recreates the objects, registered and in image order; empty if the image is
+            // invalid. References to external objects that no longer exist load as null.
+            static std::vector<Object*> Load(const uint8_t* data, size_t size);
+
+            // Memory-maps the file when possible; also reads images saved through a CompressedArchive
+            static std::vector<Object*> Load(const std::string& filename);
+        };
+
+        // Everything an image needs, copied out of the objects so they may change or be destroyed
+        // while the image is written. References are resolved through the objects' registry slots
+        // and full names of external objects are taken during the capture. Lazy references are
+        // stored by export name without loading the export.
+        // The buffers keep their capacity, so reusing one capture for periodic saves stops allocating.
+        class ObjectImageCapture
+        {
+        public:
+            ObjectImageCapture();
+            ~ObjectImageCapture();
+
+            ObjectImageCapture(const ObjectImageCapture&) = delete;
+            ObjectImageCapture& operator=(const ObjectImageCapture&) = delete;
+
+            // Game thread. False if the image would exceed the 32-bit offset range.
+            bool Capture(const std::vector<Object*>& objects);
+
+            // Any thread, one at a time: the image of the last successful capture
+            uint64_t GetImageSize() const;
+            bool Write(Archive& archive);
+
+        private:
+            std::unique_ptr<ObjectImageCaptureState> State;
+        };
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+// Titan::Core::ObjectIterator - Iteration over live registered objects
+// Walks the registry slot array 64 slots at a time using the flag bitsets, no allocations
+
+#include <algorithm>
+#include "Object.h"
+#include "ThreadPool.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        // Usage: for (ObjectIterator it(MyClass, ObjectFlags::WasLoaded); it; ++it) { Object* object = *it; }
+        // Objects created while iterating are not visited; objects must not be destroyed mid-iteration.
+        class ObjectIterator
+        {
+        public:
+            explicit ObjectIterator(Class* objectClass = nullptr, ObjectFlags requiredFlags = ObjectFlags::None, ObjectFlags excludedFlags = ObjectFlags::None)
+                : ObjectIterator(0, ObjectRegistry::Get().GetSlotCount(), objectClass, requiredFlags, excludedFlags)
+            {
+            }
+
+            // Visit only slots in [beginSlot, endSlot)
+            ObjectIterator(int32_t beginSlot, int32_t endSlot, Class* objectClass, ObjectFlags requiredFlags, ObjectFlags excludedFlags)
+                : Registry(ObjectRegistry::Get())
+                , FilterClass(objectClass)
+                , RequiredFlags(requiredFlags)
+                , ExcludedFlags(excludedFlags)
+                , BeginSlot(std::max(0, beginSlot))
+                , EndSlot(std::min(endSlot, ObjectRegistry::Get().GetSlotCount()))
+                , NextWord(static_cast<size_t>(std::max(0, beginSlot)) >> 6)
+            {
+                Advance();
+            }
+
+            explicit operator bool() const { return Current != nullptr; }
+            Object* operator*() const { return Current; }
+            Object* operator->() const { return Current; }
+
+            ObjectIterator& operator++()
+            {
+                Advance();
+                return *this;
+            }
+
+        private:
+            void Advance()
+            {
+                Current = nullptr;
+                for (;;)
+                {
+                    while (PendingBits == 0)
+                    {
+                        int64_t wordBegin = static_cast<int64_t>(NextWord) << 6;
+                        if (wordBegin >= EndSlot)
+                            return;
+
+                        PendingBits = Registry.GetMatchingSlotsWord(NextWord, RequiredFlags, ExcludedFlags);
+                        if (wordBegin < BeginSlot)
+                            PendingBits &= ~uint64_t(0) << (BeginSlot - wordBegin);
+                        if (EndSlot - wordBegin < 64)
+                            PendingBits &= ~(~uint64_t(0) << (EndSlot - wordBegin));
+                        ++NextWord;
+                    }
+
+                    int32_t slot = static_cast<int32_t>(((NextWord - 1) << 6) + BitOps::CountTrailingZeros(PendingBits));
+                    PendingBits &= PendingBits - 1;
+
+                    Object* object = Registry.GetObjectAt(slot);
+                    if (object && (!FilterClass || (object->GetClass() && object->GetClass()->IsChildOf(FilterClass))))
+                    {
+                        Current = object;
+                        return;
+                    }
+                }
+            }
+
+            const ObjectRegistry& Registry;
+            Class* FilterClass;
+            ObjectFlags RequiredFlags;
+            ObjectFlags ExcludedFlags;
+            int32_t BeginSlot;
+            int32_t EndSlot;
+            size_t NextWord;
+            uint64_t PendingBits = 0;
+            Object* Current = nullptr;
+        };
+
+        // Calls func(Object*) for every matching object, spreading slot ranges over ThreadPool workers.
+        // func runs concurrently and must not create or destroy objects.
+        template<typename Func>
+        void ParallelForEachObject(Func&& func, Class* objectClass = nullptr, ObjectFlags requiredFlags = ObjectFlags::None,
+                                   ObjectFlags excludedFlags = ObjectFlags::None, size_t minBatchSize = 4096)
+        {
+            int32_t slotCount = ObjectRegistry::Get().GetSlotCount();
+            size_t numWords = (static_cast<size_t>(slotCount) + 63) >> 6;
+
+            // Chunks are whole bitset words so workers never share a word
+            ThreadPool::Get().ParallelFor(numWords, std::max<size_t>(1, minBatchSize >> 6), [&](size_t beginWord, size_t endWord)
+            {
+                int32_t beginSlot = static_cast<int32_t>(beginWord << 6);
+                int32_t endSlot = static_cast<int32_t>(std::min<size_t>(endWord << 6, slotCount));
+                for (ObjectIterator it(beginSlot, endSlot, objectClass, requiredFlags, excludedFlags); it; ++it)
+                {
+                    func(*it);
+                }
+            });
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
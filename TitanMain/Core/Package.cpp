@@ -0,0 +1,579 @@
+#include "Package.h"
+#include <unordered_map>
+
+namespace Titan
+{
+    namespace Core
+    {
+        static constexpr uint64_t SummarySize = sizeof(uint32_t) * 6 + sizeof(uint64_t) * 4;
+        static constexpr uint64_t ImportEntrySize = sizeof(int32_t) * 2;
+        static constexpr uint64_t ExportEntrySize = sizeof(int32_t) * 3 + sizeof(uint32_t) + sizeof(uint64_t) * 2;
+
+        // Export data flags carried over from the archive a package is saved to
+        static constexpr ArchiveFlags PackageDataFlags = ArchiveFlags::Compact | ArchiveFlags::Delta | ArchiveFlags::StringTable
+            | ArchiveFlags::Versioned;
+
+        static void SerializeSummary(Archive& archive, PackageSummary& summary, uint32_t& magic, uint32_t& version)
+        {
+            archive << magic << version << summary.DataFlags;
+            archive << summary.NameCount << summary.NameOffset;
+            archive << summary.ImportCount << summary.ImportOffset;
+            archive << summary.ExportCount << summary.ExportOffset;
+            archive << summary.DataOffset;
+        }
+
+        // Clears the data flags while the fixed-width summary and tables are serialized
+        class ScopedTableFlags
+        {
+        public:
+            explicit ScopedTableFlags(Archive& archive) : Target(archive), SavedFlags(archive.GetFlags())
+            {
+                Target.RemoveFlags(PackageDataFlags);
+            }
+
+            ~ScopedTableFlags()
+            {
+                Target.AddFlags(SavedFlags & PackageDataFlags);
+            }
+
+        private:
+            Archive& Target;
+            ArchiveFlags SavedFlags;
+        };
+
+        // Save side: object references become package indices, unknown objects become imports
+        class PackageSaveArchive : public MemoryArchive
+        {
+        public:
+            PackageSaveArchive(const std::unordered_map<const Object*, size_t>& exportMap, std::vector<Object*>& imports,
+                               std::unordered_map<const Object*, size_t>& importMap, ArchiveFlags dataFlags)
+                : MemoryArchive(false), ExportMap(exportMap), Imports(imports), ImportMap(importMap)
+            {
+                AddFlags(dataFlags);
+            }
+
+            PackageIndex GetIndex(Object* object)
+            {
+                if (!object || object->HasFlags(ObjectFlags::Transient))
+                    return PackageIndex();
+
+                auto exported = ExportMap.find(object);
+                if (exported != ExportMap.end())
+                    return PackageIndex::FromExport(exported->second);
+
+                auto imported = ImportMap.find(object);
+                if (imported == ImportMap.end())
+                {
+                    imported = ImportMap.emplace(object, Imports.size()).first;
+                    Imports.push_back(object);
+                }
+                return PackageIndex::FromImport(imported->second);
+            }
+
+            virtual void SerializeObject(Object*& object) override
+            {
+                WriteObjectReference(*this, object);
+            }
+
+            virtual void WriteObjectReference(Archive& target, Object* object) override
+            {
+                int32_t index = GetIndex(object).GetRaw();
+                target << index;
+            }
+
+        private:
+            const std::unordered_map<const Object*, size_t>& ExportMap;
+            std::vector<Object*>& Imports;
+            std::unordered_map<const Object*, size_t>& ImportMap;
+        };
+
+        // Load side: reads package indices from one export's data
+        class PackageLoadArchive : public MemoryArchive
+        {
+        public:
+            PackageLoadArchive(PackageLoader& loader, const uint8_t* data, size_t size, ArchiveFlags dataFlags)
+                : MemoryArchive(data, size), Loader(loader)
+            {
+                AddFlags(dataFlags);
+            }
+
+            virtual void SerializeObject(Object*& object) override
+            {
+                PackageIndex index;
+                object = ReadIndex(index) ? Loader.ResolveIndex(index) : nullptr;
+            }
+
+            virtual void SerializeObjectPtr(ObjectPtr<Object>& objectPtr) override
+            {
+                PackageIndex index;
+                if (!ReadIndex(index))
+                {
+                    objectPtr = nullptr;
+                    return;
+                }
+
+                uintptr_t lazyHandle = Loader.GetLazyHandle(index);
+                objectPtr = lazyHandle ? ObjectPtr<Object>::FromLazyHandle(lazyHandle) : ObjectPtr<Object>(Loader.ResolveIndex(index));
+            }
+
+        private:
+            bool ReadIndex(PackageIndex& index)
+            {
+                int32_t raw = 0;
+                *this << raw;
+
+                index = PackageIndex(raw);
+                if ((index.IsExport() && index.ToExport() >= Loader.GetExports().size())
+                    || (index.IsImport() && index.ToImport() >= Loader.GetImports().size()))
+                {
+                    SetError();
+                    return false;
+                }
+                return true;
+            }
+
+            PackageLoader& Loader;
+        };
+
+        bool SavePackage(Archive& archive, const std::vector<Object*>& exports)
+        {
+            std::vector<Object*> exportObjects;
+            std::unordered_map<const Object*, size_t> exportMap;
+            for (Object* object : exports)
+            {
+                if (object && exportMap.emplace(object, exportObjects.size()).second)
+                    exportObjects.push_back(object);
+            }
+
+            // Export data first, it decides the import table
+            ArchiveFlags dataFlags = archive.GetFlags() & PackageDataFlags;
+            std::vector<Object*> importObjects;
+            std::unordered_map<const Object*, size_t> importMap;
+            std::vector<std::vector<uint8_t>> exportData(exportObjects.size());
+            std::vector<PackageIndex> outers(exportObjects.size());
+            ArchiveStringTable dataStrings;
+            for (size_t i = 0; i < exportObjects.size(); ++i)
+            {
+                PackageSaveArchive data(exportMap, importObjects, importMap, dataFlags);
+                data.SetStringTable(&dataStrings);
+
+                Class* exportClass = exportObjects[i]->GetClass();
+                if (exportClass)
+                    data.Reserve(exportClass->GetEstimatedSerialSize());
+                exportObjects[i]->Serialize(data);
+                if (data.HasError())
+                    return false;
+                if (exportClass)
+                    exportClass->RecordSerialSize(data.GetData().size());
+
+                outers[i] = data.GetIndex(exportObjects[i]->GetOuter());
+                exportData[i] = std::move(data.GetData());
+            }
+
+            std::vector<std::string> names;
+            std::unordered_map<std::string, int32_t> nameMap;
+            auto addName = [&](const std::string& name)
+            {
+                auto found = nameMap.emplace(name, static_cast<int32_t>(names.size()));
+                if (found.second)
+                    names.push_back(name);
+                return found.first->second;
+            };
+
+            // Strings in export data index the name table, so they come first
+            for (size_t i = 0; i < dataStrings.GetNum(); ++i)
+            {
+                addName(*dataStrings.Get(static_cast<uint32_t>(i)));
+            }
+
+            std::vector<int32_t> importNames;
+            for (Object* object : importObjects)
+            {
+                importNames.push_back(addName(object->GetClass() ? object->GetClass()->GetName() : std::string()));
+                importNames.push_back(addName(object->GetFullName()));
+            }
+
+            std::vector<int32_t> exportNames;
+            for (Object* object : exportObjects)
+            {
+                exportNames.push_back(addName(object->GetClass() ? object->GetClass()->GetName() : std::string()));
+                exportNames.push_back(addName(object->GetName()));
+            }
+
+            // Tables go to memory first to place the data behind them
+            MemoryArchive tables(false);
+            PackageSummary summary;
+            summary.DataFlags = static_cast<uint32_t>(dataFlags);
+            summary.NameCount = static_cast<uint32_t>(names.size());
+            summary.NameOffset = SummarySize;
+            for (std::string& name : names)
+            {
+                tables << name;
+            }
+
+            summary.ImportCount = static_cast<uint32_t>(importObjects.size());
+            summary.ImportOffset = SummarySize + static_cast<uint64_t>(tables.Tell());
+            for (int32_t& name : importNames)
+            {
+                tables << name;
+            }
+
+            summary.ExportCount = static_cast<uint32_t>(exportObjects.size());
+            summary.ExportOffset = SummarySize + static_cast<uint64_t>(tables.Tell());
+            summary.DataOffset = summary.ExportOffset + exportObjects.size() * ExportEntrySize;
+
+            uint64_t serialOffset = summary.DataOffset;
+            for (size_t i = 0; i < exportObjects.size(); ++i)
+            {
+                int32_t outer = outers[i].GetRaw();
+                uint32_t flags = static_cast<uint32_t>(exportObjects[i]->GetFlags() & PersistentObjectFlags);
+                uint64_t serialSize = exportData[i].size();
+                tables << exportNames[i * 2] << exportNames[i * 2 + 1] << outer << flags << serialOffset << serialSize;
+                serialOffset += serialSize;
+            }
+
+            ScopedTableFlags tableFlags(archive);
+            uint32_t magic = PackageSummary::Magic;
+            uint32_t version = PackageSummary::Version;
+            SerializeSummary(archive, summary, magic, version);
+            archive.Serialize(tables.GetData().data(), tables.GetData().size());
+            for (std::vector<uint8_t>& data : exportData)
+            {
+                if (!data.empty())
+                    archive.Serialize(data.data(), data.size());
+            }
+            return !archive.HasError();
+        }
+
+        // PackageLoader implementation
+
+        PackageLoader::PackageLoader(Archive& archive)
+            : Inner(archive)
+            , PackageStart(archive.Tell())
+        {
+            ScopedTableFlags tableFlags(Inner);
+            Valid = ReadTables();
+        }
+
+        PackageLoader::~PackageLoader()
+        {
+            // Objects that never reached FinishExport are still owned here
+            for (size_t i = 0; i < Exports.size(); ++i)
+            {
+                if (Exports[i].CreatedObject && States[i] != ExportState::Finished)
+                    Exports[i].CreatedObject->Release();
+            }
+        }
+
+        bool PackageLoader::ReadName(int32_t& index, std::string& name)
+        {
+            Inner << index;
+            if (index < 0 || static_cast<size_t>(index) >= Names.size())
+                return false;
+            name = Names[index];
+            return true;
+        }
+
+        bool PackageLoader::ReadTables()
+        {
+            uint32_t magic = 0;
+            uint32_t version = 0;
+            SerializeSummary(Inner, Summary, magic, version);
+
+            uint64_t packageSize = static_cast<uint64_t>(Inner.TotalSize() - PackageStart);
+            if (Inner.HasError() || magic != PackageSummary::Magic || version != PackageSummary::Version
+                || (Summary.DataFlags & ~static_cast<uint32_t>(PackageDataFlags)) != 0
+                || Summary.NameOffset > packageSize || Summary.NameCount > packageSize - Summary.NameOffset
+                || Summary.ImportOffset > packageSize || Summary.ImportCount > (packageSize - Summary.ImportOffset) / ImportEntrySize
+                || Summary.ExportOffset > packageSize || Summary.ExportCount > (packageSize - Summary.ExportOffset) / ExportEntrySize
+                || Summary.DataOffset > packageSize)
+            {
+                return false;
+            }
+
+            Inner.Seek(PackageStart + static_cast<int64_t>(Summary.NameOffset));
+            Names.resize(Summary.NameCount);
+            for (std::string& name : Names)
+            {
+                Inner << name;
+            }
+
+            // Strings in export data resolve straight to interned names
+            if ((static_cast<ArchiveFlags>(Summary.DataFlags) & ArchiveFlags::StringTable) != ArchiveFlags::None)
+            {
+                for (const std::string& name : Names)
+                {
+                    DataStrings.AddInterned(name);
+                }
+            }
+
+            Inner.Seek(PackageStart + static_cast<int64_t>(Summary.ImportOffset));
+            Imports.resize(Summary.ImportCount);
+            for (ObjectImport& entry : Imports)
+            {
+                int32_t index;
+                if (!ReadName(index, entry.ClassName) || !ReadName(index, entry.ObjectName))
+                    return false;
+            }
+
+            Inner.Seek(PackageStart + static_cast<int64_t>(Summary.ExportOffset));
+            Exports.resize(Summary.ExportCount);
+            for (ObjectExport& entry : Exports)
+            {
+                int32_t index;
+                int32_t outer;
+                uint32_t flags;
+                if (!ReadName(index, entry.ClassName) || !ReadName(index, entry.ObjectName))
+                    return false;
+                Inner << outer << flags << entry.SerialOffset << entry.SerialSize;
+
+                entry.Outer = PackageIndex(outer);
+                entry.Flags = static_cast<ObjectFlags>(flags) & PersistentObjectFlags;
+                if ((entry.Outer.IsExport() && entry.Outer.ToExport() >= Exports.size())
+                    || (entry.Outer.IsImport() && entry.Outer.ToImport() >= Imports.size())
+                    || entry.SerialOffset < Summary.DataOffset || entry.SerialOffset > packageSize
+                    || entry.SerialSize > packageSize - entry.SerialOffset)
+                {
+                    return false;
+                }
+            }
+
+            // CreateExport follows outer chains, they must end
+            for (size_t i = 0; i < Exports.size(); ++i)
+            {
+                PackageIndex outer = Exports[i].Outer;
+                for (size_t depth = 0; outer.IsExport(); ++depth)
+                {
+                    if (depth == Exports.size())
+                        return false;
+                    outer = Exports[outer.ToExport()].Outer;
+                }
+            }
+
+            States.assign(Exports.size(), ExportState::None);
+            return !Inner.HasError();
+        }
+
+        std::string PackageLoader::GetExportFullName(size_t exportIndex) const
+        {
+            const ObjectExport& entry = Exports[exportIndex];
+            if (entry.Outer.IsExport())
+                return GetExportFullName(entry.Outer.ToExport()) + "." + entry.ObjectName;
+            if (entry.Outer.IsImport())
+                return Imports[entry.Outer.ToImport()].ObjectName + "." + entry.ObjectName;
+            return entry.ObjectName;
+        }
+
+        size_t PackageLoader::FindExport(const std::string& fullName) const
+        {
+            for (size_t i = 0; i < Exports.size(); ++i)
+            {
+                if (GetExportFullName(i) == fullName)
+                    return i;
+            }
+            return SIZE_MAX;
+        }
+
+        void PackageLoader::ResolveImports()
+        {
+            for (ObjectImport& entry : Imports)
+            {
+                Object* object = ObjectRegistry::Get().FindObject(entry.ObjectName);
+                Class* importClass = Class::FindClass(entry.ClassName);
+                entry.ResolvedObject = object && importClass && object->IsA(importClass) ? object : nullptr;
+            }
+            ImportsResolved = true;
+        }
+
+        Object* PackageLoader::ResolveIndex(PackageIndex index)
+        {
+            if (index.IsExport() && index.ToExport() < Exports.size())
+            {
+                // Parallel SerializeExport calls update States, CreatedObject is fixed by now
+                if (AllExportsCreated)
+                    return Exports[index.ToExport()].CreatedObject;
+                return CreateExport(index.ToExport());
+            }
+
+            if (index.IsImport() && index.ToImport() < Imports.size())
+            {
+                if (!ImportsResolved)
+                    ResolveImports();
+                return Imports[index.ToImport()].ResolvedObject;
+            }
+            return nullptr;
+        }
+
+        uintptr_t PackageLoader::GetLazyHandle(PackageIndex index) const
+        {
+            if (!LazyHandles || AllExportsCreated || !index.IsExport() || index.ToExport() >= Exports.size() || States[index.ToExport()] != ExportState::None)
+                return 0;
+            return LazyHandles(index.ToExport());
+        }
+
+        Object* PackageLoader::CreateExport(size_t exportIndex)
+        {
+            if (!Valid || exportIndex >= Exports.size())
+                return nullptr;
+
+            ObjectExport& entry = Exports[exportIndex];
+            if (States[exportIndex] != ExportState::None)
+                return entry.CreatedObject;
+
+            Object* outer = ResolveIndex(entry.Outer);
+            Class* exportClass = Class::FindClass(entry.ClassName);
+            Object* object = exportClass ? exportClass->CreateObject(outer, entry.ObjectName) : nullptr;
+            if (!object)
+            {
+                States[exportIndex] = ExportState::Failed;
+                return nullptr;
+            }
+
+            // Same defaults as Object::CreateObject, registration waits for FinishExport
+            if (!object->ClassPrivate)
+                object->ClassPrivate = exportClass;
+            if (!object->OuterPrivate)
+                object->OuterPrivate = outer;
+            if (object->Name.empty())
+                object->Name = entry.ObjectName;
+            object->AddFlags(entry.Flags | ObjectFlags::WasLoaded);
+
+            entry.CreatedObject = object;
+            States[exportIndex] = ExportState::Created;
+            PendingExports.push_back(exportIndex);
+            return object;
+        }
+
+        bool PackageLoader::CreateAllExports()
+        {
+            if (!Valid)
+                return false;
+
+            bool succeeded = true;
+            for (size_t i = 0; i < Exports.size(); ++i)
+            {
+                if (!CreateExport(i))
+                    succeeded = false;
+            }
+            AllExportsCreated = true;
+            return succeeded;
+        }
+
+        bool PackageLoader::ReadExportData(size_t exportIndex, std::vector<uint8_t>& data)
+        {
+            if (!Valid || exportIndex >= Exports.size())
+                return false;
+
+            const ObjectExport& entry = Exports[exportIndex];
+            data.resize(static_cast<size_t>(entry.SerialSize));
+            Inner.Seek(PackageStart + static_cast<int64_t>(entry.SerialOffset));
+            if (!data.empty())
+                Inner.Serialize(data.data(), data.size());
+            return !Inner.HasError();
+        }
+
+        bool PackageLoader::SerializeExport(size_t exportIndex, const uint8_t* data, size_t size)
+        {
+            if (exportIndex >= Exports.size() || States[exportIndex] != ExportState::Created)
+                return false;
+
+            PackageLoadArchive archive(*this, data, size, static_cast<ArchiveFlags>(Summary.DataFlags));
+            archive.SetStringTable(&DataStrings);
+            Exports[exportIndex].CreatedObject->Serialize(archive);
+
+            bool succeeded = !archive.HasError() && archive.Tell() == static_cast<int64_t>(size);
+            States[exportIndex] = succeeded ? ExportState::Serialized : ExportState::Failed;
+            return succeeded;
+        }
+
+        void PackageLoader::FinishExport(size_t exportIndex)
+        {
+            if (exportIndex >= Exports.size() || !Exports[exportIndex].CreatedObject)
+                return;
+
+            ExportState& state = States[exportIndex];
+            if (state == ExportState::Finished || state == ExportState::None)
+                return;
+
+            // Failed exports are registered too so the GC owns them, just never marked complete
+            Object* object = Exports[exportIndex].CreatedObject;
+            ObjectRegistry::Get().RegisterObject(object);
+            if (state == ExportState::Serialized)
+            {
+                object->AddFlags(ObjectFlags::LoadCompleted);
+                object->PostInitProperties();
+            }
+            state = ExportState::Finished;
+        }
+
+        bool PackageLoader::LoadPendingExports(std::vector<size_t>* outFinished)
+        {
+            // Serializing may create more exports, they are appended and picked up here
+            bool succeeded = true;
+            std::vector<uint8_t> data;
+            for (size_t i = 0; i < PendingExports.size(); ++i)
+            {
+                size_t exportIndex = PendingExports[i];
+                const ObjectExport& entry = Exports[exportIndex];
+                size_t size = static_cast<size_t>(entry.SerialSize);
+
+                Inner.Seek(PackageStart + static_cast<int64_t>(entry.SerialOffset));
+                const uint8_t* inPlace = size ? Inner.ReadInPlace(size) : nullptr;
+                bool serialized = inPlace ? SerializeExport(exportIndex, inPlace, size)
+                    : ReadExportData(exportIndex, data) && SerializeExport(exportIndex, data.data(), data.size());
+                if (!serialized)
+                {
+                    States[exportIndex] = ExportState::Failed;
+                    succeeded = false;
+                }
+            }
+
+            // Creation order puts outers first. PostInitProperties may load more, so finish
+            // from a copy of the list.
+            std::vector<size_t> finishing;
+            finishing.swap(PendingExports);
+            for (size_t exportIndex : finishing)
+            {
+                FinishExport(exportIndex);
+            }
+
+            if (outFinished)
+                outFinished->insert(outFinished->end(), finishing.begin(), finishing.end());
+            return succeeded;
+        }
+
+        Object* PackageLoader::LoadExport(size_t exportIndex, std::vector<size_t>* outFinished)
+        {
+            if (!Valid || exportIndex >= Exports.size())
+                return nullptr;
+
+            if (!ImportsResolved)
+                ResolveImports();
+
+            CreateExport(exportIndex);
+            LoadPendingExports(outFinished);
+
+            const ObjectExport& entry = Exports[exportIndex];
+            return entry.CreatedObject && entry.CreatedObject->HasFlags(ObjectFlags::LoadCompleted) ? entry.CreatedObject : nullptr;
+        }
+
+        bool PackageLoader::LoadAll()
+        {
+            if (!Valid)
+                return false;
+
+            if (!ImportsResolved)
+                ResolveImports();
+
+            bool succeeded = true;
+            for (size_t i = 0; i < Exports.size(); ++i)
+            {
+                if (!CreateExport(i))
+                    succeeded = false;
+            }
+            return LoadPendingExports() && succeeded;
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
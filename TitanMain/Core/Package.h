@@ -0,0 +1,188 @@
+#pragma once
+
+// Titan::Core::Package - Object graphs stored with export and import tables
+// Objects defined by the package are exports, objects it only references are imports.
+// References serialize as a PackageIndex into those tables and are resolved after the
+// referenced objects exist. Every export records where its data lives, so a single object
+// can be loaded without reading the rest of the file.
+//
+// Layout, offsets relative to the start of the package:
+//     Summary  { Magic, Version, DataFlags, NameCount, NameOffset, ImportCount, ImportOffset,
+//                ExportCount, ExportOffset, DataOffset }
+//     Names    (strings referenced by index from the tables)
+//     Imports  { ClassName, ObjectName (full name) }
+//     Exports  { ClassName, ObjectName, Outer, ObjectFlags, SerialOffset, SerialSize }
+//     Data     (Object::Serialize output of every export, back to back)
+//
+// The summary and tables are always fixed width; export data uses the Compact / Delta /
+// StringTable / Versioned flags of the archive the package was saved to. With StringTable, strings in
+// export data are indices into the name table.
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Archive.h"
+#include "Object.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        // Reference into a package: 0 is null, N > 0 export N - 1, N < 0 import -N - 1
+        class PackageIndex
+        {
+        public:
+            PackageIndex() = default;
+            explicit PackageIndex(int32_t index) : Index(index) {}
+
+            static PackageIndex FromExport(size_t exportIndex) { return PackageIndex(static_cast<int32_t>(exportIndex) + 1); }
+            static PackageIndex FromImport(size_t importIndex) { return PackageIndex(-static_cast<int32_t>(importIndex) - 1); }
+
+            bool IsNull() const { return Index == 0; }
+            bool IsExport() const { return Index > 0; }
+            bool IsImport() const { return Index < 0; }
+
+            size_t ToExport() const { return static_cast<size_t>(Index - 1); }
+            size_t ToImport() const { return static_cast<size_t>(-Index - 1); }
+
+            int32_t GetRaw() const { return Index; }
+
+        private:
+            int32_t Index = 0;
+        };
+
+        struct PackageSummary
+        {
+            static constexpr uint32_t Magic = 0x474B5054;   // "TPKG"
+            static constexpr uint32_t Version = 1;
+
+            uint32_t DataFlags = 0;         // ArchiveFlags the export data was written with
+            uint32_t NameCount = 0;
+            uint64_t NameOffset = 0;
+            uint32_t ImportCount = 0;
+            uint64_t ImportOffset = 0;
+            uint32_t ExportCount = 0;
+            uint64_t ExportOffset = 0;
+            uint64_t DataOffset = 0;
+        };
+
+        struct ObjectImport
+        {
+            std::string ClassName;
+            std::string ObjectName;         // Full name, looked up in ObjectRegistry
+            Object* ResolvedObject = nullptr;
+        };
+
+        struct ObjectExport
+        {
+            std::string ClassName;
+            std::string ObjectName;
+            PackageIndex Outer;
+            ObjectFlags Flags = ObjectFlags::None;
+            uint64_t SerialOffset = 0;
+            uint64_t SerialSize = 0;
+            Object* CreatedObject = nullptr;
+        };
+
+        // Object flags kept in the export table
+        constexpr ObjectFlags PersistentObjectFlags = ObjectFlags::Public | ObjectFlags::Standalone;
+
+        // Writes exports and everything they reference to archive. Outers that are not exports
+        // and other referenced objects become imports; references to transient objects are null.
+        bool SavePackage(Archive& archive, const std::vector<Object*>& exports);
+
+        // Reads the summary and tables of a package starting at the archive's current position
+        // and creates exports on request. The archive must outlive the loader.
+        //
+        // Loading an export runs in three steps that may be driven separately:
+        //     CreateExport     instantiates the object, unregistered (outers first)
+        //     SerializeExport  reads its data; references to other exports only need them created
+        //     FinishExport     registers it and calls PostInitProperties
+        // Memory-mapped archives hand export data to SerializeExport in place.
+        class PackageLoader
+        {
+        public:
+            explicit PackageLoader(Archive& archive);
+            ~PackageLoader();
+
+            PackageLoader(const PackageLoader&) = delete;
+            PackageLoader& operator=(const PackageLoader&) = delete;
+
+            bool IsValid() const { return Valid; }
+
+            const PackageSummary& GetSummary() const { return Summary; }
+            const std::vector<std::string>& GetNames() const { return Names; }
+            const std::vector<ObjectImport>& GetImports() const { return Imports; }
+            const std::vector<ObjectExport>& GetExports() const { return Exports; }
+
+            // Loads one export and the exports it references; nullptr on failure. outFinished
+            // receives the index of every export this call finished, the requested one included.
+            Object* LoadExport(size_t exportIndex, std::vector<size_t>* outFinished = nullptr);
+
+            // Loads every export; false if any failed
+            bool LoadAll();
+
+            // Export index of the object with this full name, SIZE_MAX if there is none
+            size_t FindExport(const std::string& fullName) const;
+            std::string GetExportFullName(size_t exportIndex) const;
+
+            // Looks up every import in ObjectRegistry, unresolved imports load as null
+            void ResolveImports();
+
+            Object* CreateExport(size_t exportIndex);
+
+            // Creates every export at once; false if any failed. References resolve to
+            // CreatedObject from then on without reading export states.
+            bool CreateAllExports();
+            bool ReadExportData(size_t exportIndex, std::vector<uint8_t>& data);
+            bool SerializeExport(size_t exportIndex, const uint8_t* data, size_t size);
+            void FinishExport(size_t exportIndex);
+
+            // The object a reference in export data points to, creating exports as needed.
+            // Only a lookup after CreateAllExports, which makes SerializeExport safe to run for
+            // different exports in parallel.
+            Object* ResolveIndex(PackageIndex index);
+
+            // Lazy mode: ObjectPtr references to exports that were not created yet receive the
+            // handle returned here instead of loading them (see LazyLoading.h)
+            using LazyHandleProvider = std::function<uintptr_t(size_t exportIndex)>;
+            void SetLazyHandleProvider(LazyHandleProvider provider) { LazyHandles = std::move(provider); }
+            uintptr_t GetLazyHandle(PackageIndex index) const;
+
+        private:
+            enum class ExportState : uint8_t
+            {
+                None,
+                Created,
+                Serialized,
+                Finished,
+                Failed,
+            };
+
+            bool ReadTables();
+            bool LoadPendingExports(std::vector<size_t>* outFinished = nullptr);
+            bool ReadName(int32_t& index, std::string& name);
+
+            Archive& Inner;
+            int64_t PackageStart = 0;
+            bool Valid = false;
+            bool ImportsResolved = false;
+            bool AllExportsCreated = false;
+
+            PackageSummary Summary;
+            std::vector<std::string> Names;
+            ArchiveStringTable DataStrings;     // Names interned, for StringTable export data
+            std::vector<ObjectImport> Imports;
+            std::vector<ObjectExport> Exports;
+            std::vector<ExportState> States;
+
+            // Exports created by ResolveIndex during LoadExport that still need their data
+            std::vector<size_t> PendingExports;
+            LazyHandleProvider LazyHandles;
+        };
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
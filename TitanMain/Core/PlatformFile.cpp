@@ -0,0 +1,256 @@
+#include "PlatformFile.h"
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <cerrno>
+    #include <cstdio>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Titan
+{
+    namespace Core
+    {
+        namespace PlatformFile
+        {
+#if defined(_WIN32)
+            intptr_t Open(const std::string& filename, bool write)
+            {
+                HANDLE handle = CreateFileA(filename.c_str(),
+                    write ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                    FILE_SHARE_READ,
+                    nullptr,
+                    write ? CREATE_ALWAYS : OPEN_EXISTING,
+                    write ? FILE_ATTRIBUTE_NORMAL : FILE_FLAG_SEQUENTIAL_SCAN,
+                    nullptr);
+                return handle == INVALID_HANDLE_VALUE ? InvalidHandle : reinterpret_cast<intptr_t>(handle);
+            }
+
+            void Close(intptr_t handle)
+            {
+                if (handle != InvalidHandle)
+                    CloseHandle(reinterpret_cast<HANDLE>(handle));
+            }
+
+            int64_t GetSize(intptr_t handle)
+            {
+                LARGE_INTEGER size;
+                return GetFileSizeEx(reinterpret_cast<HANDLE>(handle), &size) ? size.QuadPart : -1;
+            }
+
+            int64_t ReadAt(intptr_t handle, void* data, size_t length, int64_t offset)
+            {
+                size_t done = 0;
+                while (done < length)
+                {
+                    OVERLAPPED overlapped = {};
+                    uint64_t position = static_cast<uint64_t>(offset) + done;
+                    overlapped.Offset = static_cast<DWORD>(position);
+                    overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+                    DWORD chunk = static_cast<DWORD>(length - done > 0x40000000 ? 0x40000000 : length - done);
+                    DWORD read = 0;
+                    if (!ReadFile(reinterpret_cast<HANDLE>(handle), static_cast<uint8_t*>(data) + done, chunk, &read, &overlapped))
+                        return GetLastError() == ERROR_HANDLE_EOF ? static_cast<int64_t>(done) : -1;
+                    if (read == 0)
+                        break;
+                    done += read;
+                }
+                return static_cast<int64_t>(done);
+            }
+
+            int64_t WriteAt(intptr_t handle, const void* data, size_t length, int64_t offset)
+            {
+                size_t done = 0;
+                while (done < length)
+                {
+                    OVERLAPPED overlapped = {};
+                    uint64_t position = static_cast<uint64_t>(offset) + done;
+                    overlapped.Offset = static_cast<DWORD>(position);
+                    overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+                    DWORD chunk = static_cast<DWORD>(length - done > 0x40000000 ? 0x40000000 : length - done);
+                    DWORD written = 0;
+                    if (!WriteFile(reinterpret_cast<HANDLE>(handle), static_cast<const uint8_t*>(data) + done, chunk, &written, &overlapped))
+                        return -1;
+                    done += written;
+                }
+                return static_cast<int64_t>(done);
+            }
+
+            bool Sync(intptr_t handle)
+            {
+                return FlushFileBuffers(reinterpret_cast<HANDLE>(handle)) != 0;
+            }
+
+            bool Rename(const std::string& from, const std::string& to)
+            {
+                return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+            }
+
+            MappedRegion Map(intptr_t handle, size_t size)
+            {
+                MappedRegion region;
+                if (handle == InvalidHandle || size == 0)
+                    return region;
+
+                HANDLE mapping = CreateFileMappingA(reinterpret_cast<HANDLE>(handle), nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (!mapping)
+                    return region;
+
+                void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+                if (!view)
+                {
+                    CloseHandle(mapping);
+                    return region;
+                }
+
+                region.Data = static_cast<const uint8_t*>(view);
+                region.Size = size;
+                region.MappingHandle = reinterpret_cast<intptr_t>(mapping);
+                return region;
+            }
+
+            void Unmap(MappedRegion& region)
+            {
+                if (region.Data)
+                    UnmapViewOfFile(region.Data);
+                if (region.MappingHandle != InvalidHandle)
+                    CloseHandle(reinterpret_cast<HANDLE>(region.MappingHandle));
+                region = MappedRegion();
+            }
+
+            void Advise(const MappedRegion& region, size_t offset, size_t length, AccessHint hint)
+            {
+                if (!region.Data || offset >= region.Size || hint != AccessHint::WillNeed)
+                    return;
+
+                // Windows has no sequential hint for views; prefetch covers WillNeed
+                WIN32_MEMORY_RANGE_ENTRY range;
+                range.VirtualAddress = const_cast<uint8_t*>(region.Data + offset);
+                range.NumberOfBytes = length < region.Size - offset ? length : region.Size - offset;
+                PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+            }
+#else
+            intptr_t Open(const std::string& filename, bool write)
+            {
+                int fd = write ? ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)
+                               : ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+                return fd < 0 ? InvalidHandle : static_cast<intptr_t>(fd);
+            }
+
+            void Close(intptr_t handle)
+            {
+                if (handle != InvalidHandle)
+                    ::close(static_cast<int>(handle));
+            }
+
+            int64_t GetSize(intptr_t handle)
+            {
+                struct stat info;
+                return ::fstat(static_cast<int>(handle), &info) == 0 ? static_cast<int64_t>(info.st_size) : -1;
+            }
+
+            int64_t ReadAt(intptr_t handle, void* data, size_t length, int64_t offset)
+            {
+                size_t done = 0;
+                while (done < length)
+                {
+                    ssize_t read = ::pread(static_cast<int>(handle), static_cast<uint8_t*>(data) + done, length - done, static_cast<off_t>(offset + done));
+                    if (read < 0)
+                    {
+                        if (errno == EINTR)
+                            continue;
+                        return -1;
+                    }
+                    if (read == 0)
+                        break;
+                    done += static_cast<size_t>(read);
+                }
+                return static_cast<int64_t>(done);
+            }
+
+            int64_t WriteAt(intptr_t handle, const void* data, size_t length, int64_t offset)
+            {
+                size_t done = 0;
+                while (done < length)
+                {
+                    ssize_t written = ::pwrite(static_cast<int>(handle), static_cast<const uint8_t*>(data) + done, length - done, static_cast<off_t>(offset + done));
+                    if (written < 0)
+                    {
+                        if (errno == EINTR)
+                            continue;
+                        return -1;
+                    }
+                    done += static_cast<size_t>(written);
+                }
+                return static_cast<int64_t>(done);
+            }
+
+            bool Sync(intptr_t handle)
+            {
+                return ::fsync(static_cast<int>(handle)) == 0;
+            }
+
+            bool Rename(const std::string& from, const std::string& to)
+            {
+                if (::rename(from.c_str(), to.c_str()) != 0)
+                    return false;
+
+                // The new directory entry is only durable once the directory itself is synced
+                size_t separator = to.find_last_of('/');
+                std::string directory = separator == std::string::npos ? "." : separator == 0 ? "/" : to.substr(0, separator);
+                int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+                if (fd >= 0)
+                {
+                    ::fsync(fd);
+                    ::close(fd);
+                }
+                return true;
+            }
+
+            MappedRegion Map(intptr_t handle, size_t size)
+            {
+                MappedRegion region;
+                if (handle == InvalidHandle || size == 0)
+                    return region;
+
+                void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, static_cast<int>(handle), 0);
+                if (data == MAP_FAILED)
+                    return region;
+
+                region.Data = static_cast<const uint8_t*>(data);
+                region.Size = size;
+                return region;
+            }
+
+            void Unmap(MappedRegion& region)
+            {
+                if (region.Data)
+                    ::munmap(const_cast<uint8_t*>(region.Data), region.Size);
+                region = MappedRegion();
+            }
+
+            void Advise(const MappedRegion& region, size_t offset, size_t length, AccessHint hint)
+            {
+                if (!region.Data || offset >= region.Size)
+                    return;
+
+                // madvise wants a page-aligned start
+                size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+                size_t begin = offset & ~(pageSize - 1);
+                size_t end = length < region.Size - offset ? offset + length : region.Size;
+                ::madvise(const_cast<uint8_t*>(region.Data) + begin, end - begin,
+                    hint == AccessHint::Sequential ? MADV_SEQUENTIAL : MADV_WILLNEED);
+            }
+#endif
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+// Titan::Core::PlatformFile - Thin positional file I/O over the OS API
+// Handles are plain integers so they can be shared with background I/O threads
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Titan
+{
+    namespace Core
+    {
+        namespace PlatformFile
+        {
+            constexpr intptr_t InvalidHandle = -1;
+
+            // Opens for reading, or creates/truncates for writing (written files stay readable)
+            intptr_t Open(const std::string& filename, bool write);
+            void Close(intptr_t handle);
+
+            int64_t GetSize(intptr_t handle);
+
+            // Full-length positional transfers, retried until done; return bytes moved or -1 on error
+            int64_t ReadAt(intptr_t handle, void* data, size_t length, int64_t offset);
+            int64_t WriteAt(intptr_t handle, const void* data, size_t length, int64_t offset);
+
+            // Returns once everything written through handle is on the storage device
+            bool Sync(intptr_t handle);
+
+            // Moves from over to, replacing it in one step; a crash leaves either the old or the new file
+            bool Rename(const std::string& from, const std::string& to);
+
+            // Read-only view of the first size bytes, nullptr on failure. The mapping stays valid
+            // after the handle is closed and must be released with Unmap.
+            struct MappedRegion
+            {
+                const uint8_t* Data = nullptr;
+                size_t Size = 0;
+                intptr_t MappingHandle = InvalidHandle;   // Windows file mapping object
+            };
+
+            MappedRegion Map(intptr_t handle, size_t size);
+            void Unmap(MappedRegion& region);
+
+            enum class AccessHint : uint8_t
+            {
+                Sequential,     // Read front to back, aggressive read-ahead
+                WillNeed,       // Start paging the range in now
+            };
+
+            // Paging hint for part of a mapped region; a no-op where unsupported
+            void Advise(const MappedRegion& region, size_t offset, size_t length, AccessHint hint);
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,168 @@
+#pragma once
+
+// Titan::Core::Property - Minimal reflected property descriptions
+// Classes and structs register their members so generic code (GC, serialization) can walk them
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Titan
+{
+    namespace Core
+    {
+        class Object;
+        template<typename T> class ObjectPtr;
+        struct StructInfo;
+
+        enum class PropertyType : uint8_t
+        {
+            None,
+            Bool,
+            Int8,
+            UInt8,
+            Int16,
+            UInt16,
+            Int32,
+            UInt32,
+            Int64,
+            UInt64,
+            Float,
+            Double,
+            String,         // std::string
+            Object,         // Object* or ObjectPtr<T>, both a single pointer
+            ObjectArray,    // std::vector<ObjectPtr<T>> or std::vector<T*>
+            Struct,         // Nested struct described by Property::Struct
+            StructArray,    // std::vector of a struct described by Property::Struct
+        };
+
+        struct Property
+        {
+            std::string Name;
+            PropertyType Type = PropertyType::None;
+            uint32_t Offset = 0;                // From the start of the owning object or struct
+            uint32_t Size = 0;                  // sizeof the member
+            const StructInfo* Struct = nullptr; // Struct and StructArray only
+            bool IsObjectPtr = false;           // Object / ObjectArray held through ObjectPtr<T>
+            void (*ResizeArray)(void* array, size_t count) = nullptr;  // Array types only
+            uint8_t* (*GetArrayData)(void* array, size_t& outCount) = nullptr;  // Array types only, first element
+        };
+
+        // Layout of a plain struct used as a property
+        struct StructInfo
+        {
+            std::string Name;
+            uint32_t Size = 0;
+            std::vector<Property> Properties;
+        };
+
+        // Maps a member type to its PropertyType
+        template<typename T, typename = void>
+        struct PropertyTypeOf { static constexpr PropertyType Value = PropertyType::None; };
+
+        template<> struct PropertyTypeOf<bool> { static constexpr PropertyType Value = PropertyType::Bool; };
+        template<> struct PropertyTypeOf<int8_t> { static constexpr PropertyType Value = PropertyType::Int8; };
+        template<> struct PropertyTypeOf<uint8_t> { static constexpr PropertyType Value = PropertyType::UInt8; };
+        template<> struct PropertyTypeOf<int16_t> { static constexpr PropertyType Value = PropertyType::Int16; };
+        template<> struct PropertyTypeOf<uint16_t> { static constexpr PropertyType Value = PropertyType::UInt16; };
+        template<> struct PropertyTypeOf<int32_t> { static constexpr PropertyType Value = PropertyType::Int32; };
+        template<> struct PropertyTypeOf<uint32_t> { static constexpr PropertyType Value = PropertyType::UInt32; };
+        template<> struct PropertyTypeOf<int64_t> { static constexpr PropertyType Value = PropertyType::Int64; };
+        template<> struct PropertyTypeOf<uint64_t> { static constexpr PropertyType Value = PropertyType::UInt64; };
+        template<> struct PropertyTypeOf<float> { static constexpr PropertyType Value = PropertyType::Float; };
+        template<> struct PropertyTypeOf<double> { static constexpr PropertyType Value = PropertyType::Double; };
+        template<> struct PropertyTypeOf<std::string> { static constexpr PropertyType Value = PropertyType::String; };
+
+        template<typename T>
+        struct PropertyTypeOf<T*, std::enable_if_t<std::is_base_of<Object, T>::value>> { static constexpr PropertyType Value = PropertyType::Object; };
+
+        template<typename T>
+        struct PropertyTypeOf<ObjectPtr<T>> { static constexpr PropertyType Value = PropertyType::Object; };
+
+        template<typename T>
+        struct PropertyTypeOf<std::vector<ObjectPtr<T>>> { static constexpr PropertyType Value = PropertyType::ObjectArray; };
+
+        template<typename T>
+        struct PropertyTypeOf<std::vector<T*>, std::enable_if_t<std::is_base_of<Object, T>::value>> { static constexpr PropertyType Value = PropertyType::ObjectArray; };
+
+        template<typename T>
+        struct IsPropertyArray : std::false_type {};
+
+        template<typename T, typename Allocator>
+        struct IsPropertyArray<std::vector<T, Allocator>> : std::true_type {};
+
+        template<typename T>
+        struct IsObjectPtrProperty : std::false_type {};
+
+        template<typename T>
+        struct IsObjectPtrProperty<ObjectPtr<T>> : std::true_type {};
+
+        template<typename T>
+        struct IsObjectPtrProperty<std::vector<ObjectPtr<T>>> : std::true_type {};
+
+        // Let generic code size arrays and reach their elements without knowing the element type
+        template<typename ArrayType>
+        void ResizePropertyArray(void* array, size_t count)
+        {
+            static_cast<ArrayType*>(array)->resize(count);
+        }
+
+        template<typename ArrayType>
+        uint8_t* GetPropertyArrayData(void* array, size_t& outCount)
+        {
+            ArrayType& typed = *static_cast<ArrayType*>(array);
+            outCount = typed.size();
+            return reinterpret_cast<uint8_t*>(typed.data());
+        }
+
+        template<typename MemberType>
+        Property MakeProperty(const char* name, size_t offset)
+        {
+            static_assert(PropertyTypeOf<MemberType>::Value != PropertyType::None,
+                "Unsupported property type, use TITAN_STRUCT_PROPERTY for structs");
+
+            Property property;
+            property.Name = name;
+            property.Type = PropertyTypeOf<MemberType>::Value;
+            property.Offset = static_cast<uint32_t>(offset);
+            property.Size = static_cast<uint32_t>(sizeof(MemberType));
+            property.IsObjectPtr = IsObjectPtrProperty<MemberType>::value;
+            if constexpr (IsPropertyArray<MemberType>::value)
+            {
+                property.ResizeArray = &ResizePropertyArray<MemberType>;
+                property.GetArrayData = &GetPropertyArrayData<MemberType>;
+            }
+            return property;
+        }
+
+        template<typename MemberType>
+        Property MakeStructProperty(const char* name, size_t offset, const StructInfo* structInfo)
+        {
+            Property property;
+            property.Name = name;
+            property.Type = IsPropertyArray<MemberType>::value ? PropertyType::StructArray : PropertyType::Struct;
+            property.Offset = static_cast<uint32_t>(offset);
+            property.Size = static_cast<uint32_t>(sizeof(MemberType));
+            property.Struct = structInfo;
+            if constexpr (IsPropertyArray<MemberType>::value)
+            {
+                property.ResizeArray = &ResizePropertyArray<MemberType>;
+                property.GetArrayData = &GetPropertyArrayData<MemberType>;
+            }
+            return property;
+        }
+
+        // Describe a member for Class::AddProperty / StructInfo::Properties
+        // e.g. MyActor::StaticClass()->AddProperty(TITAN_PROPERTY(MyActor, Target));
+        #define TITAN_PROPERTY(OwnerType, Member) \
+            ::Titan::Core::MakeProperty<decltype(OwnerType::Member)>(#Member, offsetof(OwnerType, Member))
+
+        // Member is a struct or std::vector of a struct described by StructInfoPtr
+        #define TITAN_STRUCT_PROPERTY(OwnerType, Member, StructInfoPtr) \
+            ::Titan::Core::MakeStructProperty<decltype(OwnerType::Member)>(#Member, offsetof(OwnerType, Member), StructInfoPtr)
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,624 @@
+#include "PropertySerialization.h"
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "Object.h"
+#include "TextArchive.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        // Encodes object references as raw pointers so snapshots compare and restore identity
+        class SnapshotArchive : public MemoryArchive
+        {
+        public:
+            SnapshotArchive() : MemoryArchive(false) {}
+            SnapshotArchive(const void* data, size_t size) : MemoryArchive(data, size) {}
+
+            virtual void SerializeObject(Object*& object) override
+            {
+                Serialize(&object, sizeof(object));
+            }
+
+            virtual void WriteObjectReference(Archive& target, Object* object) override
+            {
+                target.Serialize(&object, sizeof(object));
+            }
+
+            // Lazy references stay unloaded
+            virtual void SerializeObjectPtr(ObjectPtr<Object>& objectPtr) override
+            {
+                uintptr_t value = objectPtr.IsLoaded() ? reinterpret_cast<uintptr_t>(objectPtr.Get()) : objectPtr.GetLazyHandle();
+                Serialize(&value, sizeof(value));
+                if (IsLoading())
+                {
+                    objectPtr = IsLazyObjectHandle(reinterpret_cast<Object*>(value))
+                        ? ObjectPtr<Object>::FromLazyHandle(value) : ObjectPtr<Object>(reinterpret_cast<Object*>(value));
+                }
+            }
+        };
+
+        template<typename T>
+        static void SerializeValue(Archive& archive, uint8_t* address)
+        {
+            archive << *reinterpret_cast<T*>(address);
+        }
+
+        // Elements of the array property at address, through the Property's thunk
+        static uint8_t* GetArrayData(const Property& property, uint8_t* address, uint64_t& count)
+        {
+            size_t size = 0;
+            uint8_t* data = property.GetArrayData ? property.GetArrayData(address, size) : nullptr;
+            count = size;
+            return data;
+        }
+
+        // Writes the element count or reads it and resizes the array; false on a bad count
+        static bool SerializeArrayCount(Archive& archive, const Property& property, uint8_t* address, uint64_t& count)
+        {
+            GetArrayData(property, address, count);
+            archive.SerializeCount(count);
+            if (!archive.IsLoading())
+                return true;
+
+            // Every element takes at least one byte
+            int64_t remaining = archive.TotalSize() - archive.Tell();
+            if (archive.HasError() || !property.ResizeArray || count > static_cast<uint64_t>(remaining > 0 ? remaining : 0))
+            {
+                archive.SetError();
+                return false;
+            }
+            property.ResizeArray(address, static_cast<size_t>(count));
+            return true;
+        }
+
+        static void SerializeObjectReference(Archive& archive, const Property& property, uint8_t* address)
+        {
+            if (property.IsObjectPtr)
+                archive.SerializeObjectPtr(*reinterpret_cast<ObjectPtr<Object>*>(address));
+            else
+                archive.SerializeObject(*reinterpret_cast<Object**>(address));
+        }
+
+        void SerializeProperty(Archive& archive, const Property& property, void* container)
+        {
+            uint8_t* address = static_cast<uint8_t*>(container) + property.Offset;
+            switch (property.Type)
+            {
+            case PropertyType::Bool:    SerializeValue<bool>(archive, address); break;
+            case PropertyType::Int8:    SerializeValue<int8_t>(archive, address); break;
+            case PropertyType::UInt8:   SerializeValue<uint8_t>(archive, address); break;
+            case PropertyType::Int16:   SerializeValue<int16_t>(archive, address); break;
+            case PropertyType::UInt16:  SerializeValue<uint16_t>(archive, address); break;
+            case PropertyType::Int32:   SerializeValue<int32_t>(archive, address); break;
+            case PropertyType::UInt32:  SerializeValue<uint32_t>(archive, address); break;
+            case PropertyType::Int64:   SerializeValue<int64_t>(archive, address); break;
+            case PropertyType::UInt64:  SerializeValue<uint64_t>(archive, address); break;
+            case PropertyType::Float:   SerializeValue<float>(archive, address); break;
+            case PropertyType::Double:  SerializeValue<double>(archive, address); break;
+            case PropertyType::String:  SerializeValue<std::string>(archive, address); break;
+            case PropertyType::Object:
+                SerializeObjectReference(archive, property, address);
+                break;
+            case PropertyType::ObjectArray:
+            {
+                uint64_t count;
+                if (!SerializeArrayCount(archive, property, address, count))
+                    break;
+
+                uint8_t* elements = GetArrayData(property, address, count);
+                for (uint64_t i = 0; i < count && !archive.HasError(); ++i)
+                {
+                    SerializeObjectReference(archive, property, elements + i * sizeof(Object*));
+                }
+                break;
+            }
+            case PropertyType::Struct:
+                if (property.Struct)
+                {
+                    for (const Property& member : property.Struct->Properties)
+                    {
+                        SerializeProperty(archive, member, address);
+                    }
+                }
+                break;
+            case PropertyType::StructArray:
+            {
+                uint64_t count;
+                if (!property.Struct || !SerializeArrayCount(archive, property, address, count))
+                    break;
+
+                uint8_t* elements = GetArrayData(property, address, count);
+                for (uint64_t i = 0; i < count && !archive.HasError(); ++i)
+                {
+                    for (const Property& member : property.Struct->Properties)
+                    {
+                        SerializeProperty(archive, member, elements + i * property.Struct->Size);
+                    }
+                }
+                break;
+            }
+            case PropertyType::None:
+                break;
+            }
+        }
+
+        static void SerializeVersioned(Archive& archive, Object* object);
+
+        static const Property& GetListedProperty(const Property* property) { return *property; }
+        static const Property& GetListedProperty(const Property& property) { return property; }
+
+        static void SerializeTextValue(TextArchive& archive, const Property& property, uint8_t* container);
+
+        // One JSON object keyed by property name. Loading looks each key up starting after the
+        // previous match, so files in declaration order match on the first compare.
+        template<typename PropertyList>
+        static void SerializeTextFields(TextArchive& archive, const PropertyList& properties, uint8_t* container)
+        {
+            if (!archive.BeginObject())
+                return;
+
+            if (archive.IsSaving())
+            {
+                for (const auto& entry : properties)
+                {
+                    const Property& property = GetListedProperty(entry);
+                    archive.WriteKey(property.Name);
+                    SerializeTextValue(archive, property, container);
+                }
+            }
+            else
+            {
+                std::string key;
+                size_t next = 0;
+                while (archive.ReadKey(key))
+                {
+                    const Property* found = nullptr;
+                    for (size_t i = 0; i < properties.size() && !found; ++i)
+                    {
+                        size_t candidate = (next + i) % properties.size();
+                        if (GetListedProperty(properties[candidate]).Name == key)
+                        {
+                            found = &GetListedProperty(properties[candidate]);
+                            next = candidate + 1;
+                        }
+                    }
+
+                    if (found)
+                        SerializeTextValue(archive, *found, container);
+                    else
+                        archive.SkipValue();
+                }
+            }
+            archive.EndObject();
+        }
+
+        static void SerializeTextValue(TextArchive& archive, const Property& property, uint8_t* container)
+        {
+            uint8_t* address = container + property.Offset;
+            switch (property.Type)
+            {
+            case PropertyType::ObjectArray:
+            case PropertyType::StructArray:
+            {
+                bool isStruct = property.Type == PropertyType::StructArray;
+                if (isStruct && !property.Struct)
+                    break;
+
+                size_t elementSize = isStruct ? property.Struct->Size : sizeof(Object*);
+                uint64_t count;
+                GetArrayData(property, address, count);
+                if (!archive.BeginArray(count))
+                    break;
+
+                // Each element takes at least one index entry, so count is bounded by the text
+                if (archive.IsLoading())
+                {
+                    if (!property.ResizeArray)
+                    {
+                        archive.SetError();
+                        break;
+                    }
+                    property.ResizeArray(address, static_cast<size_t>(count));
+                }
+
+                uint8_t* elements = GetArrayData(property, address, count);
+                for (uint64_t i = 0; i < count && !archive.HasError(); ++i)
+                {
+                    if (isStruct)
+                        SerializeTextFields(archive, property.Struct->Properties, elements + i * elementSize);
+                    else
+                        SerializeObjectReference(archive, property, elements + i * elementSize);
+                }
+                archive.EndArray();
+                break;
+            }
+            case PropertyType::Struct:
+                if (property.Struct)
+                    SerializeTextFields(archive, property.Struct->Properties, address);
+                break;
+            default:
+                SerializeProperty(archive, property, container);
+                break;
+            }
+        }
+
+        void SerializeProperties(Archive& archive, Object* object)
+        {
+            Class* objectClass = object ? object->GetClass() : nullptr;
+            if (!objectClass)
+                return;
+
+            if (TextArchive* text = archive.AsTextArchive())
+            {
+                SerializeTextFields(*text, objectClass->GetAllProperties(), reinterpret_cast<uint8_t*>(object));
+                return;
+            }
+
+            if (archive.IsDelta())
+            {
+                SerializeDelta(archive, object, archive.FindDeltaBaseline(object));
+                return;
+            }
+
+            if (archive.IsVersioned())
+            {
+                SerializeVersioned(archive, object);
+                return;
+            }
+
+            for (const Property* property : objectClass->GetAllProperties())
+            {
+                SerializeProperty(archive, *property, object);
+            }
+        }
+
+        // PropertySnapshot implementation
+
+        PropertySnapshot::PropertySnapshot(const Object* object)
+            : ObjectClass(object ? object->GetClass() : nullptr)
+        {
+            if (!ObjectClass)
+                return;
+
+            const std::vector<const Property*>& properties = const_cast<Class*>(ObjectClass)->GetAllProperties();
+            SnapshotArchive archive;
+            Offsets.reserve(properties.size() + 1);
+            for (const Property* property : properties)
+            {
+                Offsets.push_back(static_cast<size_t>(archive.Tell()));
+                SerializeProperty(archive, *property, const_cast<Object*>(object));
+            }
+            Offsets.push_back(static_cast<size_t>(archive.Tell()));
+            Data = std::move(archive.GetData());
+        }
+
+        void PropertySnapshot::ApplyTo(Object* object, size_t index) const
+        {
+            const std::vector<const Property*>& properties = const_cast<Class*>(ObjectClass)->GetAllProperties();
+            if (!object || index >= properties.size() || index >= GetNumProperties())
+                return;
+
+            SnapshotArchive archive(GetPropertyData(index), GetPropertySize(index));
+            SerializeProperty(archive, *properties[index], object);
+        }
+
+        // Snapshots of class default objects, taken on first use
+        static const PropertySnapshot* GetDefaultSnapshot(Class* objectClass)
+        {
+            static std::mutex mutex;
+            static std::unordered_map<const Class*, std::unique_ptr<PropertySnapshot>> snapshots;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            std::unique_ptr<PropertySnapshot>& snapshot = snapshots[objectClass];
+            // Retake it if properties were registered since
+            if (!snapshot || snapshot->GetNumProperties() != objectClass->GetAllProperties().size())
+            {
+                Object* defaultObject = objectClass->GetDefaultObject();
+                snapshot = defaultObject ? std::make_unique<PropertySnapshot>(defaultObject) : nullptr;
+            }
+            return snapshot.get();
+        }
+
+        void SerializeDelta(Archive& archive, Object* object, const PropertySnapshot* baseline)
+        {
+            Class* objectClass = object ? object->GetClass() : nullptr;
+            if (!objectClass)
+                return;
+
+            const std::vector<const Property*>& properties = objectClass->GetAllProperties();
+            if (!baseline || baseline->GetClass() != objectClass || baseline->GetNumProperties() != properties.size())
+                baseline = GetDefaultSnapshot(objectClass);
+
+            // Header: property count, then one changed bit per property in 64-bit words
+            uint64_t numProperties = properties.size();
+            archive.SerializeCount(numProperties);
+            if (archive.IsLoading() && numProperties != properties.size())
+            {
+                archive.SetError();
+                return;
+            }
+
+            std::vector<uint64_t> changed((properties.size() + 63) / 64, 0);
+            if (archive.IsSaving())
+            {
+                SnapshotArchive scratch;
+                for (size_t i = 0; i < properties.size(); ++i)
+                {
+                    scratch.Seek(0);
+                    scratch.GetData().clear();
+                    SerializeProperty(scratch, *properties[i], object);
+
+                    const std::vector<uint8_t>& current = scratch.GetData();
+                    bool same = baseline && baseline->GetPropertySize(i) == current.size()
+                        && (current.empty() || std::memcmp(baseline->GetPropertyData(i), current.data(), current.size()) == 0);
+                    if (!same)
+                        changed[i / 64] |= uint64_t(1) << (i % 64);
+                }
+            }
+
+            for (uint64_t& word : changed)
+            {
+                archive << word;
+            }
+            if (archive.HasError())
+                return;
+
+            for (size_t i = 0; i < properties.size(); ++i)
+            {
+                if (changed[i / 64] & (uint64_t(1) << (i % 64)))
+                    SerializeProperty(archive, *properties[i], object);
+                else if (archive.IsLoading() && baseline)
+                    baseline->ApplyTo(object, i);
+            }
+        }
+
+        // PropertyLayout implementation
+
+        static bool IsTriviallyCopyable(PropertyType type)
+        {
+            return type >= PropertyType::Bool && type <= PropertyType::Double;
+        }
+
+        static uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+        {
+            // FNV-1a
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+            }
+            return hash;
+        }
+
+        static void FlattenProperties(PropertyLayout& layout, const std::vector<const Property*>& properties, uint32_t baseOffset)
+        {
+            for (const Property* property : properties)
+            {
+                uint32_t offset = baseOffset + property->Offset;
+                uint8_t type = static_cast<uint8_t>(property->Type);
+                layout.Hash = HashBytes(layout.Hash, property->Name.data(), property->Name.size());
+                layout.Hash = HashBytes(layout.Hash, &type, sizeof(type));
+                layout.Hash = HashBytes(layout.Hash, &offset, sizeof(offset));
+                layout.Hash = HashBytes(layout.Hash, &property->Size, sizeof(property->Size));
+
+                if (IsTriviallyCopyable(property->Type))
+                {
+                    if (!layout.CopyRuns.empty() && layout.CopyRuns.back().Offset + layout.CopyRuns.back().Size == offset)
+                        layout.CopyRuns.back().Size += property->Size;
+                    else
+                        layout.CopyRuns.push_back({ offset, property->Size });
+                    layout.CopySize += property->Size;
+                }
+                else if (property->Type == PropertyType::Struct && property->Struct)
+                {
+                    std::vector<const Property*> members;
+                    for (const Property& member : property->Struct->Properties)
+                    {
+                        members.push_back(&member);
+                    }
+                    FlattenProperties(layout, members, offset);
+                }
+                else if (property->Type != PropertyType::None)
+                {
+                    if (property->Type == PropertyType::StructArray && property->Struct)
+                    {
+                        uint64_t elementHash = GetPropertyLayout(property->Struct).Hash;
+                        layout.Hash = HashBytes(layout.Hash, &elementHash, sizeof(elementHash));
+                    }
+                    layout.Slots.push_back(*property);
+                    layout.Slots.back().Offset = offset;
+                }
+            }
+        }
+
+        // Layouts are handed out by reference and never freed
+        static std::recursive_mutex& GetLayoutMutex()
+        {
+            static std::recursive_mutex mutex;
+            return mutex;
+        }
+
+        const PropertyLayout& GetPropertyLayout(Class* objectClass)
+        {
+            static std::unordered_map<const Class*, std::unique_ptr<PropertyLayout>> layouts;
+
+            std::lock_guard<std::recursive_mutex> lock(GetLayoutMutex());
+            const std::vector<const Property*>& properties = objectClass->GetAllProperties();
+            std::unique_ptr<PropertyLayout>& layout = layouts[objectClass];
+            if (!layout || layout->NumProperties != properties.size())
+            {
+                auto built = std::make_unique<PropertyLayout>();
+                built->Hash = 0xcbf29ce484222325ull;
+                built->NumProperties = properties.size();
+                FlattenProperties(*built, properties, 0);
+                if (layout)
+                    *layout = std::move(*built);
+                else
+                    layout = std::move(built);
+            }
+            return *layout;
+        }
+
+        const PropertyLayout& GetPropertyLayout(const StructInfo* structInfo)
+        {
+            static std::unordered_map<const StructInfo*, std::unique_ptr<PropertyLayout>> layouts;
+
+            std::lock_guard<std::recursive_mutex> lock(GetLayoutMutex());
+            std::unique_ptr<PropertyLayout>& layout = layouts[structInfo];
+            if (!layout || layout->NumProperties != structInfo->Properties.size())
+            {
+                std::vector<const Property*> properties;
+                for (const Property& property : structInfo->Properties)
+                {
+                    properties.push_back(&property);
+                }
+
+                auto built = std::make_unique<PropertyLayout>();
+                built->Hash = HashBytes(0xcbf29ce484222325ull, structInfo->Name.data(), structInfo->Name.size());
+                built->NumProperties = properties.size();
+                FlattenProperties(*built, properties, 0);
+                if (layout)
+                    *layout = std::move(*built);
+                else
+                    layout = std::move(built);
+            }
+            return *layout;
+        }
+
+        // Versioned records
+
+        struct PropertyTag
+        {
+            uint32_t Id = 0;
+            uint8_t Type = 0;
+            uint64_t Size = 0;
+        };
+
+        // Written as raw bytes so the header stays fixed width in Compact archives
+        static constexpr size_t PropertyTagSize = sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint64_t);
+
+        static void WriteTag(const PropertyTag& tag, uint8_t* output)
+        {
+            std::memcpy(output, &tag.Id, sizeof(tag.Id));
+            std::memcpy(output + sizeof(tag.Id), &tag.Type, sizeof(tag.Type));
+            std::memcpy(output + sizeof(tag.Id) + sizeof(tag.Type), &tag.Size, sizeof(tag.Size));
+        }
+
+        static PropertyTag ReadTag(const uint8_t* input)
+        {
+            PropertyTag tag;
+            std::memcpy(&tag.Id, input, sizeof(tag.Id));
+            std::memcpy(&tag.Type, input + sizeof(tag.Id), sizeof(tag.Type));
+            std::memcpy(&tag.Size, input + sizeof(tag.Id) + sizeof(tag.Type), sizeof(tag.Size));
+            return tag;
+        }
+
+        // A struct property whose struct changed gets a new id, so old data for it is skipped
+        static uint32_t GetPropertyTagId(const Property& property)
+        {
+            uint64_t hash = HashBytes(0xcbf29ce484222325ull, property.Name.data(), property.Name.size());
+            if (property.Struct && (property.Type == PropertyType::Struct || property.Type == PropertyType::StructArray))
+            {
+                uint64_t structHash = GetPropertyLayout(property.Struct).Hash;
+                hash = HashBytes(hash, &structHash, sizeof(structHash));
+            }
+            return static_cast<uint32_t>(hash ^ (hash >> 32));
+        }
+
+        static void SerializeVersioned(Archive& archive, Object* object)
+        {
+            Class* objectClass = object->GetClass();
+            const std::vector<const Property*>& properties = objectClass->GetAllProperties();
+            uint64_t schemaHash = GetPropertyLayout(objectClass).Hash;
+
+            if (archive.IsSaving())
+            {
+                // Sizes are only known once written, so the properties go through a buffer first.
+                // The record is then written front to back, which compressed archives require.
+                ArchiveBuffer data(archive);
+                std::vector<uint8_t> tags(properties.size() * PropertyTagSize);
+                for (size_t i = 0; i < properties.size(); ++i)
+                {
+                    int64_t start = data.Tell();
+                    SerializeProperty(data, *properties[i], object);
+
+                    PropertyTag tag;
+                    tag.Id = GetPropertyTagId(*properties[i]);
+                    tag.Type = static_cast<uint8_t>(properties[i]->Type);
+                    tag.Size = static_cast<uint64_t>(data.Tell() - start);
+                    WriteTag(tag, tags.data() + i * PropertyTagSize);
+                }
+                if (data.HasError())
+                    archive.SetError();
+
+                uint32_t numTags = static_cast<uint32_t>(properties.size());
+                archive.Serialize(&schemaHash, sizeof(schemaHash));
+                archive.Serialize(&numTags, sizeof(numTags));
+                if (!tags.empty())
+                    archive.Serialize(tags.data(), tags.size());
+                if (!data.GetData().empty())
+                    archive.Serialize(data.GetData().data(), data.GetData().size());
+                return;
+            }
+
+            uint64_t savedHash = 0;
+            uint32_t numTags = 0;
+            archive.Serialize(&savedHash, sizeof(savedHash));
+            archive.Serialize(&numTags, sizeof(numTags));
+            if (archive.HasError() || numTags > static_cast<uint64_t>(archive.TotalSize() - archive.Tell()) / PropertyTagSize)
+            {
+                archive.SetError();
+                return;
+            }
+
+            // Fast path: same layout as the writer, the tags are not needed
+            if (savedHash == schemaHash && numTags == properties.size())
+            {
+                archive.Seek(archive.Tell() + static_cast<int64_t>(numTags * PropertyTagSize));
+                for (const Property* property : properties)
+                {
+                    SerializeProperty(archive, *property, object);
+                }
+                return;
+            }
+
+            std::vector<uint8_t> tags(numTags * PropertyTagSize);
+            if (!tags.empty())
+                archive.Serialize(tags.data(), tags.size());
+
+            for (uint32_t i = 0; i < numTags && !archive.HasError(); ++i)
+            {
+                PropertyTag tag = ReadTag(tags.data() + i * PropertyTagSize);
+                int64_t start = archive.Tell();
+                if (tag.Size > static_cast<uint64_t>(archive.TotalSize() - start))
+                {
+                    archive.SetError();
+                    return;
+                }
+
+                for (const Property* property : properties)
+                {
+                    if (static_cast<uint8_t>(property->Type) == tag.Type && GetPropertyTagId(*property) == tag.Id)
+                    {
+                        SerializeProperty(archive, *property, object);
+                        break;
+                    }
+                }
+
+                // Unknown properties are skipped, known ones must have read exactly their size
+                int64_t end = start + static_cast<int64_t>(tag.Size);
+                if (archive.Tell() > end)
+                {
+                    archive.SetError();
+                    return;
+                }
+                archive.Seek(end);
+            }
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
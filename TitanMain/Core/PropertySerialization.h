@@ -0,0 +1,87 @@
+#pragma once
+
+// Titan::Core::PropertySerialization - Archive I/O driven by reflected properties
+// Object::Serialize writes every property by default. In ArchiveFlags::Delta archives each
+// object writes a changed-property bitmask followed by only the properties that differ from
+// its baseline: a PropertySnapshot registered with Archive::SetDeltaBaselines, or the class
+// default object when there is none. Loading restores unchanged properties from the same baseline.
+//
+// ArchiveFlags::Versioned archives, meant for persistent saves, write each object as
+//     SchemaHash  PropertyLayout hash of the writer's class
+//     NumTags     then one fixed-width tag per property: { Id, Type, Size }
+//     Properties  untagged, in the writer's order
+// A reader whose layout hash matches skips the tags and reads the properties directly. Otherwise
+// it matches tags by Id (name, plus the struct layout for struct properties) and type, and skips
+// the size of every property it no longer has. Delta takes precedence over Versioned.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Archive.h"
+#include "Property.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        class Class;
+
+        // One property of the object or struct at container
+        void SerializeProperty(Archive& archive, const Property& property, void* container);
+
+        // Every property of the object's class, super classes first; delta encoded in Delta
+        // archives, tagged with a schema hash in Versioned ones, a JSON object in a TextArchive
+        void SerializeProperties(Archive& archive, Object* object);
+
+        // Captured property values of one object, used as a delta baseline.
+        // Object references are kept as pointers, so a snapshot is only valid in this process.
+        class PropertySnapshot
+        {
+        public:
+            PropertySnapshot() = default;
+            explicit PropertySnapshot(const Object* object);
+
+            const Class* GetClass() const { return ObjectClass; }
+            size_t GetNumProperties() const { return Offsets.empty() ? 0 : Offsets.size() - 1; }
+
+            const uint8_t* GetPropertyData(size_t index) const { return Data.data() + Offsets[index]; }
+            size_t GetPropertySize(size_t index) const { return Offsets[index + 1] - Offsets[index]; }
+
+            // Writes the captured value of property index back into object
+            void ApplyTo(Object* object, size_t index) const;
+
+        private:
+            const Class* ObjectClass = nullptr;
+            std::vector<uint8_t> Data;
+            std::vector<size_t> Offsets;    // Start of each property in Data, plus the end
+        };
+
+        // Delta encoding against baseline, or against the class default object if baseline is
+        // null or belongs to another class
+        void SerializeDelta(Archive& archive, Object* object, const PropertySnapshot* baseline);
+
+        // Flattened property layout of a class or struct for code that copies memory directly.
+        // Trivially copyable properties are merged into contiguous byte runs, nested structs are
+        // inlined and everything else (strings, references, arrays) is listed as a slot.
+        struct PropertyLayout
+        {
+            struct CopyRun
+            {
+                uint32_t Offset = 0;
+                uint32_t Size = 0;
+            };
+
+            std::vector<CopyRun> CopyRuns;
+            uint32_t CopySize = 0;              // Sum of the run sizes
+            std::vector<Property> Slots;        // Offsets relative to the container
+            uint64_t Hash = 0;                  // Changes with any property name, type, offset or size
+            size_t NumProperties = 0;
+        };
+
+        // Built on first use and rebuilt if properties were added since
+        const PropertyLayout& GetPropertyLayout(Class* objectClass);
+        const PropertyLayout& GetPropertyLayout(const StructInfo* structInfo);
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,167 @@
+#pragma once
+
+// Titan::Core::ReferenceTokenStream - Compiled per-class layout of object references
+// Built from reflected properties so the GC can follow references without virtual calls
+
+#include <cstdint>
+#include <vector>
+#include "Property.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        class Object;
+
+        // Set in an ObjectPtr slot holding an unloaded lazy reference instead of a pointer
+        constexpr uintptr_t LazyObjectTag = 1;
+
+        inline bool IsLazyObjectHandle(const Object* slot)
+        {
+            return (reinterpret_cast<uintptr_t>(slot) & LazyObjectTag) != 0;
+        }
+
+        enum class ReferenceTokenType : uint8_t
+        {
+            Object,         // Single Object* / ObjectPtr at Offset
+            ObjectArray,    // std::vector of object pointers at Offset
+            StructArray,    // std::vector of structs at Offset, Stride bytes per element;
+                            // the next NumNestedTokens tokens describe one element
+        };
+
+        struct ReferenceToken
+        {
+            uint32_t Offset = 0;
+            uint32_t Stride = 0;
+            uint32_t NumNestedTokens = 0;
+            ReferenceTokenType Type = ReferenceTokenType::Object;
+            uint8_t* (*GetArrayData)(void* array, size_t& outCount) = nullptr;     // Array tokens, from the Property
+        };
+
+        class ReferenceTokenStream
+        {
+        public:
+            const std::vector<ReferenceToken>& GetTokens() const { return Tokens; }
+            bool IsEmpty() const { return Tokens.empty(); }
+            void Reset() { Tokens.clear(); }
+
+            // Append tokens for properties located at baseOffset, flattening nested structs
+            void EmitProperties(const std::vector<Property>& properties, uint32_t baseOffset = 0)
+            {
+                for (const Property& property : properties)
+                {
+                    uint32_t offset = baseOffset + property.Offset;
+                    switch (property.Type)
+                    {
+                    case PropertyType::Object:
+                        Emit(ReferenceTokenType::Object, offset);
+                        break;
+                    case PropertyType::ObjectArray:
+                        if (property.GetArrayData)
+                            Emit(ReferenceTokenType::ObjectArray, offset).GetArrayData = property.GetArrayData;
+                        break;
+                    case PropertyType::Struct:
+                        if (property.Struct)
+                            EmitProperties(property.Struct->Properties, offset);
+                        break;
+                    case PropertyType::StructArray:
+                        if (property.Struct && property.GetArrayData)
+                        {
+                            ReferenceTokenStream element;
+                            element.EmitProperties(property.Struct->Properties);
+                            if (!element.IsEmpty())
+                            {
+                                ReferenceToken& token = Emit(ReferenceTokenType::StructArray, offset);
+                                token.Stride = property.Struct->Size;
+                                token.GetArrayData = property.GetArrayData;
+                                token.NumNestedTokens = static_cast<uint32_t>(element.Tokens.size());
+                                Tokens.insert(Tokens.end(), element.Tokens.begin(), element.Tokens.end());
+                            }
+                        }
+                        break;
+                    default:
+                        break;
+                    }
+                }
+            }
+
+            void Append(const ReferenceTokenStream& other)
+            {
+                Tokens.insert(Tokens.end(), other.Tokens.begin(), other.Tokens.end());
+            }
+
+            // Calls func(Object*) for every non-null reference stored in the instance at base
+            template<typename Func>
+            void ForEachReference(const void* base, Func&& func) const
+            {
+                ProcessTokens(static_cast<const uint8_t*>(base), 0, Tokens.size(), func);
+            }
+
+        private:
+            ReferenceToken& Emit(ReferenceTokenType type, uint32_t offset)
+            {
+                ReferenceToken token;
+                token.Type = type;
+                token.Offset = offset;
+                Tokens.push_back(token);
+                return Tokens.back();
+            }
+
+            // Goes through the Property's thunk, the vector's element type is not known here
+            static void GetArrayRange(const ReferenceToken& token, const uint8_t* vectorAddress, const uint8_t*& outBegin, const uint8_t*& outEnd)
+            {
+                size_t count = 0;
+                outBegin = token.GetArrayData(const_cast<uint8_t*>(vectorAddress), count);
+                outEnd = outBegin + count * (token.Type == ReferenceTokenType::StructArray ? token.Stride : sizeof(Object*));
+            }
+
+            template<typename Func>
+            void ProcessTokens(const uint8_t* base, size_t first, size_t last, Func& func) const
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    const ReferenceToken& token = Tokens[i];
+                    const uint8_t* address = base + token.Offset;
+                    switch (token.Type)
+                    {
+                    case ReferenceTokenType::Object:
+                    {
+                        Object* object = *reinterpret_cast<Object* const*>(address);
+                        if (object && !IsLazyObjectHandle(object))
+                            func(object);
+                        break;
+                    }
+                    case ReferenceTokenType::ObjectArray:
+                    {
+                        const uint8_t* begin;
+                        const uint8_t* end;
+                        GetArrayRange(token, address, begin, end);
+                        for (Object* const* it = reinterpret_cast<Object* const*>(begin); it != reinterpret_cast<Object* const*>(end); ++it)
+                        {
+                            if (*it && !IsLazyObjectHandle(*it))
+                                func(*it);
+                        }
+                        break;
+                    }
+                    case ReferenceTokenType::StructArray:
+                    {
+                        const uint8_t* begin;
+                        const uint8_t* end;
+                        GetArrayRange(token, address, begin, end);
+                        for (const uint8_t* element = begin; element < end; element += token.Stride)
+                        {
+                            ProcessTokens(element, i + 1, i + 1 + token.NumNestedTokens, func);
+                        }
+                        i += token.NumNestedTokens;
+                        break;
+                    }
+                    }
+                }
+            }
+
+            std::vector<ReferenceToken> Tokens;
+        };
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
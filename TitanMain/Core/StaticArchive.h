@@ -0,0 +1,338 @@
+#pragma once
+
+// Titan::Core::StaticArchive - Statically dispatched archive family
+// Same wire format as Archive, but every operator is inline so serializing a POD
+// struct compiles to plain stores. Write serialization code once as a template:
+//
+//     template<typename ArchiveType>
+//     void SerializeFields(ArchiveType& archive) { archive << Health << Position; }
+//     virtual void Serialize(Archive& archive) override { SerializeFields(archive); }
+//
+// and instantiate it against MemoryWriter / MemoryReader / FileWriter on hot paths.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Archive.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        // CRTP base. Derived provides Serialize(void*, size_t), Seek, Tell, TotalSize
+        // and a static constexpr bool Loading.
+        template<typename Derived>
+        class StaticArchive
+        {
+        public:
+            static constexpr bool IsLoadingArchive() { return Derived::Loading; }
+            bool IsLoading() const { return Derived::Loading; }
+            bool IsSaving() const { return !Derived::Loading; }
+
+            bool HasError() const { return ErrorFlag; }
+            void SetError() { ErrorFlag = true; }
+
+            template<typename T>
+            std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, Derived&> operator<<(T& value)
+            {
+                Self().Serialize(&value, sizeof(T));
+                return Self();
+            }
+
+            Derived& operator<<(bool& value)
+            {
+                uint8_t byte = value ? 1 : 0;
+                Self().Serialize(&byte, sizeof(byte));
+                value = byte != 0;
+                return Self();
+            }
+
+            Derived& operator<<(std::string& value)
+            {
+                uint32_t length = static_cast<uint32_t>(value.size());
+                *this << length;
+
+                if constexpr (Derived::Loading)
+                {
+                    if (length > static_cast<uint64_t>(Self().TotalSize() - Self().Tell()))
+                    {
+                        SetError();
+                        value.clear();
+                        return Self();
+                    }
+                    value.resize(length);
+                }
+
+                if (length)
+                {
+                    Self().Serialize(&value[0], length);
+                }
+                return Self();
+            }
+
+            void SerializeCount(uint64_t& count) { *this << count; }
+
+            template<typename T>
+            void SerializeArray(std::vector<T>& array)
+            {
+                uint64_t count = array.size();
+                SerializeCount(count);
+
+                if constexpr (IsBulkSerializable<T>::Value)
+                {
+                    if constexpr (Derived::Loading)
+                    {
+                        if (count > static_cast<uint64_t>(Self().TotalSize() - Self().Tell()) / sizeof(T))
+                        {
+                            SetError();
+                            array.clear();
+                            return;
+                        }
+                        array.resize(static_cast<size_t>(count));
+                    }
+
+                    if (count)
+                    {
+                        Self().Serialize(array.data(), static_cast<size_t>(count) * sizeof(T));
+                    }
+                }
+                else
+                {
+                    if constexpr (Derived::Loading)
+                    {
+                        // Every element takes at least one byte
+                        if (count > static_cast<uint64_t>(Self().TotalSize() - Self().Tell()))
+                        {
+                            SetError();
+                            array.clear();
+                            return;
+                        }
+                        array.resize(static_cast<size_t>(count));
+                    }
+
+                    for (auto& element : array)
+                    {
+                        Self() << element;
+                    }
+                }
+            }
+
+        protected:
+            Derived& Self() { return static_cast<Derived&>(*this); }
+
+            bool ErrorFlag = false;
+        };
+
+        // Appends to a growable in-memory buffer
+        class MemoryWriter : public StaticArchive<MemoryWriter>
+        {
+        public:
+            static constexpr bool Loading = false;
+
+            explicit MemoryWriter(size_t reserveBytes = 0) { Buffer.resize(reserveBytes); }
+
+            void Serialize(const void* data, size_t length)
+            {
+                // Position may be past the end after a Seek; the gap reads as zeros, as in MemoryArchive
+                if (Position > Buffer.size() || length > Buffer.size() - Position)
+                    Grow(Position + length);
+                std::memcpy(Buffer.data() + Position, data, length);
+                Position += length;
+                if (Position > Size)
+                    Size = Position;
+            }
+
+            void Seek(int64_t position) { Position = static_cast<size_t>(position < 0 ? 0 : position); }
+            int64_t Tell() const { return static_cast<int64_t>(Position); }
+            int64_t TotalSize() const { return static_cast<int64_t>(Size); }
+
+            const uint8_t* GetData() const { return Buffer.data(); }
+
+            // Hands the written bytes over, the writer is empty afterwards
+            std::vector<uint8_t> ReleaseData()
+            {
+                Buffer.resize(Size);
+                std::vector<uint8_t> result = std::move(Buffer);
+                Buffer.clear();
+                Position = 0;
+                Size = 0;
+                return result;
+            }
+
+        private:
+            void Grow(size_t required)
+            {
+                Buffer.resize(std::max(required, Buffer.size() * 2 + 64));
+            }
+
+            std::vector<uint8_t> Buffer;   // Capacity, bytes past Size are scratch
+            size_t Position = 0;
+            size_t Size = 0;
+        };
+
+        // Reads from memory owned by the caller
+        class MemoryReader : public StaticArchive<MemoryReader>
+        {
+        public:
+            static constexpr bool Loading = true;
+
+            MemoryReader(const void* data, size_t size)
+                : Data(static_cast<const uint8_t*>(data)), Size(size) {}
+
+            explicit MemoryReader(const std::vector<uint8_t>& data)
+                : MemoryReader(data.data(), data.size()) {}
+
+            void Serialize(void* data, size_t length)
+            {
+                if (length > Size - Position)
+                {
+                    std::memset(data, 0, length);
+                    SetError();
+                    return;
+                }
+                std::memcpy(data, Data + Position, length);
+                Position += length;
+            }
+
+            void Seek(int64_t position) { Position = std::min(Size, static_cast<size_t>(position < 0 ? 0 : position)); }
+            int64_t Tell() const { return static_cast<int64_t>(Position); }
+            int64_t TotalSize() const { return static_cast<int64_t>(Size); }
+
+        private:
+            const uint8_t* Data;
+            size_t Size;
+            size_t Position = 0;
+        };
+
+        // Buffered file output, flushed in BufferSize blocks
+        class FileWriter : public StaticArchive<FileWriter>
+        {
+        public:
+            static constexpr bool Loading = false;
+            static constexpr size_t BufferSize = 64 * 1024;
+
+            explicit FileWriter(const std::string& filename)
+            {
+                File = std::fopen(filename.c_str(), "wb");
+                if (!File)
+                    SetError();
+                Buffer.resize(BufferSize);
+            }
+
+            ~FileWriter()
+            {
+                if (File)
+                {
+                    Flush();
+                    std::fclose(File);
+                }
+            }
+
+            FileWriter(const FileWriter&) = delete;
+            FileWriter& operator=(const FileWriter&) = delete;
+
+            void Serialize(const void* data, size_t length)
+            {
+                if (length <= BufferSize - Buffered)
+                {
+                    std::memcpy(Buffer.data() + Buffered, data, length);
+                    Buffered += length;
+                }
+                else
+                {
+                    WriteSlow(data, length);
+                }
+                Position += static_cast<int64_t>(length);
+                if (Position > Size)
+                    Size = Position;
+            }
+
+            void Seek(int64_t position)
+            {
+                Flush();
+#if defined(_WIN32)
+                if (!File || _fseeki64(File, position, SEEK_SET) != 0)
+#else
+                if (!File || fseeko(File, static_cast<off_t>(position), SEEK_SET) != 0)
+#endif
+                {
+                    SetError();
+                    return;
+                }
+                Position = position;
+            }
+
+            int64_t Tell() const { return Position; }
+            int64_t TotalSize() const { return Size; }
+            bool IsOpen() const { return File != nullptr; }
+
+            void Flush()
+            {
+                if (File && Buffered)
+                {
+                    if (std::fwrite(Buffer.data(), 1, Buffered, File) != Buffered)
+                        SetError();
+                }
+                Buffered = 0;
+            }
+
+        private:
+            void WriteSlow(const void* data, size_t length)
+            {
+                Flush();
+                if (length >= BufferSize)
+                {
+                    if (!File || std::fwrite(data, 1, length, File) != length)
+                        SetError();
+                }
+                else
+                {
+                    std::memcpy(Buffer.data(), data, length);
+                    Buffered = length;
+                }
+            }
+
+            std::FILE* File = nullptr;
+            std::vector<uint8_t> Buffer;
+            size_t Buffered = 0;
+            int64_t Position = 0;
+            int64_t Size = 0;
+        };
+
+        // Exposes a static archive through the virtual Archive interface for polymorphic callers
+        // such as Object::Serialize(Archive&)
+        template<typename Inner>
+        class StaticArchiveAdapter : public Archive
+        {
+        public:
+            explicit StaticArchiveAdapter(Inner& inner)
+                : Archive((Inner::Loading ? ArchiveFlags::Loading : ArchiveFlags::Saving) | ArchiveFlags::Binary)
+                , InnerArchive(inner) {}
+
+            virtual void Seek(int64_t position) override { InnerArchive.Seek(position); }
+            virtual int64_t Tell() const override { return InnerArchive.Tell(); }
+            virtual int64_t TotalSize() const override { return InnerArchive.TotalSize(); }
+
+            virtual void Serialize(void* data, size_t length) override
+            {
+                InnerArchive.Serialize(data, length);
+                if (InnerArchive.HasError())
+                    SetError();
+            }
+
+        private:
+            Inner& InnerArchive;
+        };
+
+        // Declares the virtual Serialize(Archive&) of a class that implements
+        // template<typename ArchiveType> void SerializeFields(ArchiveType&)
+        #define TITAN_SERIALIZE_FIELDS() \
+            virtual void Serialize(::Titan::Core::Archive& archive) override { SerializeFields(archive); }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
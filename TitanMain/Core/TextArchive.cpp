@@ -0,0 +1,1005 @@
+#include "TextArchive.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "BitArray.h"
+#include "Object.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define TITAN_TEXT_AVX2_TARGET
+    #else
+        #define TITAN_TEXT_AVX2_TARGET __attribute__((target("avx2")))
+    #endif
+    #define TITAN_TEXT_SSE2 1
+    #define TITAN_TEXT_AVX2 1
+#elif defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define TITAN_TEXT_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define TITAN_TEXT_NEON 1
+#endif
+
+namespace Titan
+{
+    namespace Core
+    {
+        static constexpr size_t InvalidEntry = static_cast<size_t>(-1);
+
+        // Bit i of each mask is byte i of a 64-byte block
+        struct JsonBlockMasks
+        {
+            uint64_t Backslash = 0;
+            uint64_t Quote = 0;
+            uint64_t Bracket = 0;       // { } [ ]
+            uint64_t Operator = 0;      // Brackets, : and ,
+            uint64_t Whitespace = 0;
+        };
+
+        // '[' and ']' differ from '{' and '}' only in bit 0x20, so one compare of the folded bytes
+        // finds both brackets of a kind
+        static constexpr uint8_t BracketFoldBit = 0x20;
+
+#if defined(TITAN_TEXT_AVX2)
+        // Nibble lookup: a byte's class bits are Low[byte & 15] & High[byte >> 4], and bytes of 0x80
+        // and up look up 0 in Low. Each class gets its own bit per high nibble so no other byte
+        // matches both halves.
+        enum JsonClassBits : uint8_t
+        {
+            ClassBracket = 1,       // 0x5B 0x5D 0x7B 0x7D
+            ClassComma = 2,         // 0x2C
+            ClassColon = 4,         // 0x3A
+            ClassSpace = 8,         // 0x20
+            ClassControl = 16,      // 0x09 0x0A 0x0D
+        };
+
+        TITAN_TEXT_AVX2_TARGET
+        static void ClassifyBlockAvx2(const uint8_t* block, JsonBlockMasks& masks)
+        {
+            const __m256i low = _mm256_setr_epi8(
+                ClassSpace, 0, 0, 0, 0, 0, 0, 0, 0, ClassControl, ClassColon | ClassControl, ClassBracket, ClassComma, ClassBracket | ClassControl, 0, 0,
+                ClassSpace, 0, 0, 0, 0, 0, 0, 0, 0, ClassControl, ClassColon | ClassControl, ClassBracket, ClassComma, ClassBracket | ClassControl, 0, 0);
+            const __m256i high = _mm256_setr_epi8(
+                ClassControl, 0, ClassComma | ClassSpace, ClassColon, 0, ClassBracket, 0, ClassBracket, 0, 0, 0, 0, 0, 0, 0, 0,
+                ClassControl, 0, ClassComma | ClassSpace, ClassColon, 0, ClassBracket, 0, ClassBracket, 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+            masks = JsonBlockMasks();
+            for (int i = 0; i < 2; ++i)
+            {
+                __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i * 32));
+                __m256i classes = _mm256_and_si256(_mm256_shuffle_epi8(low, chunk),
+                    _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi16(chunk, 4), nibble)));
+
+                __m256i notBracket = _mm256_cmpeq_epi8(_mm256_and_si256(classes, _mm256_set1_epi8(ClassBracket)), zero);
+                __m256i notOperator = _mm256_cmpeq_epi8(_mm256_and_si256(classes, _mm256_set1_epi8(ClassBracket | ClassComma | ClassColon)), zero);
+                __m256i notWhitespace = _mm256_cmpeq_epi8(_mm256_and_si256(classes, _mm256_set1_epi8(ClassSpace | ClassControl)), zero);
+
+                int shift = i * 32;
+                masks.Backslash |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'))))) << shift;
+                masks.Quote |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'))))) << shift;
+                masks.Bracket |= uint64_t(~static_cast<uint32_t>(_mm256_movemask_epi8(notBracket))) << shift;
+                masks.Operator |= uint64_t(~static_cast<uint32_t>(_mm256_movemask_epi8(notOperator))) << shift;
+                masks.Whitespace |= uint64_t(~static_cast<uint32_t>(_mm256_movemask_epi8(notWhitespace))) << shift;
+            }
+        }
+
+        static bool HasAvx2Support()
+        {
+    #if defined(_MSC_VER)
+            // The OS must also save the YMM registers
+            int info[4];
+            __cpuid(info, 1);
+            if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 6) != 6)
+                return false;
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+    #else
+            return __builtin_cpu_supports("avx2");
+    #endif
+        }
+#endif
+
+#if defined(TITAN_TEXT_SSE2)
+        static void ClassifyBlock(const uint8_t* block, JsonBlockMasks& masks)
+        {
+            __m128i fold = _mm_set1_epi8(static_cast<char>(BracketFoldBit));
+            masks = JsonBlockMasks();
+            for (int i = 0; i < 4; ++i)
+            {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+                __m128i folded = _mm_or_si128(chunk, fold);
+                __m128i bracket = _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+                __m128i separator = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')));
+                __m128i whitespace = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))));
+
+                int shift = i * 16;
+                masks.Backslash |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))))) << shift;
+                masks.Quote |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'))))) << shift;
+                masks.Bracket |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(bracket))) << shift;
+                masks.Operator |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(_mm_or_si128(bracket, separator)))) << shift;
+                masks.Whitespace |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(whitespace))) << shift;
+            }
+        }
+#elif defined(TITAN_TEXT_NEON)
+        // 64 compare results to a bitmask: weight each lane by its bit, then add neighbouring lanes
+        // until each byte holds 8 lanes
+        static uint64_t ToBitmask(const uint8x16_t* lanes)
+        {
+            static const uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+            uint8x16_t bitWeights = vld1q_u8(weights);
+            uint8x16_t sum0 = vpaddq_u8(vandq_u8(lanes[0], bitWeights), vandq_u8(lanes[1], bitWeights));
+            uint8x16_t sum1 = vpaddq_u8(vandq_u8(lanes[2], bitWeights), vandq_u8(lanes[3], bitWeights));
+            sum0 = vpaddq_u8(sum0, sum1);
+            sum0 = vpaddq_u8(sum0, sum0);
+            return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+        }
+
+        static void ClassifyBlock(const uint8_t* block, JsonBlockMasks& masks)
+        {
+            uint8x16_t fold = vdupq_n_u8(BracketFoldBit);
+            uint8x16_t backslash[4], quote[4], bracket[4], op[4], whitespace[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                uint8x16_t chunk = vld1q_u8(block + i * 16);
+                uint8x16_t folded = vorrq_u8(chunk, fold);
+                backslash[i] = vceqq_u8(chunk, vdupq_n_u8('\\'));
+                quote[i] = vceqq_u8(chunk, vdupq_n_u8('"'));
+                bracket[i] = vorrq_u8(vceqq_u8(folded, vdupq_n_u8('{')), vceqq_u8(folded, vdupq_n_u8('}')));
+                op[i] = vorrq_u8(bracket[i], vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(':')), vceqq_u8(chunk, vdupq_n_u8(','))));
+                whitespace[i] = vorrq_u8(vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(' ')), vceqq_u8(chunk, vdupq_n_u8('\t'))),
+                                         vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('\n')), vceqq_u8(chunk, vdupq_n_u8('\r'))));
+            }
+
+            masks.Backslash = ToBitmask(backslash);
+            masks.Quote = ToBitmask(quote);
+            masks.Bracket = ToBitmask(bracket);
+            masks.Operator = ToBitmask(op);
+            masks.Whitespace = ToBitmask(whitespace);
+        }
+#else
+        static void ClassifyBlock(const uint8_t* block, JsonBlockMasks& masks)
+        {
+            masks = JsonBlockMasks();
+            for (int i = 0; i < 64; ++i)
+            {
+                uint64_t bit = uint64_t(1) << i;
+                uint8_t c = block[i];
+                uint8_t folded = c | BracketFoldBit;
+                if (c == '\\')
+                    masks.Backslash |= bit;
+                else if (c == '"')
+                    masks.Quote |= bit;
+                else if (folded == '{' || folded == '}')
+                    masks.Bracket |= bit;
+                else if (c == ':' || c == ',')
+                    masks.Operator |= bit;
+                else if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+                    masks.Whitespace |= bit;
+            }
+            masks.Operator |= masks.Bracket;
+        }
+#endif
+
+        using ClassifyFunction = void (*)(const uint8_t* block, JsonBlockMasks& masks);
+
+        static ClassifyFunction SelectClassifier()
+        {
+#if defined(TITAN_TEXT_AVX2)
+            if (HasAvx2Support())
+                return &ClassifyBlockAvx2;
+#endif
+            return &ClassifyBlock;
+        }
+
+        // Bit i of the result is the xor of bits 0..i, which turns quote positions into string
+        // interiors (opening quote included, closing quote excluded)
+        static uint64_t PrefixXor(uint64_t bits)
+        {
+            bits ^= bits << 1;
+            bits ^= bits << 2;
+            bits ^= bits << 4;
+            bits ^= bits << 8;
+            bits ^= bits << 16;
+            bits ^= bits << 32;
+            return bits;
+        }
+
+        static const char Base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        static void AppendBase64(std::string& output, const uint8_t* data, size_t length)
+        {
+            size_t start = output.size();
+            output.resize(start + (length + 2) / 3 * 4);
+            char* out = &output[start];
+            size_t i = 0;
+            for (; i + 3 <= length; i += 3)
+            {
+                uint32_t group = (uint32_t(data[i]) << 16) | (uint32_t(data[i + 1]) << 8) | data[i + 2];
+                *out++ = Base64Alphabet[group >> 18];
+                *out++ = Base64Alphabet[(group >> 12) & 63];
+                *out++ = Base64Alphabet[(group >> 6) & 63];
+                *out++ = Base64Alphabet[group & 63];
+            }
+
+            if (i < length)
+            {
+                uint32_t group = uint32_t(data[i]) << 16;
+                if (i + 1 < length)
+                    group |= uint32_t(data[i + 1]) << 8;
+                *out++ = Base64Alphabet[group >> 18];
+                *out++ = Base64Alphabet[(group >> 12) & 63];
+                *out++ = i + 1 < length ? Base64Alphabet[(group >> 6) & 63] : '=';
+                *out++ = '=';
+            }
+        }
+
+        static int DecodeBase64Char(char c)
+        {
+            if (c >= 'A' && c <= 'Z') return c - 'A';
+            if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+            if (c >= '0' && c <= '9') return c - '0' + 52;
+            if (c == '+') return 62;
+            if (c == '/') return 63;
+            return -1;
+        }
+
+        // False unless text decodes to exactly length bytes
+        static bool DecodeBase64(const char* text, size_t size, uint8_t* output, size_t length)
+        {
+            if (size % 4 != 0 || size / 4 * 3 < length || size / 4 * 3 - length > 2)
+                return false;
+
+            size_t written = 0;
+            for (size_t i = 0; i < size; i += 4)
+            {
+                uint32_t group = 0;
+                size_t numBytes = 3;
+                for (size_t j = 0; j < 4; ++j)
+                {
+                    int value = DecodeBase64Char(text[i + j]);
+                    if (value < 0)
+                    {
+                        // Padding only at the end of the last group
+                        if (text[i + j] != '=' || i + 4 != size || j < 2 || (j == 2 && text[i + 3] != '='))
+                            return false;
+                        value = 0;
+                        numBytes = std::min<size_t>(numBytes, j - 1);
+                    }
+                    group = (group << 6) | static_cast<uint32_t>(value);
+                }
+
+                for (size_t j = 0; j < numBytes; ++j)
+                {
+                    if (written == length)
+                        return false;
+                    output[written++] = static_cast<uint8_t>(group >> (16 - j * 8));
+                }
+            }
+            return written == length;
+        }
+
+        static void AppendUtf8(std::string& output, uint32_t codePoint)
+        {
+            if (codePoint < 0x80)
+            {
+                output += static_cast<char>(codePoint);
+            }
+            else if (codePoint < 0x800)
+            {
+                output += static_cast<char>(0xC0 | (codePoint >> 6));
+                output += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            else if (codePoint < 0x10000)
+            {
+                output += static_cast<char>(0xE0 | (codePoint >> 12));
+                output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                output += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            else
+            {
+                output += static_cast<char>(0xF0 | (codePoint >> 18));
+                output += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                output += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+        }
+
+        static bool ParseHex4(const char* text, const char* end, uint32_t& value)
+        {
+            if (end - text < 4)
+                return false;
+
+            auto result = std::from_chars(text, text + 4, value, 16);
+            return result.ec == std::errc() && result.ptr == text + 4;
+        }
+
+        static bool IsContainerStart(char c)
+        {
+            return c == '{' || c == '[';
+        }
+
+        // TextArchive implementation
+
+        TextArchive::TextArchive()
+            : Archive(ArchiveFlags::Saving | ArchiveFlags::Text | ArchiveFlags::Volatile)
+            , Text("[")
+        {
+        }
+
+        TextArchive::TextArchive(std::string text)
+            : Archive(ArchiveFlags::Loading | ArchiveFlags::Text | ArchiveFlags::Volatile)
+            , Text(std::move(text))
+        {
+            Input = Text.data();
+            InputSize = Text.size();
+            BuildIndex();
+        }
+
+        TextArchive::TextArchive(const char* text, size_t size)
+            : Archive(ArchiveFlags::Loading | ArchiveFlags::Text | ArchiveFlags::Volatile)
+            , Input(text)
+            , InputSize(size)
+        {
+            BuildIndex();
+        }
+
+        void TextArchive::BuildIndex()
+        {
+            if (InputSize > std::numeric_limits<uint32_t>::max())
+            {
+                SetError();
+                return;
+            }
+
+            static constexpr uint64_t OddBits = 0xAAAAAAAAAAAAAAAAull;
+            uint64_t nextIsEscaped = 0;
+            uint64_t previousInString = 0;
+            uint64_t previousScalar = 0;
+            const uint8_t* input = reinterpret_cast<const uint8_t*>(Input);
+            uint8_t tail[64];
+            std::vector<uint32_t> brackets;
+            static const ClassifyFunction classify = SelectClassifier();
+
+            Index.reserve(InputSize / 2 + 1);
+            for (size_t offset = 0; offset < InputSize; offset += 64)
+            {
+                const uint8_t* block = input + offset;
+                if (InputSize - offset < sizeof(tail))
+                {
+                    // Space padding adds no structure
+                    std::memset(tail, ' ', sizeof(tail));
+                    std::memcpy(tail, block, InputSize - offset);
+                    block = tail;
+                }
+
+                JsonBlockMasks masks;
+                classify(block, masks);
+
+                // A backslash run escapes the character after it when it has odd length. Subtracting
+                // each run start from the odd bit positions carries to the end of the run; whether the
+                // carry lands on an odd or even bit gives the parity of the run.
+                uint64_t escaped = nextIsEscaped;
+                if (masks.Backslash)
+                {
+                    uint64_t potentialEscape = masks.Backslash & ~nextIsEscaped;
+                    uint64_t escapeAndTerminal = (((potentialEscape << 1) | OddBits) - potentialEscape) ^ OddBits;
+                    escaped = escapeAndTerminal ^ (masks.Backslash | nextIsEscaped);
+                    nextIsEscaped = (escapeAndTerminal & masks.Backslash) >> 63;
+                }
+                else
+                {
+                    nextIsEscaped = 0;
+                }
+
+                uint64_t quote = masks.Quote & ~escaped;
+                uint64_t inString = PrefixXor(quote) ^ previousInString;
+                previousInString = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+                uint64_t stringTail = inString ^ quote;
+
+                // Values start at a byte that is no operator or whitespace and does not continue a scalar
+                uint64_t scalar = ~(masks.Operator | masks.Whitespace);
+                uint64_t nonQuoteScalar = scalar & ~quote;
+                uint64_t followsScalar = (nonQuoteScalar << 1) | previousScalar;
+                previousScalar = nonQuoteScalar >> 63;
+                uint64_t structurals = (masks.Operator | (scalar & ~followsScalar)) & ~stringTail;
+
+                size_t first = Index.size();
+                Index.resize(first + BitOps::PopCount(structurals));
+                uint32_t* output = Index.data() + first;
+                for (uint64_t bits = structurals; bits; bits &= bits - 1)
+                {
+                    *output++ = static_cast<uint32_t>(offset + BitOps::CountTrailingZeros(bits));
+                }
+
+                // Entries of the brackets, so matching them does not revisit every entry
+                for (uint64_t bits = masks.Bracket & ~stringTail; bits; bits &= bits - 1)
+                {
+                    uint64_t below = structurals & ((bits & (~bits + 1)) - 1);
+                    brackets.push_back(static_cast<uint32_t>(first + BitOps::PopCount(below)));
+                }
+            }
+
+            // Unterminated string
+            if (previousInString)
+            {
+                SetError();
+                return;
+            }
+
+            Match.resize(Index.size());
+            std::vector<uint32_t> open;
+            for (uint32_t entry : brackets)
+            {
+                char c = Input[Index[entry]];
+                if (IsContainerStart(c))
+                {
+                    open.push_back(entry);
+                }
+                else if (c == '}' || c == ']')
+                {
+                    if (open.empty() || Input[Index[open.back()]] != (c == '}' ? '{' : '['))
+                    {
+                        SetError();
+                        return;
+                    }
+                    Match[open.back()] = entry;
+                    open.pop_back();
+                }
+            }
+
+            if (!open.empty() || Index.empty())
+            {
+                SetError();
+                return;
+            }
+
+            // A root array holds the top-level values, any other root is the only one
+            if (Input[Index[0]] == '[' && Match[0] == Index.size() - 1)
+            {
+                Scopes.push_back(0);
+                Cursor = 1;
+            }
+            else if (IsContainerStart(Input[Index[0]]) ? Match[0] != Index.size() - 1 : Index.size() != 1)
+            {
+                SetError();
+            }
+        }
+
+        void TextArchive::Seek(int64_t position)
+        {
+            if (position != Tell())
+                SetError();
+        }
+
+        int64_t TextArchive::Tell() const
+        {
+            if (IsSaving())
+                return static_cast<int64_t>(Text.size());
+            return static_cast<int64_t>(Cursor < Index.size() ? Index[Cursor] : InputSize);
+        }
+
+        int64_t TextArchive::TotalSize() const
+        {
+            return static_cast<int64_t>(IsSaving() ? Text.size() : InputSize);
+        }
+
+        std::string TextArchive::GetText() const
+        {
+            if (NumTopLevel == 1 && TopLevelIsObject)
+                return Text.substr(1);
+            return Text + ']';
+        }
+
+        // Saving
+
+        void TextArchive::BeginValue()
+        {
+            if (NeedComma)
+                Text += ',';
+            NeedComma = true;
+
+            if (Depth == 0)
+            {
+                ++NumTopLevel;
+                TopLevelIsObject = false;
+            }
+        }
+
+        void TextArchive::WriteString(std::string_view value)
+        {
+            static const char HexDigits[] = "0123456789abcdef";
+
+            Text += '"';
+            size_t runStart = 0;
+            for (size_t i = 0; i < value.size(); ++i)
+            {
+                unsigned char c = static_cast<unsigned char>(value[i]);
+                if (c >= 0x20 && c != '"' && c != '\\')
+                    continue;
+
+                Text.append(value.data() + runStart, i - runStart);
+                runStart = i + 1;
+                switch (c)
+                {
+                case '"':   Text += "\\\""; break;
+                case '\\':  Text += "\\\\"; break;
+                case '\b':  Text += "\\b"; break;
+                case '\f':  Text += "\\f"; break;
+                case '\n':  Text += "\\n"; break;
+                case '\r':  Text += "\\r"; break;
+                case '\t':  Text += "\\t"; break;
+                default:
+                    Text += "\\u00";
+                    Text += HexDigits[c >> 4];
+                    Text += HexDigits[c & 15];
+                    break;
+                }
+            }
+            Text.append(value.data() + runStart, value.size() - runStart);
+            Text += '"';
+        }
+
+        template<typename T>
+        void TextArchive::WriteNumber(T value)
+        {
+            char buffer[24];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            BeginValue();
+            Text.append(buffer, result.ptr);
+        }
+
+        template<typename T>
+        void TextArchive::WriteFloat(T value)
+        {
+            // JSON has no literals for these
+            if (!std::isfinite(value))
+            {
+                BeginValue();
+                WriteString(std::isnan(value) ? "NaN" : value > 0 ? "Infinity" : "-Infinity");
+                return;
+            }
+
+            // Shortest text that reads back to the same value
+            char buffer[32];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            BeginValue();
+            Text.append(buffer, result.ptr);
+        }
+
+        void TextArchive::WriteKey(std::string_view key)
+        {
+            if (NeedComma)
+                Text += ',';
+            WriteString(key);
+            Text += ':';
+            NeedComma = false;
+        }
+
+        // Loading
+
+        bool TextArchive::IsAt(char token) const
+        {
+            return Cursor < Index.size() && Input[Index[Cursor]] == token;
+        }
+
+        // Entry of the next value, with the comma in front of it consumed
+        size_t TextArchive::TakeValue()
+        {
+            if (HasError())
+                return InvalidEntry;
+
+            if (ExpectComma)
+            {
+                if (!IsAt(','))
+                {
+                    SetError();
+                    return InvalidEntry;
+                }
+                ++Cursor;
+            }
+
+            char c = Cursor < Index.size() ? Input[Index[Cursor]] : ']';
+            if (c == ',' || c == ':' || c == '}' || c == ']')
+            {
+                SetError();
+                return InvalidEntry;
+            }
+
+            size_t entry = Cursor;
+            Cursor = IsContainerStart(c) ? Match[entry] + 1 : entry + 1;
+            ExpectComma = true;
+            return entry;
+        }
+
+        bool TextArchive::ReadString(size_t entry, std::string& value)
+        {
+            value.clear();
+            if (entry == InvalidEntry || Input[Index[entry]] != '"')
+            {
+                SetError();
+                return false;
+            }
+
+            // Only escapes need a look, runs between them are appended whole
+            const char* current = Input + Index[entry] + 1;
+            const char* end = Input + InputSize;
+            for (;;)
+            {
+                const char* quote = static_cast<const char*>(std::memchr(current, '"', static_cast<size_t>(end - current)));
+                if (!quote)
+                {
+                    SetError();
+                    return false;
+                }
+
+                const char* backslash = static_cast<const char*>(std::memchr(current, '\\', static_cast<size_t>(quote - current)));
+                if (!backslash)
+                {
+                    value.append(current, quote);
+                    return true;
+                }
+
+                value.append(current, backslash);
+                current = backslash + 2;
+                switch (backslash[1])
+                {
+                case '"':   value += '"'; break;
+                case '\\':  value += '\\'; break;
+                case '/':   value += '/'; break;
+                case 'b':   value += '\b'; break;
+                case 'f':   value += '\f'; break;
+                case 'n':   value += '\n'; break;
+                case 'r':   value += '\r'; break;
+                case 't':   value += '\t'; break;
+                case 'u':
+                {
+                    uint32_t codePoint = 0;
+                    if (!ParseHex4(current, end, codePoint))
+                    {
+                        SetError();
+                        return false;
+                    }
+                    current += 4;
+
+                    // Surrogate pair
+                    uint32_t low = 0;
+                    if (codePoint >= 0xD800 && codePoint < 0xDC00 && end - current >= 6 && current[0] == '\\' && current[1] == 'u'
+                        && ParseHex4(current + 2, end, low) && low >= 0xDC00 && low < 0xE000)
+                    {
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                        current += 6;
+                    }
+                    AppendUtf8(value, codePoint);
+                    break;
+                }
+                default:
+                    SetError();
+                    return false;
+                }
+            }
+        }
+
+        // Text of a number or literal, up to the next structural character
+        std::string_view TextArchive::GetScalar(size_t entry) const
+        {
+            if (entry == InvalidEntry)
+                return std::string_view();
+
+            size_t begin = Index[entry];
+            size_t end = entry + 1 < Index.size() ? Index[entry + 1] : InputSize;
+            while (end > begin && (Input[end - 1] == ' ' || Input[end - 1] == '\t' || Input[end - 1] == '\n' || Input[end - 1] == '\r'))
+                --end;
+            return std::string_view(Input + begin, end - begin);
+        }
+
+        template<typename T>
+        void TextArchive::ReadNumber(T& value)
+        {
+            std::string_view scalar = GetScalar(TakeValue());
+            auto result = std::from_chars(scalar.data(), scalar.data() + scalar.size(), value);
+            if (scalar.empty() || result.ec != std::errc() || result.ptr != scalar.data() + scalar.size())
+            {
+                value = T();
+                SetError();
+            }
+        }
+
+        template<typename T>
+        void TextArchive::ReadFloat(T& value)
+        {
+            size_t entry = TakeValue();
+            if (entry != InvalidEntry && Input[Index[entry]] == '"')
+            {
+                std::string text;
+                ReadString(entry, text);
+                if (text == "NaN")
+                    value = std::numeric_limits<T>::quiet_NaN();
+                else if (text == "Infinity" || text == "-Infinity")
+                    value = text[0] == '-' ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+                else
+                {
+                    value = T();
+                    SetError();
+                }
+                return;
+            }
+
+            std::string_view scalar = GetScalar(entry);
+            auto result = std::from_chars(scalar.data(), scalar.data() + scalar.size(), value);
+            if (scalar.empty() || result.ec != std::errc() || result.ptr != scalar.data() + scalar.size())
+            {
+                value = T();
+                SetError();
+            }
+        }
+
+        bool TextArchive::BeginObject()
+        {
+            if (IsSaving())
+            {
+                BeginValue();
+                if (Depth == 0)
+                    TopLevelIsObject = NumTopLevel == 1;
+                Text += '{';
+                ++Depth;
+                NeedComma = false;
+                return true;
+            }
+
+            size_t entry = TakeValue();
+            if (entry == InvalidEntry || Input[Index[entry]] != '{')
+            {
+                SetError();
+                return false;
+            }
+
+            Scopes.push_back(static_cast<uint32_t>(entry));
+            Cursor = entry + 1;
+            ExpectComma = false;
+            return true;
+        }
+
+        void TextArchive::EndObject()
+        {
+            if (IsSaving())
+            {
+                Text += '}';
+                --Depth;
+                NeedComma = true;
+                return;
+            }
+
+            if (Scopes.empty())
+            {
+                SetError();
+                return;
+            }
+            Cursor = Match[Scopes.back()] + 1;
+            Scopes.pop_back();
+            ExpectComma = true;
+        }
+
+        bool TextArchive::ReadKey(std::string& key)
+        {
+            if (HasError() || Scopes.empty() || Input[Index[Scopes.back()]] != '{' || IsAt('}'))
+                return false;
+
+            size_t entry = TakeValue();
+            if (!ReadString(entry, key) || !IsAt(':'))
+            {
+                SetError();
+                return false;
+            }
+
+            ++Cursor;
+            ExpectComma = false;
+            return true;
+        }
+
+        bool TextArchive::BeginArray(uint64_t& count)
+        {
+            if (IsSaving())
+            {
+                BeginValue();
+                Text += '[';
+                ++Depth;
+                NeedComma = false;
+                return true;
+            }
+
+            count = 0;
+            size_t entry = TakeValue();
+            if (entry == InvalidEntry || Input[Index[entry]] != '[')
+            {
+                SetError();
+                return false;
+            }
+
+            // Elements are one entry each, or a whole container to jump over
+            size_t close = Match[entry];
+            for (size_t element = entry + 1; element < close; ++count)
+            {
+                element = IsContainerStart(Input[Index[element]]) ? Match[element] + 1 : element + 1;
+                if (element < close && Input[Index[element]] == ',')
+                    ++element;
+            }
+
+            Scopes.push_back(static_cast<uint32_t>(entry));
+            Cursor = entry + 1;
+            ExpectComma = false;
+            return true;
+        }
+
+        void TextArchive::EndArray()
+        {
+            if (IsSaving())
+            {
+                Text += ']';
+                --Depth;
+                NeedComma = true;
+                return;
+            }
+
+            if (Scopes.empty())
+            {
+                SetError();
+                return;
+            }
+            Cursor = Match[Scopes.back()] + 1;
+            Scopes.pop_back();
+            ExpectComma = true;
+        }
+
+        void TextArchive::SkipValue()
+        {
+            if (IsLoading())
+                TakeValue();
+        }
+
+        // Values
+
+        void TextArchive::Serialize(void* data, size_t length)
+        {
+            if (IsSaving())
+            {
+                BeginValue();
+                Text += '"';
+                AppendBase64(Text, static_cast<const uint8_t*>(data), length);
+                Text += '"';
+                return;
+            }
+
+            size_t entry = TakeValue();
+            if (entry != InvalidEntry && Input[Index[entry]] == '"')
+            {
+                const char* begin = Input + Index[entry] + 1;
+                const char* end = static_cast<const char*>(std::memchr(begin, '"', InputSize - Index[entry] - 1));
+                if (end && DecodeBase64(begin, static_cast<size_t>(end - begin), static_cast<uint8_t*>(data), length))
+                    return;
+            }
+
+            std::memset(data, 0, length);
+            SetError();
+        }
+
+        Archive& TextArchive::operator<<(bool& value)
+        {
+            if (IsSaving())
+            {
+                BeginValue();
+                Text += value ? "true" : "false";
+                return *this;
+            }
+
+            std::string_view scalar = GetScalar(TakeValue());
+            value = scalar == "true";
+            if (!value && scalar != "false")
+                SetError();
+            return *this;
+        }
+
+        Archive& TextArchive::operator<<(int8_t& value)
+        {
+            IsSaving() ? WriteNumber(value) : ReadNumber(value);
+            return *this;
+        }
+
+        Archive& TextArchive::operator<<(uint8_t& value)
+        {
+            IsSaving() ? WriteNumber(value) : ReadNumber(value);
+            return *this;
+        }
+
+        Archive& TextArchive::operator<<(int16_t& value)
+        {
+            IsSaving() ? WriteNumber(value) : ReadNumber(value);
+            return *this;
+        }
+
+        Archive& TextArchive::operator<<(uint16_t& value)
+        {
+            IsSaving() ? WriteNumber(value) : ReadNumber(value);
+            return *this;
+        }
+
+        Archive& TextArchive::operator<<(int32_t& value)
+        {
+            IsSaving() ? WriteNumber(value) : ReadNumber(value);
+            return *this;
+        }
+
+        Archive& TextArchive::operator<<(uint32_t& value)
+        {
+            IsSaving() ? WriteNumber(value) : ReadNumber(value);
+            return *this;
+        }
+
+        Archive& TextArchive::operator<<(int64_t& value)
+        {
+            IsSaving() ? WriteNumber(value) : ReadNumber(value);
+            return *this;
+        }
+
+        Archive& TextArchive::operator<<(uint64_t& value)
+        {
+            IsSaving() ? WriteNumber(value) : ReadNumber(value);
+            return *this;
+        }
+
+        Archive& TextArchive::operator<<(float& value)
+        {
+            IsSaving() ? WriteFloat(value) : ReadFloat(value);
+            return *this;
+        }
+
+        Archive& TextArchive::operator<<(double& value)
+        {
+            IsSaving() ? WriteFloat(value) : ReadFloat(value);
+            return *this;
+        }
+
+        Archive& TextArchive::operator<<(std::string& value)
+        {
+            if (IsSaving())
+            {
+                BeginValue();
+                WriteString(value);
+            }
+            else
+            {
+                ReadString(TakeValue(), value);
+            }
+            return *this;
+        }
+
+        void TextArchive::SerializeObject(Object*& object)
+        {
+            if (IsSaving())
+            {
+                BeginValue();
+                if (object)
+                    WriteString(object->GetFullName());
+                else
+                    Text += "null";
+                return;
+            }
+
+            size_t entry = TakeValue();
+            std::string name;
+            if (GetScalar(entry) == "null")
+                object = nullptr;
+            else
+                object = ReadString(entry, name) ? ObjectRegistry::Get().FindObject(name) : nullptr;
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+// Titan::Core::TextArchive - JSON through the Archive interface
+// Saving writes compact JSON, one JSON value per value the archive is given: numbers, true/false,
+// strings, object references as full names or null, and raw byte blocks such as bulk arrays as
+// base64 strings. SerializeProperties writes objects as JSON objects keyed by property name,
+// structs as nested objects and property arrays as JSON arrays; loading matches keys by name, so
+// hand-edited files may reorder, add or drop them. A document holding a single top-level object
+// is that object, any other document is an array of the top-level values.
+//
+// Loading indexes the text once in the style of simdjson. Each 64-byte block is classified with
+// SIMD (AVX2 nibble lookups where the CPU has them) into backslash, quote, operator and whitespace
+// bitmasks; escaped quotes and string interiors are then masked out with carry-free bit
+// arithmetic, leaving one bit per structural character and per value start. Reads walk that
+// index, and skipping a container is a jump to its closing bracket, recorded when the index was
+// built.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Archive.h"
+
+namespace Titan
+{
+    namespace Core
+    {
+        class TextArchive : public Archive
+        {
+        public:
+            // Saving
+            TextArchive();
+
+            // Loading, either owning the text or borrowing it for the archive's lifetime
+            explicit TextArchive(std::string text);
+            TextArchive(const char* text, size_t size);
+
+            virtual TextArchive* AsTextArchive() override { return this; }
+
+            // Text is read and written front to back; seeking anywhere else sets the error flag
+            virtual void Seek(int64_t position) override;
+            virtual int64_t Tell() const override;
+            virtual int64_t TotalSize() const override;
+
+            // Raw bytes as one base64 string
+            virtual void Serialize(void* data, size_t length) override;
+
+            virtual Archive& operator<<(bool& value) override;
+            virtual Archive& operator<<(int8_t& value) override;
+            virtual Archive& operator<<(uint8_t& value) override;
+            virtual Archive& operator<<(int16_t& value) override;
+            virtual Archive& operator<<(uint16_t& value) override;
+            virtual Archive& operator<<(int32_t& value) override;
+            virtual Archive& operator<<(uint32_t& value) override;
+            virtual Archive& operator<<(int64_t& value) override;
+            virtual Archive& operator<<(uint64_t& value) override;
+            virtual Archive& operator<<(float& value) override;
+            virtual Archive& operator<<(double& value) override;
+            virtual Archive& operator<<(std::string& value) override;
+            using Archive::operator<<;
+
+            virtual void SerializeObject(Object*& object) override;
+
+            // Objects and arrays. Loading returns false and sets the error flag if the next value
+            // is not one; End skips whatever was not read.
+            bool BeginObject();
+            void EndObject();
+
+            // Saving: the key of the next value in the current object
+            void WriteKey(std::string_view key);
+
+            // Loading: the next key of the current object, false at its end
+            bool ReadKey(std::string& key);
+
+            // count is ignored on save; on load it is the number of elements
+            bool BeginArray(uint64_t& count);
+            void EndArray();
+
+            // Loading: skips the next value, containers included
+            void SkipValue();
+
+            // Saving: the finished document
+            std::string GetText() const;
+
+        private:
+            // Saving
+            void BeginValue();
+            void WriteString(std::string_view value);
+            template<typename T> void WriteNumber(T value);
+            template<typename T> void WriteFloat(T value);
+
+            // Loading
+            void BuildIndex();
+            bool IsAt(char token) const;
+            size_t TakeValue();
+            bool ReadString(size_t position, std::string& value);
+            std::string_view GetScalar(size_t position) const;
+            template<typename T> void ReadNumber(T& value);
+            template<typename T> void ReadFloat(T& value);
+
+            std::string Text;                   // Saving: output after a leading '['; loading: owned input
+            size_t NumTopLevel = 0;
+            bool TopLevelIsObject = false;
+            uint32_t Depth = 0;
+            bool NeedComma = false;
+
+            const char* Input = nullptr;
+            size_t InputSize = 0;
+            std::vector<uint32_t> Index;        // Input offsets of structural characters and value starts
+            std::vector<uint32_t> Match;        // For '{' and '[' entries, the entry of the closing bracket
+            std::vector<uint32_t> Scopes;       // Entries of the open containers
+            size_t Cursor = 0;
+            bool ExpectComma = false;
+        };
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
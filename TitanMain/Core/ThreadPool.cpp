@@ -0,0 +1,130 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace Titan
+{
+    namespace Core
+    {
+        ThreadPool& ThreadPool::Get()
+        {
+            static ThreadPool instance(std::max(1u, std::thread::hardware_concurrency()) - 1);
+            return instance;
+        }
+
+        ThreadPool::ThreadPool(uint32_t numThreads)
+        {
+            Workers.reserve(numThreads);
+            for (uint32_t i = 0; i < numThreads; ++i)
+            {
+                Workers.emplace_back([this]() { WorkerLoop(); });
+            }
+        }
+
+        ThreadPool::~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                IsStopping = true;
+            }
+            Condition.notify_all();
+
+            for (auto& worker : Workers)
+            {
+                worker.join();
+            }
+        }
+
+        void ThreadPool::Submit(std::function<void()> task)
+        {
+            if (Workers.empty())
+            {
+                // No workers - run inline so callers never wait forever
+                task();
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                Tasks.push_back(std::move(task));
+            }
+            Condition.notify_one();
+        }
+
+        void ThreadPool::ParallelFor(size_t count, size_t minBatchSize, const std::function<void(size_t, size_t)>& body)
+        {
+            if (count == 0)
+                return;
+
+            minBatchSize = std::max<size_t>(1, minBatchSize);
+            size_t maxChunks = (count + minBatchSize - 1) / minBatchSize;
+            size_t numChunks = std::min<size_t>(maxChunks, (GetNumThreads() + 1) * 4);
+            if (numChunks <= 1)
+            {
+                body(0, count);
+                return;
+            }
+
+            // Shared with the helper tasks, which may start after this call returned
+            struct ForState
+            {
+                std::atomic<size_t> NextChunk{0};
+                std::atomic<size_t> DoneChunks{0};
+                std::mutex DoneMutex;
+                std::condition_variable DoneCondition;
+            };
+            auto state = std::make_shared<ForState>();
+            size_t chunkSize = (count + numChunks - 1) / numChunks;
+            numChunks = (count + chunkSize - 1) / chunkSize;
+
+            auto runChunks = [state, &body, count, chunkSize, numChunks]()
+            {
+                size_t chunk;
+                while ((chunk = state->NextChunk.fetch_add(1)) < numChunks)
+                {
+                    size_t begin = chunk * chunkSize;
+                    body(begin, std::min(count, begin + chunkSize));
+
+                    if (state->DoneChunks.fetch_add(1) + 1 == numChunks)
+                    {
+                        std::lock_guard<std::mutex> lock(state->DoneMutex);
+                        state->DoneCondition.notify_all();
+                    }
+                }
+            };
+
+            size_t numHelpers = std::min<size_t>(GetNumThreads(), numChunks - 1);
+            for (size_t i = 0; i < numHelpers; ++i)
+            {
+                // Late helpers find no chunks left and exit without touching body
+                Submit(runChunks);
+            }
+
+            runChunks();
+
+            std::unique_lock<std::mutex> lock(state->DoneMutex);
+            state->DoneCondition.wait(lock, [&]() { return state->DoneChunks.load() == numChunks; });
+        }
+
+        void ThreadPool::WorkerLoop()
+        {
+            for (;;)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(Mutex);
+                    Condition.wait(lock, [this]() { return IsStopping || !Tasks.empty(); });
+                    if (IsStopping && Tasks.empty())
+                        return;
+
+                    task = std::move(Tasks.front());
+                    Tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
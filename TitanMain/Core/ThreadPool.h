@@ -0,0 +1,52 @@
+#pragma once
+
+// Titan::Core::ThreadPool - Shared worker threads for parallel engine work
+// Simple FIFO task queue plus a blocking ParallelFor helper
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Titan
+{
+    namespace Core
+    {
+        class ThreadPool
+        {
+        public:
+            // Engine-wide pool with one worker per hardware thread (minus the caller)
+            static ThreadPool& Get();
+
+            explicit ThreadPool(uint32_t numThreads);
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            uint32_t GetNumThreads() const { return static_cast<uint32_t>(Workers.size()); }
+
+            // Queue a task, it runs on the first free worker
+            void Submit(std::function<void()> task);
+
+            // Split [0, count) into chunks of at least minBatchSize and run body(begin, end)
+            // on the workers. The calling thread takes part and returns when all chunks are done.
+            void ParallelFor(size_t count, size_t minBatchSize, const std::function<void(size_t, size_t)>& body);
+
+        private:
+            void WorkerLoop();
+
+            std::vector<std::thread> Workers;
+            std::deque<std::function<void()>> Tasks;
+            std::mutex Mutex;
+            std::condition_variable Condition;
+            bool IsStopping = false;
+        };
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
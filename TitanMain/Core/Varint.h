@@ -0,0 +1,201 @@
+#pragma once
+
+// Titan::Core::Varint - LEB128 integer encoding with zigzag for signed values
+// Used by archives in ArchiveFlags::Compact mode. Bulk array decoding checks 16 bytes at a
+// time and widens runs of single-byte values with SIMD.
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "BitArray.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define TITAN_VARINT_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define TITAN_VARINT_NEON 1
+#endif
+
+namespace Titan
+{
+    namespace Core
+    {
+        namespace Varint
+        {
+            constexpr size_t MaxBytes32 = 5;
+            constexpr size_t MaxBytes64 = 10;
+
+            // Integer types that switch to varints in compact archives
+            template<typename T>
+            struct IsCompactInteger
+            {
+                static constexpr bool Value = std::is_same<T, int32_t>::value || std::is_same<T, uint32_t>::value
+                    || std::is_same<T, int64_t>::value || std::is_same<T, uint64_t>::value;
+            };
+
+            inline uint64_t ZigZagEncode(int64_t value)
+            {
+                return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+            }
+
+            inline int64_t ZigZagDecode(uint64_t value)
+            {
+                return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+            }
+
+            // Writes up to MaxBytes64 bytes, returns the count
+            inline size_t Encode(uint64_t value, uint8_t* output)
+            {
+                size_t length = 0;
+                while (value >= 0x80)
+                {
+                    output[length++] = static_cast<uint8_t>(value | 0x80);
+                    value >>= 7;
+                }
+                output[length++] = static_cast<uint8_t>(value);
+                return length;
+            }
+
+            // Reads one value of at most maxBytes bytes; false if truncated or too long
+            inline bool Decode(const uint8_t*& input, const uint8_t* inputEnd, uint64_t& value, size_t maxBytes = MaxBytes64)
+            {
+                uint64_t result = 0;
+                for (size_t i = 0; i < maxBytes && input < inputEnd; ++i)
+                {
+                    uint8_t byte = *input++;
+                    result |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+                    if (byte < 0x80)
+                    {
+                        value = result;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            template<typename T>
+            inline uint64_t ToUnsigned(T value)
+            {
+                if constexpr (std::is_signed<T>::value)
+                    return ZigZagEncode(value);
+                else
+                    return static_cast<uint64_t>(value);
+            }
+
+            template<typename T>
+            inline T FromUnsigned(uint64_t value)
+            {
+                if constexpr (std::is_signed<T>::value)
+                    return static_cast<T>(ZigZagDecode(value));
+                else
+                    return static_cast<T>(value);
+            }
+
+            // Encodes count values back to back into up to count * MaxBytes64 bytes
+            template<typename T>
+            inline size_t EncodeArray(const T* values, size_t count, uint8_t* output)
+            {
+                static_assert(IsCompactInteger<T>::Value, "Varint arrays hold 32 and 64-bit integers");
+
+                size_t length = 0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    length += Encode(ToUnsigned(values[i]), output + length);
+                }
+                return length;
+            }
+
+            // Decodes exactly count values from inputSize bytes. Returns the bytes consumed, or
+            // SIZE_MAX if the input is malformed or ends early.
+            template<typename T>
+            inline size_t DecodeArray(const uint8_t* input, size_t inputSize, T* values, size_t count)
+            {
+                static_assert(IsCompactInteger<T>::Value, "Varint arrays hold 32 and 64-bit integers");
+                constexpr size_t maxBytes = sizeof(T) == 4 ? MaxBytes32 : MaxBytes64;
+
+                const uint8_t* cursor = input;
+                const uint8_t* inputEnd = input + inputSize;
+                size_t i = 0;
+                while (i < count)
+                {
+#if defined(TITAN_VARINT_SSE2) || defined(TITAN_VARINT_NEON)
+                    if (inputEnd - cursor >= 16)
+                    {
+    #if defined(TITAN_VARINT_SSE2)
+                        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cursor));
+                        uint32_t continuationMask = static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+    #else
+                        uint8x16_t bytes = vld1q_u8(cursor);
+                        uint32_t continuationMask = vmaxvq_u8(bytes) >= 0x80 ? 1u : 0u;
+    #endif
+                        if (continuationMask == 0 && count - i >= 16)
+                        {
+                            // 16 single-byte values
+    #if defined(TITAN_VARINT_SSE2)
+                            if constexpr (sizeof(T) == 4)
+                            {
+                                __m128i zero = _mm_setzero_si128();
+                                __m128i low = _mm_unpacklo_epi8(bytes, zero);
+                                __m128i high = _mm_unpackhi_epi8(bytes, zero);
+                                __m128i words[4] = {
+                                    _mm_unpacklo_epi16(low, zero), _mm_unpackhi_epi16(low, zero),
+                                    _mm_unpacklo_epi16(high, zero), _mm_unpackhi_epi16(high, zero) };
+                                if constexpr (std::is_signed<T>::value)
+                                {
+                                    // (v >> 1) ^ -(v & 1)
+                                    __m128i one = _mm_set1_epi32(1);
+                                    for (__m128i& word : words)
+                                        word = _mm_xor_si128(_mm_srli_epi32(word, 1), _mm_sub_epi32(zero, _mm_and_si128(word, one)));
+                                }
+                                for (size_t k = 0; k < 4; ++k)
+                                    _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i + k * 4), words[k]);
+                            }
+                            else
+    #else
+                            if constexpr (sizeof(T) == 4 && !std::is_signed<T>::value)
+                            {
+                                uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+                                uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+                                uint32_t* out = reinterpret_cast<uint32_t*>(values + i);
+                                vst1q_u32(out, vmovl_u16(vget_low_u16(low)));
+                                vst1q_u32(out + 4, vmovl_u16(vget_high_u16(low)));
+                                vst1q_u32(out + 8, vmovl_u16(vget_low_u16(high)));
+                                vst1q_u32(out + 12, vmovl_u16(vget_high_u16(high)));
+                            }
+                            else
+    #endif
+                            {
+                                for (size_t k = 0; k < 16; ++k)
+                                    values[i + k] = FromUnsigned<T>(cursor[k]);
+                            }
+                            cursor += 16;
+                            i += 16;
+                            continue;
+                        }
+
+    #if defined(TITAN_VARINT_SSE2)
+                        // Take the single-byte values in front of the first multi-byte one
+                        size_t run = continuationMask ? BitOps::CountTrailingZeros(continuationMask) : 16;
+                        run = run < count - i ? run : count - i;
+                        for (size_t k = 0; k < run; ++k)
+                            values[i + k] = FromUnsigned<T>(cursor[k]);
+                        cursor += run;
+                        i += run;
+                        if (i == count)
+                            break;
+    #endif
+                    }
+#endif
+                    uint64_t value;
+                    if (!Decode(cursor, inputEnd, value, maxBytes) || (sizeof(T) == 4 && value > 0xffffffffu))
+                        return SIZE_MAX;
+                    values[i++] = FromUnsigned<T>(value);
+                }
+                return static_cast<size_t>(cursor - input);
+            }
+        }
+
+    } // namespace Core
+
+} // namespace Titan
\ No newline at end of file
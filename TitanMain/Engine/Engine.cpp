@@ -1,118 +1,227 @@
-#include "Engine.h"
-
-namespace Titan
-{
-    namespace Engine
-    {
-        // Engine implementation
-        Engine& Engine::GetInstance()
-        {
-            static Engine instance;
-            return instance;
-        }
-
-        void Engine::Initialize()
-        {
-            if (m_IsInitialized)
-                return;
-
-            // Initialize subsystems
-            for (auto& subsystem : m_Subsystems)
-            {
-                subsystem->Initialize();
-            }
-
-            m_IsInitialized = true;
-            m_IsRunning = true;
-        }
-
-        void Engine::Shutdown()
-        {
-            if (!m_IsInitialized)
-                return;
-
-            m_IsRunning = false;
-
-            // Shutdown subsystems in reverse order
-            for (auto it = m_Subsystems.rbegin(); it != m_Subsystems.rend(); ++it)
-            {
-                (*it)->Shutdown();
-            }
-
-            m_Subsystems.clear();
-            m_IsInitialized = false;
-        }
-
-        void Engine::Run()
-        {
-            if (!m_IsInitialized)
-                Initialize();
-
-            // Main game loop - simplified version
-            while (m_IsRunning)
-            {
-                // Calculate delta time
-                // TODO: Implement proper timing
-                m_DeltaTime = 1.0f / 60.0f; // Assume 60 FPS for now
-                m_TotalTime += m_DeltaTime;
-
-                // Update subsystems
-                Update(m_DeltaTime);
-
-                // Render
-                Render();
-            }
-        }
-
-        void Engine::Update(float deltaTime)
-        {
-            for (auto& subsystem : m_Subsystems)
-            {
-                subsystem->Update(deltaTime);
-            }
-        }
-
-        void Engine::Render()
-        {
-            // TODO: Implement rendering
-        }
-
-        // TimeSubsystem implementation
-        void TimeSubsystem::Initialize()
-        {
-            m_LastTime = 0; // TODO: Get current time
-            m_FrameCount = 0;
-        }
-
-        void TimeSubsystem::Shutdown()
-        {
-            // Cleanup
-        }
-
-        void TimeSubsystem::Update(float deltaTime)
-        {
-            m_DeltaTime = deltaTime;
-            m_TotalTime += deltaTime;
-            m_FrameCount++;
-        }
-
-        // ResourceManager implementation
-        void ResourceManager::Initialize()
-        {
-            // Initialize resource cache
-        }
-
-        void ResourceManager::Shutdown()
-        {
-            // Cleanup resources
-            m_Resources.clear();
-        }
-
-        void ResourceManager::Update(float deltaTime)
-        {
-            // Update resource loading/unloading
-        }
-
-    } // namespace Engine
-
+#include "Engine.h"
+#include "../Core/Object.h"
+#include "../Core/PlatformFile.h"
+
+namespace Titan
+{
+    namespace Engine
+    {
+        // Engine implementation
+        Engine& Engine::GetInstance()
+        {
+            static Engine instance;
+            return instance;
+        }
+
+        void Engine::Initialize()
+        {
+            if (m_IsInitialized)
+                return;
+
+            Core::SetGameThread();
+
+            // Initialize subsystems
+            for (auto& subsystem : m_Subsystems)
+            {
+                subsystem->Initialize();
+            }
+
+            m_IsInitialized = true;
+            m_IsRunning = true;
+        }
+
+        void Engine::Shutdown()
+        {
+            if (!m_IsInitialized)
+                return;
+
+            m_IsRunning = false;
+
+            // Shutdown subsystems in reverse order
+            for (auto it = m_Subsystems.rbegin(); it != m_Subsystems.rend(); ++it)
+            {
+                (*it)->Shutdown();
+            }
+
+            m_Subsystems.clear();
+            m_IsInitialized = false;
+        }
+
+        void Engine::Run()
+        {
+            if (!m_IsInitialized)
+                Initialize();
+
+            // Main game loop - simplified version
+            while (m_IsRunning)
+            {
+                // Calculate delta time
+                // TODO: Implement proper timing
+                m_DeltaTime = 1.0f / 60.0f; // Assume 60 FPS for now
+                m_TotalTime += m_DeltaTime;
+
+                // Update subsystems
+                Update(m_DeltaTime);
+
+                // Render
+                Render();
+            }
+        }
+
+        void Engine::Update(float deltaTime)
+        {
+            for (auto& subsystem : m_Subsystems)
+            {
+                subsystem->Update(deltaTime);
+            }
+        }
+
+        void Engine::Render()
+        {
+            // TODO: Implement rendering
+        }
+
+        // TimeSubsystem implementation
+        void TimeSubsystem::Initialize()
+        {
+            m_LastTime = 0; // TODO: Get current time
+            m_FrameCount = 0;
+        }
+
+        void TimeSubsystem::Shutdown()
+        {
+            // Cleanup
+        }
+
+        void TimeSubsystem::Update(float deltaTime)
+        {
+            m_DeltaTime = deltaTime;
+            m_TotalTime += deltaTime;
+            m_FrameCount++;
+        }
+
+        // ResourceManager implementation
+        void ResourceManager::Initialize()
+        {
+            // Initialize resource cache
+        }
+
+        void ResourceManager::Shutdown()
+        {
+            // Package loads own objects until they are finalized
+            Core::AsyncPackageLoader::Get().Flush();
+
+            // Abandon outstanding reads, their buffers must outlive the I/O
+            for (auto& entry : m_PendingLoads)
+            {
+                entry.second.Io.Cancel();
+                entry.second.Io.Wait();
+                Core::PlatformFile::Close(entry.second.FileHandle);
+            }
+            m_PendingLoads.clear();
+
+            // Cleanup resources
+            m_Resources.clear();
+        }
+
+        void ResourceManager::Update(float deltaTime)
+        {
+            // Deliver finished loads; callbacks may start new ones, so collect first
+            std::vector<PendingLoad> finished;
+            for (auto it = m_PendingLoads.begin(); it != m_PendingLoads.end();)
+            {
+                if (!it->second.Io.IsValid() || it->second.Io.IsComplete())
+                {
+                    finished.push_back(std::move(it->second));
+                    it = m_PendingLoads.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+
+            for (PendingLoad& load : finished)
+            {
+                FinishLoad(load);
+                for (const LoadCallback& callback : load.Callbacks)
+                {
+                    callback(load.Data);
+                }
+            }
+
+            Core::AsyncPackageLoader::Get().Tick(PackageFinalizeBudget);
+        }
+
+        Core::AsyncLoadHandle ResourceManager::LoadPackageAsync(const std::string& path, Core::AsyncPackageLoader::CompletionCallback callback,
+                                                                Core::IoPriority priority)
+        {
+            return Core::AsyncPackageLoader::Get().LoadPackage(path, priority, std::move(callback));
+        }
+
+        void ResourceManager::RequestLoad(const std::string& path, LoadCallback callback, Core::IoPriority priority)
+        {
+            auto found = m_PendingLoads.find(path);
+            if (found != m_PendingLoads.end())
+            {
+                found->second.Callbacks.push_back(std::move(callback));
+                return;
+            }
+
+            PendingLoad& load = m_PendingLoads[path];
+            load.Data = std::make_shared<ResourceData>();
+            load.Data->Path = path;
+            load.Callbacks.push_back(std::move(callback));
+
+            // A failed open leaves Io invalid and is reported on the next Update()
+            load.FileHandle = Core::PlatformFile::Open(path, false);
+            if (load.FileHandle == Core::PlatformFile::InvalidHandle)
+                return;
+
+            int64_t size = Core::PlatformFile::GetSize(load.FileHandle);
+            load.Data->Bytes.resize(static_cast<size_t>(size > 0 ? size : 0));
+            load.Io = Core::AsyncIO::Get().Read(load.FileHandle, load.Data->Bytes.data(), load.Data->Bytes.size(), 0, priority);
+        }
+
+        void ResourceManager::CancelLoad(const std::string& path)
+        {
+            auto found = m_PendingLoads.find(path);
+            if (found != m_PendingLoads.end())
+            {
+                found->second.Io.Cancel();
+            }
+        }
+
+        std::shared_ptr<ResourceData> ResourceManager::LoadData(const std::string& path)
+        {
+            PendingLoad load;
+            load.Data = std::make_shared<ResourceData>();
+            load.Data->Path = path;
+
+            load.FileHandle = Core::PlatformFile::Open(path, false);
+            if (load.FileHandle != Core::PlatformFile::InvalidHandle)
+            {
+                int64_t size = Core::PlatformFile::GetSize(load.FileHandle);
+                load.Data->Bytes.resize(static_cast<size_t>(size > 0 ? size : 0));
+                load.Io = Core::AsyncIO::Get().Read(load.FileHandle, load.Data->Bytes.data(), load.Data->Bytes.size(), 0, Core::IoPriority::Critical);
+            }
+
+            FinishLoad(load);
+            return load.Data;
+        }
+
+        void ResourceManager::FinishLoad(PendingLoad& load)
+        {
+            Core::IoResult result = load.Io.Wait();
+            load.Data->IsValid = load.Io.IsValid() && result.Status == Core::IoStatus::Completed
+                && result.BytesTransferred == static_cast<int64_t>(load.Data->Bytes.size());
+            if (!load.Data->IsValid)
+                load.Data->Bytes.clear();
+
+            Core::PlatformFile::Close(load.FileHandle);
+            load.FileHandle = Core::PlatformFile::InvalidHandle;
+        }
+
+    } // namespace Engine
+
 } // namespace Titan
\ No newline at end of file
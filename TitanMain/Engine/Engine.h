@@ -1,126 +1,227 @@
-#pragma once
-
-// Titan::Engine - Main Engine Systems
-// Core engine functionality: lifecycle, subsystems, time, resources
-
-#include <memory>
-#include <vector>
-#include <unordered_map>
-
-namespace Titan
-{
-    namespace Engine
-    {
-        class Subsystem;
-
-        class Engine
-        {
-        public:
-            static Engine& GetInstance();
-
-            void Initialize();
-            void Shutdown();
-            void Run();
-
-            template<typename T>
-            void AddSubsystem()
-            {
-                static_assert(std::is_base_of<Subsystem, T>::value, "T must inherit from Subsystem");
-                auto subsystem = std::make_unique<T>();
-                m_Subsystems.push_back(std::move(subsystem));
-            }
-
-            template<typename T>
-            T* GetSubsystem()
-            {
-                for (auto& subsystem : m_Subsystems)
-                {
-                    if (auto ptr = dynamic_cast<T*>(subsystem.get()))
-                        return ptr;
-                }
-                return nullptr;
-            }
-
-            float GetDeltaTime() const { return m_DeltaTime; }
-            float GetTotalTime() const { return m_TotalTime; }
-
-            bool IsInitialized() const { return m_IsInitialized; }
-
-        private:
-            Engine() = default;
-            ~Engine() = default;
-            Engine(const Engine&) = delete;
-            Engine& operator=(const Engine&) = delete;
-
-            void Update(float deltaTime);
-            void Render();
-
-            std::vector<std::unique_ptr<Subsystem>> m_Subsystems;
-            bool m_IsInitialized = false;
-            bool m_IsRunning = false;
-
-            float m_DeltaTime = 0.0f;
-            float m_TotalTime = 0.0f;
-            uint64_t m_LastTime = 0;
-        };
-
-        class Subsystem
-        {
-        public:
-            Subsystem() = default;
-            virtual ~Subsystem() = default;
-
-            virtual void Initialize() = 0;
-            virtual void Shutdown() = 0;
-            virtual void Update(float deltaTime) = 0;
-
-            virtual const char* GetName() const = 0;
-        };
-
-        class TimeSubsystem : public Subsystem
-        {
-        public:
-            void Initialize() override;
-            void Shutdown() override;
-            void Update(float deltaTime) override;
-            const char* GetName() const override { return "TimeSubsystem"; }
-
-            float GetDeltaTime() const { return m_DeltaTime; }
-            float GetTotalTime() const { return m_TotalTime; }
-            uint64_t GetFrameCount() const { return m_FrameCount; }
-
-        private:
-            float m_DeltaTime = 0.0f;
-            float m_TotalTime = 0.0f;
-            uint64_t m_FrameCount = 0;
-            uint64_t m_LastTime = 0;
-        };
-
-        class ResourceManager : public Subsystem
-        {
-        public:
-            void Initialize() override;
-            void Shutdown() override;
-            void Update(float deltaTime) override;
-            const char* GetName() const override { return "ResourceManager"; }
-
-            template<typename T>
-            std::shared_ptr<T> LoadResource(const std::string& path)
-            {
-                // TODO: Implement resource loading
-                return nullptr;
-            }
-
-            template<typename T>
-            void UnloadResource(const std::shared_ptr<T>& resource)
-            {
-                // TODO: Implement resource unloading
-            }
-
-        private:
-            std::unordered_map<std::string, std::shared_ptr<void>> m_Resources;
-        };
-
-    } // namespace Engine
-
+#pragma once
+
+// Titan::Engine - Main Engine Systems
+// Core engine functionality: lifecycle, subsystems, time, resources
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <unordered_map>
+#include "../Core/AsyncIO.h"
+#include "../Core/AsyncLoading.h"
+
+namespace Titan
+{
+    namespace Engine
+    {
+        class Subsystem;
+
+        class Engine
+        {
+        public:
+            static Engine& GetInstance();
+
+            void Initialize();
+            void Shutdown();
+            void Run();
+
+            template<typename T>
+            void AddSubsystem()
+            {
+                static_assert(std::is_base_of<Subsystem, T>::value, "T must inherit from Subsystem");
+                auto subsystem = std::make_unique<T>();
+                m_Subsystems.push_back(std::move(subsystem));
+            }
+
+            template<typename T>
+            T* GetSubsystem()
+            {
+                for (auto& subsystem : m_Subsystems)
+                {
+                    if (auto ptr = dynamic_cast<T*>(subsystem.get()))
+                        return ptr;
+                }
+                return nullptr;
+            }
+
+            float GetDeltaTime() const { return m_DeltaTime; }
+            float GetTotalTime() const { return m_TotalTime; }
+
+            bool IsInitialized() const { return m_IsInitialized; }
+
+        private:
+            Engine() = default;
+            ~Engine() = default;
+            Engine(const Engine&) = delete;
+            Engine& operator=(const Engine&) = delete;
+
+            void Update(float deltaTime);
+            void Render();
+
+            std::vector<std::unique_ptr<Subsystem>> m_Subsystems;
+            bool m_IsInitialized = false;
+            bool m_IsRunning = false;
+
+            float m_DeltaTime = 0.0f;
+            float m_TotalTime = 0.0f;
+            uint64_t m_LastTime = 0;
+        };
+
+        class Subsystem
+        {
+        public:
+            Subsystem() = default;
+            virtual ~Subsystem() = default;
+
+            virtual void Initialize() = 0;
+            virtual void Shutdown() = 0;
+            virtual void Update(float deltaTime) = 0;
+
+            virtual const char* GetName() const = 0;
+        };
+
+        class TimeSubsystem : public Subsystem
+        {
+        public:
+            void Initialize() override;
+            void Shutdown() override;
+            void Update(float deltaTime) override;
+            const char* GetName() const override { return "TimeSubsystem"; }
+
+            float GetDeltaTime() const { return m_DeltaTime; }
+            float GetTotalTime() const { return m_TotalTime; }
+            uint64_t GetFrameCount() const { return m_FrameCount; }
+
+        private:
+            float m_DeltaTime = 0.0f;
+            float m_TotalTime = 0.0f;
+            uint64_t m_FrameCount = 0;
+            uint64_t m_LastTime = 0;
+        };
+
+        // Raw file contents read by ResourceManager
+        struct ResourceData
+        {
+            std::string Path;
+            std::vector<uint8_t> Bytes;
+            bool IsValid = false;
+        };
+
+        // Reads resource files through Core::AsyncIO. Any number of loads can be in flight;
+        // completions are delivered on the game thread from Update().
+        class ResourceManager : public Subsystem
+        {
+        public:
+            using LoadCallback = std::function<void(const std::shared_ptr<ResourceData>&)>;
+
+            void Initialize() override;
+            void Shutdown() override;
+            void Update(float deltaTime) override;
+            const char* GetName() const override { return "ResourceManager"; }
+
+            // Starts reading path, callback runs from a later Update(). Requests for a path
+            // that is already loading share the read.
+            void RequestLoad(const std::string& path, LoadCallback callback, Core::IoPriority priority = Core::IoPriority::Normal);
+
+            // Cancels a pending load; its callbacks still run with invalid data
+            void CancelLoad(const std::string& path);
+
+            // Blocking read at Critical priority
+            std::shared_ptr<ResourceData> LoadData(const std::string& path);
+
+            size_t GetPendingLoadCount() const { return m_PendingLoads.size(); }
+
+            // Game thread time per Update() spent finalizing loaded package objects
+            static constexpr double PackageFinalizeBudget = 0.002;
+
+            // Loads a package through Core::AsyncPackageLoader; callback runs from a later Update()
+            Core::AsyncLoadHandle LoadPackageAsync(const std::string& path, Core::AsyncPackageLoader::CompletionCallback callback = {},
+                                                   Core::IoPriority priority = Core::IoPriority::Normal);
+
+            // T is built from the file contents: T(const ResourceData&)
+            template<typename T>
+            std::shared_ptr<T> LoadResource(const std::string& path)
+            {
+                static_assert(std::is_constructible<T, const ResourceData&>::value, "T must be constructible from ResourceData");
+
+                auto found = m_Resources.find(path);
+                if (found != m_Resources.end())
+                    return std::static_pointer_cast<T>(found->second);
+
+                std::shared_ptr<ResourceData> data = LoadData(path);
+                if (!data->IsValid)
+                    return nullptr;
+
+                auto resource = std::make_shared<T>(*data);
+                m_Resources[path] = resource;
+                return resource;
+            }
+
+            template<typename T>
+            void LoadResourceAsync(const std::string& path, std::function<void(std::shared_ptr<T>)> callback,
+                                   Core::IoPriority priority = Core::IoPriority::Normal)
+            {
+                static_assert(std::is_constructible<T, const ResourceData&>::value, "T must be constructible from ResourceData");
+
+                auto found = m_Resources.find(path);
+                if (found != m_Resources.end())
+                {
+                    callback(std::static_pointer_cast<T>(found->second));
+                    return;
+                }
+
+                RequestLoad(path, [this, callback](const std::shared_ptr<ResourceData>& data)
+                {
+                    std::shared_ptr<T> resource;
+                    if (data->IsValid)
+                    {
+                        // An earlier request may have created it already
+                        auto existing = m_Resources.find(data->Path);
+                        if (existing != m_Resources.end())
+                        {
+                            resource = std::static_pointer_cast<T>(existing->second);
+                        }
+                        else
+                        {
+                            resource = std::make_shared<T>(*data);
+                            m_Resources[data->Path] = resource;
+                        }
+                    }
+                    callback(resource);
+                }, priority);
+            }
+
+            template<typename T>
+            void UnloadResource(const std::shared_ptr<T>& resource)
+            {
+                for (auto it = m_Resources.begin(); it != m_Resources.end(); ++it)
+                {
+                    if (it->second.get() == resource.get())
+                    {
+                        m_Resources.erase(it);
+                        return;
+                    }
+                }
+            }
+
+        private:
+            struct PendingLoad
+            {
+                std::shared_ptr<ResourceData> Data;
+                intptr_t FileHandle = -1;
+                Core::IoHandle Io;
+                std::vector<LoadCallback> Callbacks;
+            };
+
+            static void FinishLoad(PendingLoad& load);
+
+            std::unordered_map<std::string, std::shared_ptr<void>> m_Resources;
+            std::unordered_map<std::string, PendingLoad> m_PendingLoads;
+        };
+
+    } // namespace Engine
+
 } // namespace Titan
\ No newline at end of file
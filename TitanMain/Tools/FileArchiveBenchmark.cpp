@@ -0,0 +1,198 @@
+// Titan::Tools::FileArchiveBenchmark - Save and load throughput of FileArchive in MB/s
+// Writes many small values (one operator<< each) followed by one large SerializeArray, then reads
+// everything back, for several buffer sizes, memory-mapped loading and per-call stdio as reference.
+//
+//     g++ -std=c++17 -O2 -pthread -I../Core FileArchiveBenchmark.cpp ../Core/*.cpp -o FileArchiveBenchmark
+//     ./FileArchiveBenchmark [file] [megabytes]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "../Core/Archive.h"
+
+using namespace Titan::Core;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int NumRuns = 3;
+
+    struct Workload
+    {
+        size_t NumSmallValues = 0;          // int32 values serialized one call each
+        std::vector<uint32_t> BulkValues;   // Serialized with one SerializeArray
+
+        double GetMegabytes() const
+        {
+            return (NumSmallValues * sizeof(int32_t) + sizeof(uint64_t) + BulkValues.size() * sizeof(uint32_t)) / 1e6;
+        }
+    };
+
+    struct Result
+    {
+        double SaveSeconds = 1e30;
+        double LoadSeconds = 1e30;
+    };
+
+    double GetSeconds(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    bool SaveArchive(const std::string& filename, const Workload& workload, size_t bufferSize)
+    {
+        FileArchive archive(filename, false, bufferSize);
+        for (size_t i = 0; i < workload.NumSmallValues; ++i)
+        {
+            int32_t value = static_cast<int32_t>(i);
+            archive << value;
+        }
+        std::vector<uint32_t> bulk = workload.BulkValues;
+        archive.SerializeArray(bulk);
+        archive.Flush();
+        return !archive.HasError();
+    }
+
+    bool LoadArchive(FileArchive& archive, const Workload& workload)
+    {
+        int64_t checksum = 0;
+        for (size_t i = 0; i < workload.NumSmallValues; ++i)
+        {
+            int32_t value = 0;
+            archive << value;
+            checksum += value;
+        }
+        std::vector<uint32_t> bulk;
+        archive.SerializeArray(bulk);
+        return !archive.HasError() && bulk.size() == workload.BulkValues.size() && checksum >= 0;
+    }
+
+    bool SaveStdio(const std::string& filename, const Workload& workload)
+    {
+        FILE* file = std::fopen(filename.c_str(), "wb");
+        if (!file)
+            return false;
+
+        bool succeeded = true;
+        for (size_t i = 0; i < workload.NumSmallValues; ++i)
+        {
+            int32_t value = static_cast<int32_t>(i);
+            succeeded &= std::fwrite(&value, sizeof(value), 1, file) == 1;
+        }
+        uint64_t count = workload.BulkValues.size();
+        succeeded &= std::fwrite(&count, sizeof(count), 1, file) == 1;
+        succeeded &= std::fwrite(workload.BulkValues.data(), sizeof(uint32_t), workload.BulkValues.size(), file) == workload.BulkValues.size();
+        return std::fclose(file) == 0 && succeeded;
+    }
+
+    bool LoadStdio(const std::string& filename, const Workload& workload)
+    {
+        FILE* file = std::fopen(filename.c_str(), "rb");
+        if (!file)
+            return false;
+
+        bool succeeded = true;
+        for (size_t i = 0; i < workload.NumSmallValues; ++i)
+        {
+            int32_t value = 0;
+            succeeded &= std::fread(&value, sizeof(value), 1, file) == 1;
+        }
+        uint64_t count = 0;
+        succeeded &= std::fread(&count, sizeof(count), 1, file) == 1 && count == workload.BulkValues.size();
+        std::vector<uint32_t> bulk(succeeded ? static_cast<size_t>(count) : 0);
+        succeeded &= std::fread(bulk.data(), sizeof(uint32_t), bulk.size(), file) == bulk.size();
+        std::fclose(file);
+        return succeeded;
+    }
+
+    void Report(const char* label, const Workload& workload, const Result& result)
+    {
+        double megabytes = workload.GetMegabytes();
+        if (result.SaveSeconds < 1e30)
+            std::printf("%-28s save %7.0f MB/s", label, megabytes / result.SaveSeconds);
+        else
+            std::printf("%-28s save %7s     ", label, "-");
+        std::printf("   load %7.0f MB/s\n", megabytes / result.LoadSeconds);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string filename = argc > 1 ? argv[1] : "FileArchiveBenchmark.bin";
+    size_t megabytes = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 256;
+
+    // A quarter of the data as single values, the rest as one array
+    Workload workload;
+    workload.NumSmallValues = megabytes * 1024 * 1024 / 4 / sizeof(int32_t);
+    workload.BulkValues.resize(megabytes * 1024 * 1024 * 3 / 4 / sizeof(uint32_t));
+    for (size_t i = 0; i < workload.BulkValues.size(); ++i)
+    {
+        workload.BulkValues[i] = static_cast<uint32_t>(i * 2654435761u);
+    }
+    std::printf("%.0f MB per pass, best of %d runs\n", workload.GetMegabytes(), NumRuns);
+
+    const size_t bufferSizes[] = { 64 * 1024, FileArchive::DefaultBufferSize, 4 * 1024 * 1024 };
+    for (size_t bufferSize : bufferSizes)
+    {
+        Result result;
+        for (int run = 0; run < NumRuns; ++run)
+        {
+            Clock::time_point start = Clock::now();
+            if (!SaveArchive(filename, workload, bufferSize))
+            {
+                std::fprintf(stderr, "Saving %s failed\n", filename.c_str());
+                return 1;
+            }
+            result.SaveSeconds = std::min(result.SaveSeconds, GetSeconds(start));
+
+            start = Clock::now();
+            FileArchive archive(filename, true, bufferSize);
+            if (!LoadArchive(archive, workload))
+            {
+                std::fprintf(stderr, "Loading %s failed\n", filename.c_str());
+                return 1;
+            }
+            result.LoadSeconds = std::min(result.LoadSeconds, GetSeconds(start));
+        }
+
+        std::string label = "FileArchive, " + std::to_string(bufferSize / 1024) + " KiB buffer";
+        Report(label.c_str(), workload, result);
+    }
+
+    Result mapped;
+    for (int run = 0; run < NumRuns; ++run)
+    {
+        Clock::time_point start = Clock::now();
+        FileArchive archive(filename, FileArchive::LoadMode::MemoryMapped);
+        if (!LoadArchive(archive, workload))
+        {
+            std::fprintf(stderr, "Loading %s mapped failed\n", filename.c_str());
+            return 1;
+        }
+        mapped.LoadSeconds = std::min(mapped.LoadSeconds, GetSeconds(start));
+    }
+    Report("FileArchive, memory-mapped", workload, mapped);
+
+    Result stdio;
+    for (int run = 0; run < NumRuns; ++run)
+    {
+        Clock::time_point start = Clock::now();
+        if (!SaveStdio(filename, workload))
+            return 1;
+        stdio.SaveSeconds = std::min(stdio.SaveSeconds, GetSeconds(start));
+
+        start = Clock::now();
+        if (!LoadStdio(filename, workload))
+            return 1;
+        stdio.LoadSeconds = std::min(stdio.LoadSeconds, GetSeconds(start));
+    }
+    Report("stdio, one call per value", workload, stdio);
+
+    std::remove(filename.c_str());
+    return 0;
+}
\ No newline at end of file